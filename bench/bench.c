@@ -0,0 +1,42 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+
+#include "bench_checksum.h"
+#include "bench_encoding.h"
+#include "bench_format.h"
+#include "bench_io.h"
+#include "bench_lz.h"
+#include "bench_string.h"
+#include "container/bench_buffer.h"
+#include "container/bench_log.h"
+#include "container/bench_serial.h"
+
+int main (int arg, char** argv) {
+    printf("Benchmarking buffer...\n");
+    bench_buffer();
+    printf("Benchmarking log...\n");
+    bench_log();
+    printf("Benchmarking serial...\n");
+    bench_serial();
+    printf("Benchmarking checksum...\n");
+    bench_checksum();
+    printf("Benchmarking encoding...\n");
+    bench_encoding();
+    printf("Benchmarking format...\n");
+    bench_format();
+    printf("Benchmarking io...\n");
+    bench_io();
+    printf("Benchmarking lz...\n");
+    bench_lz();
+    printf("Benchmarking string...\n");
+    bench_string();
+}
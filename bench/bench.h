@@ -0,0 +1,32 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __BENCH_H
+#define __BENCH_H
+
+#include <stdio.h>
+#include <time.h>
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define BENCH_START(__start) \
+    clock_gettime(CLOCK_MONOTONIC, &__start)
+
+#define BENCH_STOP(__start, __name, __bytes) \
+    { \
+        struct timespec __stop; \
+        clock_gettime(CLOCK_MONOTONIC, &__stop); \
+        double __secs = (__stop.tv_sec - __start.tv_sec) + \
+                        (__stop.tv_nsec - __start.tv_nsec) / 1e9; \
+        printf("  %-40s %10.3f ms %10.1f MB/s\n", __name, __secs * 1e3, \
+               (__bytes) / __secs / (1024 * 1024)); \
+    }
+
+#endif
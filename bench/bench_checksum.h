@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __BENCH_CHECKSUM_H
+#define __BENCH_CHECKSUM_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "codebox/checksum.h"
+#include "bench.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __BENCH_CHECKSUM_COUNT  100
+#define __BENCH_CHECKSUM_LENGTH (1024 * 1024)
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void bench_checksum () {
+    struct timespec start;
+    unsigned char*  data  = malloc(__BENCH_CHECKSUM_LENGTH);
+    uint32_t        table[256];
+    uint32_t        crc   = 0;
+    uint64_t        value = 0;
+
+    if (NULL == data) {
+        return;
+    }
+
+    for (int64_t i = 0; i < __BENCH_CHECKSUM_LENGTH; i++) {
+        data[i] = (unsigned char) (i * 2654435761u >> 13);
+    }
+
+    for (uint32_t i = 0; i < 256; i++) {
+        table[i] = i;
+
+        for (int32_t j = 0; j < 8; j++) {
+            table[i] = table[i] & 1 ? (table[i] >> 1) ^ 0x82F63B78 : table[i] >> 1;
+        }
+    }
+
+    // frames were checksummed with a table a byte at a time
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < __BENCH_CHECKSUM_COUNT; i++) {
+        uint32_t sum = 0xFFFFFFFF;
+
+        for (int64_t j = 0; j < __BENCH_CHECKSUM_LENGTH; j++) {
+            sum = table[(sum ^ data[j]) & 0xFF] ^ (sum >> 8);
+        }
+
+        crc ^= ~sum;
+    }
+
+    BENCH_STOP(start, "crc32c byte table 1MB x 100",
+               (double) __BENCH_CHECKSUM_COUNT * __BENCH_CHECKSUM_LENGTH);
+
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < __BENCH_CHECKSUM_COUNT; i++) {
+        crc ^= crc32c(0, data, __BENCH_CHECKSUM_LENGTH);
+    }
+
+    BENCH_STOP(start, "crc32c 1MB x 100", (double) __BENCH_CHECKSUM_COUNT * __BENCH_CHECKSUM_LENGTH);
+
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < __BENCH_CHECKSUM_COUNT; i++) {
+        value ^= hash64(data, __BENCH_CHECKSUM_LENGTH, 0);
+    }
+
+    BENCH_STOP(start, "hash64 1MB x 100", (double) __BENCH_CHECKSUM_COUNT * __BENCH_CHECKSUM_LENGTH);
+
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < 1000000; i++) {
+        value ^= hash64(data + (i & 0xFFFF), 64, 0);
+    }
+
+    BENCH_STOP(start, "hash64 64B x 1M", 64.0 * 1000000);
+
+    if (0 == crc && 0 == value) {
+        printf("  checksums failed\n");
+    }
+
+    free(data);
+}
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __BENCH_ENCODING_H
+#define __BENCH_ENCODING_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "codebox/container/buffer.h"
+#include "codebox/encoding.h"
+#include "bench.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __BENCH_ENCODING_COUNT  100
+#define __BENCH_ENCODING_LENGTH (1024 * 1024)
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void bench_encoding () {
+    struct timespec start;
+    Buffer          dest;
+    Buffer          source;
+    unsigned char   digits[] = "0123456789abcdef";
+
+    memset(&dest, 0, sizeof(Buffer));
+    memset(&source, 0, sizeof(Buffer));
+
+    if (!buffer_init(&dest, 1, false) || !buffer_init(&source, __BENCH_ENCODING_LENGTH, false)) {
+        return;
+    }
+
+    for (int64_t i = 0; i < __BENCH_ENCODING_LENGTH; i++) {
+        unsigned char byte = (unsigned char) (i * 2654435761u >> 13);
+
+        buffer_append(&source, &byte, 1);
+    }
+
+    // hex dumps were appended a byte at a time
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < __BENCH_ENCODING_COUNT; i++) {
+        buffer_truncate(&dest);
+
+        for (int64_t j = 0; j < source.length; j++) {
+            buffer_append(&dest, &digits[source.data[j] >> 4], 1);
+            buffer_append(&dest, &digits[source.data[j] & 0x0F], 1);
+        }
+    }
+
+    BENCH_STOP(start, "hex byte at a time 1MB x 100",
+               (double) __BENCH_ENCODING_COUNT * __BENCH_ENCODING_LENGTH);
+
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < __BENCH_ENCODING_COUNT; i++) {
+        buffer_truncate(&dest);
+        hex_encode_buffer(&dest, &source);
+    }
+
+    BENCH_STOP(start, "hex_encode 1MB x 100",
+               (double) __BENCH_ENCODING_COUNT * __BENCH_ENCODING_LENGTH);
+
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < __BENCH_ENCODING_COUNT; i++) {
+        buffer_truncate(&source);
+        hex_decode_buffer(&source, &dest);
+    }
+
+    BENCH_STOP(start, "hex_decode 1MB x 100",
+               (double) __BENCH_ENCODING_COUNT * __BENCH_ENCODING_LENGTH);
+
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < __BENCH_ENCODING_COUNT; i++) {
+        buffer_truncate(&dest);
+        base64_encode_buffer(&dest, &source, BASE64_STANDARD);
+    }
+
+    BENCH_STOP(start, "base64_encode 1MB x 100",
+               (double) __BENCH_ENCODING_COUNT * __BENCH_ENCODING_LENGTH);
+
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < __BENCH_ENCODING_COUNT; i++) {
+        buffer_truncate(&source);
+        base64_decode_buffer(&source, &dest, BASE64_STANDARD);
+    }
+
+    BENCH_STOP(start, "base64_decode 1MB x 100",
+               (double) __BENCH_ENCODING_COUNT * __BENCH_ENCODING_LENGTH);
+
+    if (__BENCH_ENCODING_LENGTH != source.length) {
+        printf("  base64_decode failed\n");
+    }
+
+    buffer_cleanup(&dest);
+    buffer_cleanup(&source);
+}
+
+#endif
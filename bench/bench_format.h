@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __BENCH_FORMAT_H
+#define __BENCH_FORMAT_H
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "codebox/container/buffer.h"
+#include "bench.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __BENCH_FORMAT_COUNT 1000000
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void bench_format () {
+    struct timespec start;
+    Buffer          buffer;
+    char            line[128];
+
+    memset(&buffer, 0, sizeof(Buffer));
+
+    if (!buffer_init(&buffer, 1, false)) {
+        return;
+    }
+
+    // a metrics line of a name, a counter, a timestamp and a measurement
+    BENCH_START(start);
+
+    for (int64_t i = 0; i < __BENCH_FORMAT_COUNT; i++) {
+        snprintf(line, sizeof(line), "requests %" PRId64 " %" PRIu64 " %.17g\n", i * 7919,
+                 (uint64_t) 1400000000000 + i, i / 1024.0);
+        buffer_append_str(&buffer, line);
+    }
+
+    BENCH_STOP(start, "snprintf + buffer_append_str x 1M", (double) buffer.length);
+
+    buffer_truncate(&buffer);
+
+    BENCH_START(start);
+
+    for (int64_t i = 0; i < __BENCH_FORMAT_COUNT; i++) {
+        buffer_append_fmt(&buffer, "requests %" PRId64 " %" PRIu64 " %.17g\n", i * 7919,
+                          (uint64_t) 1400000000000 + i, i / 1024.0);
+    }
+
+    BENCH_STOP(start, "buffer_append_fmt x 1M", (double) buffer.length);
+
+    buffer_truncate(&buffer);
+
+    BENCH_START(start);
+
+    for (int64_t i = 0; i < __BENCH_FORMAT_COUNT; i++) {
+        buffer_append(&buffer, (unsigned char*) "requests ", 9);
+        buffer_append_i64(&buffer, i * 7919);
+        buffer_append(&buffer, (unsigned char*) " ", 1);
+        buffer_append_u64(&buffer, 1400000000000 + i);
+        buffer_append(&buffer, (unsigned char*) " ", 1);
+        buffer_append_f64(&buffer, i / 1024.0);
+        buffer_append(&buffer, (unsigned char*) "\n", 1);
+    }
+
+    BENCH_STOP(start, "buffer_append_i64/u64/f64 x 1M", (double) buffer.length);
+
+    buffer_truncate(&buffer);
+
+    BENCH_START(start);
+
+    for (int64_t i = 0; i < __BENCH_FORMAT_COUNT; i++) {
+        buffer_append_f64(&buffer, (i * 2654435761u % 1000003) / 7.0);
+    }
+
+    BENCH_STOP(start, "buffer_append_f64 x 1M", (double) buffer.length);
+
+    buffer_truncate(&buffer);
+
+    BENCH_START(start);
+
+    for (int64_t i = 0; i < __BENCH_FORMAT_COUNT; i++) {
+        snprintf(line, sizeof(line), "%.17g", (i * 2654435761u % 1000003) / 7.0);
+        buffer_append_str(&buffer, line);
+    }
+
+    BENCH_STOP(start, "snprintf %.17g + buffer_append_str x 1M", (double) buffer.length);
+
+    buffer_cleanup(&buffer);
+}
+
+#endif
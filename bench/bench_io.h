@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __BENCH_IO_H
+#define __BENCH_IO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "codebox/container/buffer.h"
+#include "codebox/io.h"
+#include "bench.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __BENCH_IO_LENGTH (32 * 1024 * 1024)
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void bench_io () {
+    Buffer          buffer;
+    unsigned char   chunk[IO_READER_READ];
+    ssize_t         count;
+    int64_t         expected = 0;
+    int             fd;
+    int64_t         index;
+    int64_t         length;
+    char            path[]   = "/tmp/bench_io_XXXXXX";
+    IoReader        reader;
+    unsigned char*  record;
+    struct timespec start;
+    int64_t         total    = 0;
+    char            text[32];
+    uint32_t        seed     = 1;
+
+    memset(&buffer, 0, sizeof(Buffer));
+
+    if (-1 == (fd = mkstemp(path))) {
+        return;
+    } else if (!buffer_init(&buffer, __BENCH_IO_LENGTH, false)) {
+        close(fd);
+        unlink(path);
+
+        return;
+    }
+
+    // log lines of repeated words and varying numbers
+    while (buffer.length < __BENCH_IO_LENGTH) {
+        seed = seed * 1103515245 + 12345;
+
+        snprintf(text, sizeof(text), "%u ", seed >> 20);
+        buffer_append_str(&buffer, "GET /index.html status=200 bytes=");
+        buffer_append_str(&buffer, text);
+        buffer_append_str(&buffer, seed & 0x10000 ? "hit\n" : "miss\n");
+    }
+
+    if (buffer.length != write(fd, buffer.data, buffer.length)) {
+        close(fd);
+        unlink(path);
+        buffer_cleanup(&buffer);
+
+        return;
+    }
+
+    for (int64_t i = 0; i < buffer.length; i++) {
+        expected += '\n' != buffer.data[i];
+    }
+
+    // each line found in a buffer that the rest of the data is moved down in once it is removed
+    lseek(fd, 0, SEEK_SET);
+    buffer_truncate(&buffer);
+
+    BENCH_START(start);
+
+    while (0 < (count = read(fd, chunk, sizeof(chunk)))) {
+        buffer_append(&buffer, chunk, count);
+
+        while (-1 != (index = buffer_indexof(&buffer, 0, (unsigned char*) "\n", 1))) {
+            total += index;
+
+            buffer_remove(&buffer, 0, index + 1);
+        }
+    }
+
+    BENCH_STOP(start, "buffer_remove lines 32MB", (double) __BENCH_IO_LENGTH);
+
+    if (total != expected) {
+        printf("  buffer_remove failed\n");
+    }
+
+    // each line a view into the buffer of a reader
+    lseek(fd, 0, SEEK_SET);
+
+    total = 0;
+
+    if (io_reader_init(&reader, fd, IO_RECORD_DELIMITED, (unsigned char*) "\n", 1, 1024)) {
+        BENCH_START(start);
+
+        while (io_reader_next(&reader, &record, &length)) {
+            total += length;
+        }
+
+        BENCH_STOP(start, "io_reader_next lines 32MB", (double) __BENCH_IO_LENGTH);
+
+        if (total != expected || reader.error) {
+            printf("  io_reader_next failed\n");
+        }
+
+        io_reader_cleanup(&reader);
+    }
+
+    close(fd);
+    unlink(path);
+    buffer_cleanup(&buffer);
+}
+
+#endif
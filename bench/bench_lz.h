@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __BENCH_LZ_H
+#define __BENCH_LZ_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "codebox/container/buffer.h"
+#include "codebox/lz.h"
+#include "bench.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __BENCH_LZ_COUNT  100
+#define __BENCH_LZ_LENGTH (1024 * 1024)
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void bench_lz () {
+    Buffer          compressed;
+    Buffer          dest;
+    Buffer          source;
+    struct timespec start;
+    char            text[32];
+    uint32_t        seed = 1;
+
+    memset(&compressed, 0, sizeof(Buffer));
+    memset(&dest, 0, sizeof(Buffer));
+    memset(&source, 0, sizeof(Buffer));
+
+    if (!buffer_init(&compressed, 1, false) || !buffer_init(&dest, 1, false) ||
+        !buffer_init(&source, __BENCH_LZ_LENGTH, false)) {
+        return;
+    }
+
+    // log lines of repeated words and varying numbers
+    while (source.length < __BENCH_LZ_LENGTH) {
+        seed = seed * 1103515245 + 12345;
+
+        snprintf(text, sizeof(text), "%u ", seed >> 20);
+        buffer_append_str(&source, "GET /index.html status=200 bytes=");
+        buffer_append_str(&source, text);
+        buffer_append_str(&source, seed & 0x10000 ? "hit\n" : "miss\n");
+    }
+
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < __BENCH_LZ_COUNT; i++) {
+        buffer_truncate(&compressed);
+        lz_frame_compress_buffer(&compressed, &source, LZ_FRAME_CONTENT_CHECKSUM);
+    }
+
+    BENCH_STOP(start, "lz_frame_compress 1MB x 100",
+               (double) __BENCH_LZ_COUNT * source.length);
+
+    printf("  ratio %.3f\n", (double) compressed.length / source.length);
+
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < __BENCH_LZ_COUNT; i++) {
+        buffer_truncate(&dest);
+        lz_frame_decompress_buffer(&dest, &compressed);
+    }
+
+    BENCH_STOP(start, "lz_frame_decompress 1MB x 100",
+               (double) __BENCH_LZ_COUNT * source.length);
+
+    if (dest.length != source.length || 0 != memcmp(dest.data, source.data, dest.length)) {
+        printf("  lz_frame_decompress failed\n");
+    }
+
+    buffer_cleanup(&compressed);
+    buffer_cleanup(&dest);
+    buffer_cleanup(&source);
+}
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __BENCH_STRING_H
+#define __BENCH_STRING_H
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "codebox/string.h"
+#include "bench.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __BENCH_STRING_LENGTH (1 << 20)
+#define __BENCH_STRING_ROUNDS 100
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+static void bench_string_search (char* name, unsigned char* data, unsigned char* sequence,
+                                 int32_t length) {
+    struct timespec start;
+    char            label[64];
+    volatile long   found = 0;
+
+    snprintf(label, sizeof(label), "chr_indexof %s", name);
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < __BENCH_STRING_ROUNDS; i++) {
+        found += chr_indexof(data, __BENCH_STRING_LENGTH, 0, sequence, length);
+    }
+
+    BENCH_STOP(start, label, (double) __BENCH_STRING_ROUNDS * __BENCH_STRING_LENGTH);
+
+    snprintf(label, sizeof(label), "memmem %s", name);
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < __BENCH_STRING_ROUNDS; i++) {
+        found += (unsigned char*) memmem(data, __BENCH_STRING_LENGTH, sequence, length) - data;
+    }
+
+    BENCH_STOP(start, label, (double) __BENCH_STRING_ROUNDS * __BENCH_STRING_LENGTH);
+}
+
+static void bench_string_pattern () {
+    struct timespec start;
+    SearchPattern   pattern;
+    volatile long   found   = 0;
+    unsigned char*  headers = (unsigned char*) "GET /index.html HTTP/1.1\r\nHost: example.com\r\n"
+                                               "User-Agent: bench\r\nAccept: */*\r\n\r\n";
+    int32_t         length  = strlen((char*) headers);
+
+    // short searches repeated many times, where setup dominates
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < 1000000; i++) {
+        found += chr_indexof(headers, length, 0, (unsigned char*) "--boundary", 10);
+    }
+
+    BENCH_STOP(start, "chr_indexof headers x 1M", 1e6 * length);
+
+    search_pattern_init_str(&pattern, "--boundary");
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < 1000000; i++) {
+        found += chr_indexof_pattern(headers, length, 0, &pattern);
+    }
+
+    BENCH_STOP(start, "chr_indexof_pattern headers x 1M", 1e6 * length);
+
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < 1000000; i++) {
+        search_pattern_init_str(&pattern, "--boundary");
+    }
+
+    BENCH_STOP(start, "search_pattern_init x 1M", 1e6 * 10);
+}
+
+void bench_string () {
+    unsigned char* data = malloc(__BENCH_STRING_LENGTH);
+    unsigned char  sequence[64];
+
+    assert(NULL != data);
+
+    // text-like data with the sequence only at the very end
+    srand(1);
+
+    for (int32_t i = 0; i < __BENCH_STRING_LENGTH; i++) {
+        data[i] = "etaoinshrdlu ,."[rand() % 15];
+    }
+
+    memcpy(data + __BENCH_STRING_LENGTH - 4, "\r\n\r\n", 4);
+    bench_string_search("\"\\r\\n\\r\\n\"", data, (unsigned char*) "\r\n\r\n", 4);
+
+    memcpy(sequence, data + __BENCH_STRING_LENGTH - 64, 64);
+    sequence[0] = 'x';
+    memcpy(data + __BENCH_STRING_LENGTH - 64, sequence, 64);
+    bench_string_search("16B sequence", data, sequence + 48, 16);
+    bench_string_search("64B sequence", data, sequence, 64);
+
+    // a periodic sequence in periodic data, the worst case for naive and filtered searches
+    memset(data, 'a', __BENCH_STRING_LENGTH);
+    memset(sequence, 'a', 64);
+
+    data[__BENCH_STRING_LENGTH - 1] = 'b';
+    sequence[63]                    = 'b';
+
+    bench_string_search("\"a...ab\" 16B in \"a...ab\"", data, sequence + 48, 16);
+    bench_string_search("\"a...ab\" 64B in \"a...ab\"", data, sequence, 64);
+
+    free(data);
+
+    bench_string_pattern();
+}
+
+#endif
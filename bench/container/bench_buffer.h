@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __BENCH_BUFFER_H
+#define __BENCH_BUFFER_H
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "codebox/container/buffer.h"
+#include "../bench.h"
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+static void bench_buffer_appends (char* name, float growth, int32_t count) {
+    struct timespec start;
+    Buffer          buffer;
+
+    memset(&buffer, 0, sizeof(Buffer));
+
+    if (!buffer_init(&buffer, 1, false)) {
+        return;
+    }
+
+    buffer_set_growth(&buffer, growth);
+
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < count; i++) {
+        buffer_append(&buffer, (unsigned char*) "0123456789abcdef", 16);
+    }
+
+    BENCH_STOP(start, name, (double) count * 16);
+
+    buffer_cleanup(&buffer);
+}
+
+static void bench_buffer_alloc (char* grow_name, char* read_name, int32_t alloc) {
+    unsigned char   chunk[65536];
+    struct timespec start;
+    Buffer          buffer;
+    uint64_t        sum     = 0;
+    int64_t         length  = (int64_t) 256 * 1024 * 1024;
+    int32_t         count   = 16 * 1024 * 1024;
+
+    memset(&buffer, 0, sizeof(Buffer));
+    memset(chunk, 1, sizeof(chunk));
+
+    if (!buffer_init(&buffer, 1, false) || !buffer_set_alloc(&buffer, alloc)) {
+        return;
+    }
+
+    BENCH_START(start);
+
+    while (buffer.length < length) {
+        buffer_append(&buffer, chunk, sizeof(chunk));
+    }
+
+    BENCH_STOP(start, grow_name, (double) length);
+
+    // reads scattered over the whole buffer miss the TLB on every access with small pages
+    BENCH_START(start);
+
+    for (int64_t i = 0; i < count; i++) {
+        sum += buffer.data[(i * 2654435761u) % length];
+    }
+
+    BENCH_STOP(start, read_name, (double) count);
+
+    if (count != sum) {
+        printf("  %s failed\n", read_name);
+    }
+
+    buffer_cleanup(&buffer);
+}
+
+void bench_buffer () {
+    // a growth factor of 1.0 reproduces the previous exact-fit resizing
+    bench_buffer_appends("append 16B x 1M (exact growth)", 1.0, 1000000);
+    bench_buffer_appends("append 16B x 1M (1.5x growth)", 1.5, 1000000);
+    bench_buffer_appends("append 16B x 1M (2x growth)", 2.0, 1000000);
+
+    bench_buffer_alloc("append 64KB to 256MB", "random reads 16M over 256MB", 0);
+    bench_buffer_alloc("append 64KB to 256MB (huge)", "random reads 16M over 256MB (huge)",
+                       BUFFER_ALLOC_HUGE);
+}
+
+#endif
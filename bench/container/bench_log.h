@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __BENCH_LOG_H
+#define __BENCH_LOG_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+
+#include "codebox/container/buffer.h"
+#include "codebox/container/log.h"
+#include "../bench.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __BENCH_LOG_RECORD  "2014-01-01 00:00:00 INFO request served in 12ms status=200\n"
+#define __BENCH_LOG_THREADS 4
+#define __BENCH_LOG_WRITES  250000
+
+// -------------------------------------------------------------------------------------------------
+// STATIC VARIABLES
+// -------------------------------------------------------------------------------------------------
+
+static AppendLog __bench_log;
+
+static Buffer __bench_log_buffer;
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+static void* __bench_log_append (void* arg) {
+    for (int32_t i = 0; i < __BENCH_LOG_WRITES; i++) {
+        buffer_append_ts(&__bench_log_buffer, (unsigned char*) __BENCH_LOG_RECORD,
+                         sizeof(__BENCH_LOG_RECORD) - 1);
+    }
+
+    return NULL;
+}
+
+static void* __bench_log_write (void* arg) {
+    for (int32_t i = 0; i < __BENCH_LOG_WRITES; i++) {
+        append_log_write(&__bench_log, (unsigned char*) __BENCH_LOG_RECORD,
+                         sizeof(__BENCH_LOG_RECORD) - 1);
+    }
+
+    return NULL;
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void bench_log () {
+    Buffer          dest;
+    int64_t         expected = (int64_t) __BENCH_LOG_THREADS * __BENCH_LOG_WRITES *
+                               (sizeof(__BENCH_LOG_RECORD) - 1);
+    struct timespec start;
+    pthread_t       threads[__BENCH_LOG_THREADS];
+
+    memset(&dest, 0, sizeof(Buffer));
+    memset(&__bench_log, 0, sizeof(AppendLog));
+    memset(&__bench_log_buffer, 0, sizeof(Buffer));
+
+    if (!buffer_init(&__bench_log_buffer, 1, true) || !buffer_init(&dest, 1, false) ||
+        !append_log_init(&__bench_log, 1024 * 1024)) {
+        return;
+    }
+
+    // producers serialized on the mutex of one buffer
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < __BENCH_LOG_THREADS; i++) {
+        pthread_create(&threads[i], NULL, __bench_log_append, NULL);
+    }
+
+    for (int32_t i = 0; i < __BENCH_LOG_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    BENCH_STOP(start, "buffer_append_ts 4 threads x 250K", (double) expected);
+
+    // producers reserving records of a log that the consumer drains into a buffer
+    BENCH_START(start);
+
+    for (int32_t i = 0; i < __BENCH_LOG_THREADS; i++) {
+        pthread_create(&threads[i], NULL, __bench_log_write, NULL);
+    }
+
+    while (dest.length < expected) {
+        if (!append_log_drain(&__bench_log, &dest)) {
+            break;
+        }
+
+        sched_yield();
+    }
+
+    for (int32_t i = 0; i < __BENCH_LOG_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    BENCH_STOP(start, "append_log_write 4 threads x 250K", (double) expected);
+
+    if (dest.length != __bench_log_buffer.length) {
+        printf("  append_log_drain failed\n");
+    }
+
+    append_log_cleanup(&__bench_log);
+    buffer_cleanup(&__bench_log_buffer);
+    buffer_cleanup(&dest);
+}
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __BENCH_SERIAL_H
+#define __BENCH_SERIAL_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "codebox/container/buffer.h"
+#include "codebox/container/serial.h"
+#include "../bench.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __BENCH_SERIAL_COUNT 1000000
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void bench_serial () {
+    struct timespec start;
+    Buffer          buffer;
+    BufferReader    reader;
+    BufferWriter    writer;
+    uint64_t        sum    = 0;
+    int64_t         length = 0;
+
+    memset(&buffer, 0, sizeof(Buffer));
+
+    if (!buffer_init(&buffer, 1, false)) {
+        return;
+    }
+
+    // a message of a type byte, a 32-bit id, a 64-bit timestamp, two varints and a 16 byte key,
+    // appended the way messages were encoded before the writer existed
+    BENCH_START(start);
+
+    for (int64_t i = 0; i < __BENCH_SERIAL_COUNT; i++) {
+        uint8_t  type      = 1;
+        uint32_t id        = (uint32_t) i;
+        uint64_t timestamp = 1400000000000 + i;
+        uint8_t  varint[2] = { 0x96, 0x01 };
+        uint8_t  size      = 16;
+
+        buffer_append(&buffer, &type, 1);
+        buffer_append(&buffer, (unsigned char*) &id, 4);
+        buffer_append(&buffer, (unsigned char*) &timestamp, 8);
+        buffer_append(&buffer, varint, 2);
+        buffer_append(&buffer, varint, 1);
+        buffer_append(&buffer, &size, 1);
+        buffer_append(&buffer, (unsigned char*) "0123456789abcdef", 16);
+    }
+
+    BENCH_STOP(start, "buffer_append message x 1M", (double) buffer.length);
+
+    length = buffer.length;
+
+    buffer_truncate(&buffer);
+    buffer_writer_init(&writer, &buffer);
+
+    BENCH_START(start);
+
+    for (int64_t i = 0; i < __BENCH_SERIAL_COUNT; i++) {
+        buffer_writer_reserve(&writer, 64);
+        buffer_writer_u8(&writer, 1);
+        buffer_writer_u32le(&writer, (uint32_t) i);
+        buffer_writer_u64le(&writer, 1400000000000 + i);
+        buffer_writer_varint(&writer, 150);
+        buffer_writer_svarint(&writer, -1);
+        buffer_writer_blob(&writer, (unsigned char*) "0123456789abcdef", 16);
+    }
+
+    BENCH_STOP(start, "buffer_writer message x 1M", (double) buffer.length);
+
+    buffer_reader_init(&reader, &buffer);
+
+    BENCH_START(start);
+
+    for (int64_t i = 0; i < __BENCH_SERIAL_COUNT; i++) {
+        sum += buffer_reader_u8(&reader);
+        sum += buffer_reader_u32le(&reader);
+        sum += buffer_reader_u64le(&reader);
+        sum += buffer_reader_varint(&reader);
+        sum += buffer_reader_svarint(&reader);
+        sum += (uintptr_t) buffer_reader_blob(&reader, &length);
+    }
+
+    BENCH_STOP(start, "buffer_reader message x 1M", (double) buffer.length);
+
+    if (reader.error || 0 == sum) {
+        printf("  buffer_reader failed\n");
+    }
+
+    buffer_cleanup(&buffer);
+}
+
+#endif
@@ -9,12 +9,24 @@
 
 #include <stdio.h>
 
+#include "codebox/checksum.h"
 #include "codebox/container/buffer.h"
+#include "codebox/container/chain.h"
+#include "codebox/container/cuckoo.h"
 #include "codebox/container/list.h"
+#include "codebox/container/log.h"
+#include "codebox/container/pool.h"
+#include "codebox/container/ring.h"
+#include "codebox/container/rope.h"
+#include "codebox/container/serial.h"
 #include "codebox/container/stack.h"
 #include "codebox/container/table.h"
+#include "codebox/cpu.h"
+#include "codebox/encoding.h"
+#include "codebox/format.h"
 #include "codebox/gl.h"
 #include "codebox/io.h"
+#include "codebox/lz.h"
 #include "codebox/util.h"
 
 // -------------------------------------------------------------------------------------------------
@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __CODEBOX_CHECKSUM_H
+#define __CODEBOX_CHECKSUM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "codebox/container/buffer.h"
+
+// -------------------------------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------------------------------
+
+typedef struct {
+    /** The accumulators of the stripes of 32 bytes hashed so far. */
+    uint64_t accumulators[4];
+
+    /** The bytes of an incomplete stripe. */
+    unsigned char pending[32];
+
+    /** The count of bytes of an incomplete stripe. */
+    int32_t pending_length;
+
+    /** The seed. */
+    uint64_t seed;
+
+    /** The count of bytes hashed. */
+    uint64_t total_length;
+} Hash64;
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Update a CRC32C (Castagnoli) checksum with data, starting from 0, so that data appended in parts
+ * can be checksummed as it arrives.
+ *
+ * Processors with SSE4.2 checksum three blocks at once with the crc32 instruction and combine them
+ * by table, and others use tables eight bytes at a time.
+ *
+ * @param crc    The checksum of the data before.
+ * @param data   The data.
+ * @param length The length of the data.
+ */
+uint32_t crc32c (uint32_t crc, unsigned char* data, int64_t length);
+
+/**
+ * Update a CRC32C checksum with the data of a buffer, without closing its gap.
+ *
+ * @param crc    The checksum of the data before.
+ * @param buffer The buffer.
+ */
+uint32_t crc32c_buffer (uint32_t crc, Buffer* buffer);
+
+/**
+ * Hash data with the non-cryptographic 64-bit hash, which produces the same values as XXH64.
+ *
+ * @param data   The data.
+ * @param length The length of the data.
+ * @param seed   The seed.
+ */
+uint64_t hash64 (unsigned char* data, int64_t length, uint64_t seed);
+
+/**
+ * Hash the data of a buffer, without closing its gap.
+ *
+ * @param buffer The buffer.
+ * @param seed   The seed.
+ */
+uint64_t hash64_buffer (Buffer* buffer, uint64_t seed);
+
+/**
+ * Retrieve the hash of the data a hash has been updated with, which may be updated further.
+ *
+ * @param hash The hash.
+ */
+uint64_t hash64_digest (Hash64* hash);
+
+/**
+ * Initialize a hash that is updated with data in parts.
+ *
+ * @param hash The hash.
+ * @param seed The seed.
+ */
+void hash64_init (Hash64* hash, uint64_t seed);
+
+/**
+ * Update a hash with data.
+ *
+ * @param hash   The hash.
+ * @param data   The data.
+ * @param length The length of the data.
+ */
+void hash64_update (Hash64* hash, unsigned char* data, int64_t length);
+
+/**
+ * Update a hash with the data of a buffer, without closing its gap.
+ *
+ * @param hash   The hash.
+ * @param buffer The buffer.
+ */
+void hash64_update_buffer (Hash64* hash, Buffer* buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -14,14 +14,62 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "codebox/string.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __BUFFER_DEFAULT_GROWTH 1.5
+
+// buffers up to this size hold their data inline rather than on the heap
+#define __BUFFER_INLINE_SIZE 64
+
+// flags of buffer_set_alloc()
+#define BUFFER_ALLOC_ALIGN64 1
+#define BUFFER_ALLOC_PAGE    2
+#define BUFFER_ALLOC_HUGE    4
+
+// flags of buffer_map_init()
+#define BUFFER_MAP_POPULATE   1
+#define BUFFER_MAP_SEQUENTIAL 2
+
 // -------------------------------------------------------------------------------------------------
 // TYPEDEFS
 // -------------------------------------------------------------------------------------------------
 
+typedef enum {
+    /** The file is mapped read-only, and the first write copies the data onto the heap. */
+    BUFFER_MAP_READ,
+
+    /** Writes modify private copies of the mapped pages, and growth copies them onto the heap. */
+    BUFFER_MAP_PRIVATE,
+
+    /** Writes modify the file, which grows with the buffer and is truncated to its length. */
+    BUFFER_MAP_SHARED
+} BufferMapMode;
+
+typedef struct {
+    /** The data, which is freed or unmapped once the storage is no longer referenced. */
+    unsigned char* data;
+
+    /** The file descriptor of a shared file mapping, or -1. */
+    int fd;
+
+    /** The size of a file mapping, or 0 when the data was allocated. */
+    int64_t mapped;
+
+    /** The reference count. */
+    int32_t refs;
+
+    /** Indicates that the data may be written in place while a single buffer refers to it. */
+    bool writable;
+} BufferStorage;
+
 typedef struct {
     /** The data. */
     unsigned char* data;
@@ -29,11 +77,32 @@ typedef struct {
     /** The mutex. */
     pthread_mutex_t* mutex;
 
+    /** The flags of buffer_set_alloc() the data is allocated with. */
+    int32_t alloc;
+
+    /** The position of the gap in a gapped buffer, or -1 when the data is contiguous. */
+    int64_t gap;
+
+    /** Indicates that inserts and removes move a gap rather than the data following them. */
+    bool gapped;
+
+    /** The factor the size grows by when an append or insert outgrows the buffer. */
+    float growth;
+
     /** The length of the data. */
-    int32_t length;
+    int64_t length;
 
     /** The size of buffer. */
-    int32_t size;
+    int64_t size;
+
+    /** The storage shared with slices or a file mapping, or NULL when the buffer owns its data. */
+    BufferStorage* storage;
+
+    /** The mutex of a thread-safe buffer. */
+    pthread_mutex_t inline_mutex;
+
+    /** The data of a small buffer. */
+    unsigned char inline_data[__BUFFER_INLINE_SIZE];
 } Buffer;
 
 // -------------------------------------------------------------------------------------------------
@@ -47,7 +116,7 @@ typedef struct {
  * @param data   The data.
  * @param length The length of the data.
  */
-bool buffer_append (Buffer* buffer, unsigned char* data, int32_t length);
+bool buffer_append (Buffer* buffer, unsigned char* data, int64_t length);
 
 /**
  * Append data onto the end of a buffer using thread safety.
@@ -56,7 +125,60 @@ bool buffer_append (Buffer* buffer, unsigned char* data, int32_t length);
  * @param data   The data.
  * @param length The length of the data.
  */
-bool buffer_append_ts (Buffer* buffer, unsigned char* data, int32_t length);
+bool buffer_append_ts (Buffer* buffer, unsigned char* data, int64_t length);
+
+/**
+ * Append a double onto the end of a buffer, formatted by format_f64().
+ *
+ * @param buffer The buffer.
+ * @param value  The value.
+ */
+bool buffer_append_f64 (Buffer* buffer, double value);
+
+/**
+ * Append a double onto the end of a buffer, formatted by format_f64(), using thread safety.
+ *
+ * @param buffer The buffer.
+ * @param value  The value.
+ */
+bool buffer_append_f64_ts (Buffer* buffer, double value);
+
+/**
+ * Append printf() formatted data onto the end of a buffer.
+ *
+ * The data is formatted directly into the free space of the buffer, and formatted a second time
+ * only when the buffer must grow to fit it.
+ *
+ * @param buffer The buffer.
+ * @param format The format.
+ */
+bool buffer_append_fmt (Buffer* buffer, char* format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/**
+ * Append printf() formatted data onto the end of a buffer using thread safety.
+ *
+ * @param buffer The buffer.
+ * @param format The format.
+ */
+bool buffer_append_fmt_ts (Buffer* buffer, char* format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/**
+ * Append a signed integer onto the end of a buffer.
+ *
+ * @param buffer The buffer.
+ * @param value  The value.
+ */
+bool buffer_append_i64 (Buffer* buffer, int64_t value);
+
+/**
+ * Append a signed integer onto the end of a buffer using thread safety.
+ *
+ * @param buffer The buffer.
+ * @param value  The value.
+ */
+bool buffer_append_i64_ts (Buffer* buffer, int64_t value);
 
 /**
  * Append a string onto the end of a buffer.
@@ -74,6 +196,22 @@ bool buffer_append_str (Buffer* buffer, char* data);
  */
 bool buffer_append_str_ts (Buffer* buffer, char* data);
 
+/**
+ * Append an unsigned integer onto the end of a buffer.
+ *
+ * @param buffer The buffer.
+ * @param value  The value.
+ */
+bool buffer_append_u64 (Buffer* buffer, uint64_t value);
+
+/**
+ * Append an unsigned integer onto the end of a buffer using thread safety.
+ *
+ * @param buffer The buffer.
+ * @param value  The value.
+ */
+bool buffer_append_u64_ts (Buffer* buffer, uint64_t value);
+
 /**
  * Cleanup a buffer.
  *
@@ -88,7 +226,7 @@ bool buffer_cleanup (Buffer* buffer);
  * @param start  The starting position.
  * @param length The length.
  */
-Buffer* buffer_copy (Buffer* buffer, int32_t start, int32_t length);
+Buffer* buffer_copy (Buffer* buffer, int64_t start, int64_t length);
 
 /**
  * Copy a slice of a buffer using thread safety.
@@ -97,11 +235,14 @@ Buffer* buffer_copy (Buffer* buffer, int32_t start, int32_t length);
  * @param start  The starting position.
  * @param length The length.
  */
-Buffer* buffer_copy_ts (Buffer* buffer, int32_t start, int32_t length);
+Buffer* buffer_copy_ts (Buffer* buffer, int64_t start, int64_t length);
 
 /**
  * Retrieve the data in a buffer.
  *
+ * The data of a gapped buffer is made contiguous first, so the data field must not be read
+ * directly while a gapped buffer has a gap.
+ *
  * @param buffer The buffer.
  */
 void* buffer_data (Buffer* buffer);
@@ -121,7 +262,7 @@ void* buffer_data_ts (Buffer* buffer);
  * @param sequence The character sequence.
  * @param length   The length of the character sequence.
  */
-int32_t buffer_indexof (Buffer* buffer, int32_t start, unsigned char* sequence, int32_t length);
+int64_t buffer_indexof (Buffer* buffer, int64_t start, unsigned char* sequence, int64_t length);
 
 /**
  * Find the starting index of data in a buffer using thread safety.
@@ -131,16 +272,40 @@ int32_t buffer_indexof (Buffer* buffer, int32_t start, unsigned char* sequence,
  * @param sequence The character sequence.
  * @param length   The length of the character sequence.
  */
-int32_t buffer_indexof_ts (Buffer* buffer, int32_t start, unsigned char* sequence, int32_t length);
+int64_t buffer_indexof_ts (Buffer* buffer, int64_t start, unsigned char* sequence, int64_t length);
+
+/**
+ * Find the position of a precompiled search pattern.
+ *
+ * @param buffer  The buffer.
+ * @param start   The start index.
+ * @param pattern The search pattern.
+ */
+int64_t buffer_indexof_pattern (Buffer* buffer, int64_t start, SearchPattern* pattern);
+
+/**
+ * Find the position of a precompiled search pattern using thread safety.
+ *
+ * @param buffer  The buffer.
+ * @param start   The start index.
+ * @param pattern The search pattern.
+ */
+int64_t buffer_indexof_pattern_ts (Buffer* buffer, int64_t start, SearchPattern* pattern);
 
 /**
  * Initialize a buffer.
  *
+ * Appends and inserts that outgrow the buffer grow its size geometrically, by a factor of 1.5
+ * unless changed with buffer_set_growth, so that repeated appends run in amortized constant time.
+ *
+ * A buffer of up to 64 bytes holds its data inline and only allocates once it grows beyond that,
+ * so an initialized buffer must not be copied by value.
+ *
  * @param buffer      The buffer.
  * @param size        The initial size.
  * @param thread_safe Indicates that a mutex will be initialized.
  */
-bool buffer_init (Buffer* buffer, int32_t size, bool thread_safe);
+bool buffer_init (Buffer* buffer, int64_t size, bool thread_safe);
 
 /**
  * Insert data into a buffer.
@@ -150,7 +315,7 @@ bool buffer_init (Buffer* buffer, int32_t size, bool thread_safe);
  * @param data   The data.
  * @param length The length of the data.
  */
-bool buffer_insert (Buffer* buffer, int32_t index, unsigned char* data, int32_t length);
+bool buffer_insert (Buffer* buffer, int64_t index, unsigned char* data, int64_t length);
 
 /**
  * Insert data into a buffer using thread safety.
@@ -160,21 +325,21 @@ bool buffer_insert (Buffer* buffer, int32_t index, unsigned char* data, int32_t
  * @param data   The data.
  * @param length The length of the data.
  */
-bool buffer_insert_ts (Buffer* buffer, int32_t index, unsigned char* data, int32_t length);
+bool buffer_insert_ts (Buffer* buffer, int64_t index, unsigned char* data, int64_t length);
 
 /**
  * Retrieve the length of data in a buffer.
  *
  * @param buffer The buffer.
  */
-int32_t buffer_length (Buffer* buffer);
+int64_t buffer_length (Buffer* buffer);
 
 /**
  * Retrieve the length of data in a buffer using thread safety.
  *
  * @param buffer The buffer.
  */
-int32_t buffer_length_ts (Buffer* buffer);
+int64_t buffer_length_ts (Buffer* buffer);
 
 /**
  * Lock a buffer if it was initialized as thread-safe.
@@ -183,6 +348,33 @@ int32_t buffer_length_ts (Buffer* buffer);
  */
 void buffer_lock (Buffer* buffer);
 
+/**
+ * Create a new buffer that maps a file.
+ *
+ * @param path        The path.
+ * @param mode        The mode.
+ * @param flags       The flags.
+ * @param thread_safe Indicates that a mutex will be initialized.
+ */
+Buffer* buffer_map (char* path, BufferMapMode mode, int32_t flags, bool thread_safe);
+
+/**
+ * Initialize a buffer that maps a file, so its data is read without copying it onto the heap.
+ *
+ * A read-only or private mapping is copied onto the heap by the first write it cannot hold in
+ * place. A shared mapping grows the file as the buffer grows and truncates it to the length of
+ * the buffer on cleanup, and cannot be sliced. The flags BUFFER_MAP_POPULATE and
+ * BUFFER_MAP_SEQUENTIAL prefault the mapping and advise the kernel to read ahead of a scan.
+ *
+ * @param buffer      The buffer, which must not be initialized.
+ * @param path        The path, which is created for a shared mapping if it does not exist.
+ * @param mode        The mode.
+ * @param flags       The flags.
+ * @param thread_safe Indicates that a mutex will be initialized.
+ */
+bool buffer_map_init (Buffer* buffer, char* path, BufferMapMode mode, int32_t flags,
+                      bool thread_safe);
+
 /**
  * Create a new buffer.
  */
@@ -195,7 +387,7 @@ Buffer* buffer_new ();
  * @param start  The starting position.
  * @param length The length.
  */
-bool buffer_remove (Buffer* buffer, int32_t start, int32_t length);
+bool buffer_remove (Buffer* buffer, int64_t start, int64_t length);
 
 /**
  * Remove a slice of a buffer using thread safety.
@@ -204,7 +396,23 @@ bool buffer_remove (Buffer* buffer, int32_t start, int32_t length);
  * @param start  The starting position.
  * @param length The length.
  */
-bool buffer_remove_ts (Buffer* buffer, int32_t start, int32_t length);
+bool buffer_remove_ts (Buffer* buffer, int64_t start, int64_t length);
+
+/**
+ * Reserve space in a buffer so that it can hold at least the given size without resizing.
+ *
+ * @param buffer The buffer.
+ * @param size   The size.
+ */
+bool buffer_reserve (Buffer* buffer, int64_t size);
+
+/**
+ * Reserve space in a buffer using thread safety.
+ *
+ * @param buffer The buffer.
+ * @param size   The size.
+ */
+bool buffer_reserve_ts (Buffer* buffer, int64_t size);
 
 /**
  * Resize a buffer.
@@ -212,7 +420,7 @@ bool buffer_remove_ts (Buffer* buffer, int32_t start, int32_t length);
  * @param buffer The buffer.
  * @param size   The expected size.
  */
-bool buffer_resize (Buffer* buffer, int32_t size);
+bool buffer_resize (Buffer* buffer, int64_t size);
 
 /**
  * Resize a buffer using thread safety.
@@ -220,21 +428,107 @@ bool buffer_resize (Buffer* buffer, int32_t size);
  * @param buffer The buffer.
  * @param size   The expected size.
  */
-bool buffer_resize_ts (Buffer* buffer, int32_t size);
+bool buffer_resize_ts (Buffer* buffer, int64_t size);
+
+/**
+ * Set how the data of a buffer is allocated, moving its data into an allocation of that kind.
+ *
+ * BUFFER_ALLOC_ALIGN64 aligns the data to 64 bytes so that vector kernels load whole cache lines.
+ * BUFFER_ALLOC_PAGE maps the data anonymously at a page boundary, and BUFFER_ALLOC_HUGE also
+ * aligns data of 2MB or more to 2MB and advises the kernel to back it with transparent huge pages,
+ * which leaves it on small pages where they are unavailable. Mapped data, which any buffer of over
+ * 32MB uses, grows and shrinks with mremap() rather than by copying it.
+ *
+ * Set this on a small buffer before reserving its full size. A buffer that maps a file or shares
+ * its data with slices cannot change.
+ *
+ * @param buffer The buffer.
+ * @param alloc  The flags.
+ */
+bool buffer_set_alloc (Buffer* buffer, int32_t alloc);
+
+/**
+ * Set whether or not a buffer is gapped.
+ *
+ * A gapped buffer keeps its free space as a gap at the position of the last insert or remove, so
+ * runs of nearby edits only move the bytes between consecutive edit points. The data is made
+ * contiguous again when it is read.
+ *
+ * @param buffer The buffer.
+ * @param gapped Indicates that the buffer is gapped.
+ */
+void buffer_set_gapped (Buffer* buffer, bool gapped);
+
+/**
+ * Set the growth factor of a buffer.
+ *
+ * A factor of 1.0 grows the buffer only as much as each append or insert requires.
+ *
+ * @param buffer The buffer.
+ * @param growth The growth factor.
+ */
+void buffer_set_growth (Buffer* buffer, float growth);
+
+/**
+ * Shrink the size of a buffer to fit its data.
+ *
+ * @param buffer The buffer.
+ */
+bool buffer_shrink_to_fit (Buffer* buffer);
+
+/**
+ * Shrink the size of a buffer to fit its data using thread safety.
+ *
+ * @param buffer The buffer.
+ */
+bool buffer_shrink_to_fit_ts (Buffer* buffer);
 
 /**
  * Retrieve the size of a buffer.
  *
  * @param buffer The buffer.
  */
-int32_t buffer_size (Buffer* buffer);
+int64_t buffer_size (Buffer* buffer);
 
 /**
  * Retrieve the size of a buffer using thread safety.
  *
  * @param buffer The buffer.
  */
-int32_t buffer_size_ts (Buffer* buffer);
+int64_t buffer_size_ts (Buffer* buffer);
+
+/**
+ * Create a slice of a buffer.
+ *
+ * The slice is a buffer that refers to the data of the buffer rather than a copy of it, so this
+ * runs in O(1). The first write to either buffer that would modify the shared data, or grow into
+ * it, copies the data the writing buffer refers to. The slice is never thread-safe, and a shared
+ * file mapping cannot be sliced.
+ *
+ * @param buffer The buffer.
+ * @param start  The starting position.
+ * @param length The length.
+ */
+Buffer* buffer_slice (Buffer* buffer, int64_t start, int64_t length);
+
+/**
+ * Create a slice of a buffer using thread safety.
+ *
+ * @param buffer The buffer.
+ * @param start  The starting position.
+ * @param length The length.
+ */
+Buffer* buffer_slice_ts (Buffer* buffer, int64_t start, int64_t length);
+
+/**
+ * Initialize a slice of a buffer in place, which allocates nothing once the buffer is shared.
+ *
+ * @param slice  The slice, which must not be initialized.
+ * @param buffer The buffer.
+ * @param start  The starting position.
+ * @param length The length.
+ */
+bool buffer_slice_init (Buffer* slice, Buffer* buffer, int64_t start, int64_t length);
 
 /**
  * Truncate a buffer.
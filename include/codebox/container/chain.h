@@ -0,0 +1,289 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __CODEBOX_CHAIN_H
+#define __CODEBOX_CHAIN_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include "codebox/container/buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __CHAIN_CHUNK_SIZE 4096
+
+// -------------------------------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------------------------------
+
+typedef struct {
+    /** The function that releases referenced data, or NULL when the data is not released. */
+    void (*free_func) (unsigned char* data, void* context);
+
+    /** The context passed to the free function. */
+    void* context;
+
+    /** The data, which is either the storage of the chunk or referenced data. */
+    unsigned char* data;
+
+    /** The size of the data. */
+    int64_t size;
+
+    /** The reference count. */
+    int32_t refs;
+
+    /** The storage of a chunk that owns its data. */
+    unsigned char storage[];
+} ChainChunk;
+
+typedef struct __chain_segment {
+    /** The chunk. */
+    ChainChunk* chunk;
+
+    /** The next segment. */
+    struct __chain_segment* next;
+
+    /** The length of the segment. */
+    int64_t length;
+
+    /** The offset of the segment into the chunk. */
+    int64_t offset;
+} ChainSegment;
+
+typedef struct {
+    /** The first segment. */
+    ChainSegment* head;
+
+    /** The mutex. */
+    pthread_mutex_t* mutex;
+
+    /** The empty segments that have been reserved or kept for reuse. */
+    ChainSegment* spare;
+
+    /** The last segment. */
+    ChainSegment* tail;
+
+    /** The count of segments. */
+    int32_t count;
+
+    /** The length of the data. */
+    int64_t length;
+} Chain;
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Append a copy of data onto the end of a chain.
+ *
+ * @param chain  The chain.
+ * @param data   The data.
+ * @param length The length of the data.
+ */
+bool chain_append (Chain* chain, unsigned char* data, int64_t length);
+
+/**
+ * Append a copy of data onto the end of a chain using thread safety.
+ *
+ * @param chain  The chain.
+ * @param data   The data.
+ * @param length The length of the data.
+ */
+bool chain_append_ts (Chain* chain, unsigned char* data, int64_t length);
+
+/**
+ * Move the data of a chain onto the end of another chain, without copying it.
+ *
+ * @param chain The chain.
+ * @param other The chain to move, which is left empty.
+ */
+bool chain_append_chain (Chain* chain, Chain* other);
+
+/**
+ * Append data onto the end of a chain by reference, without copying it.
+ *
+ * @param chain     The chain.
+ * @param data      The data, which must not be modified until it is released.
+ * @param length    The length of the data.
+ * @param free_func The function called once the data is no longer referenced, or NULL.
+ * @param context   The context passed to the free function.
+ */
+bool chain_append_ref (Chain* chain, unsigned char* data, int64_t length,
+                       void (*free_func) (unsigned char* data, void* context), void* context);
+
+/**
+ * Append data onto the end of a chain by reference using thread safety.
+ *
+ * @param chain     The chain.
+ * @param data      The data, which must not be modified until it is released.
+ * @param length    The length of the data.
+ * @param free_func The function called once the data is no longer referenced, or NULL.
+ * @param context   The context passed to the free function.
+ */
+bool chain_append_ref_ts (Chain* chain, unsigned char* data, int64_t length,
+                          void (*free_func) (unsigned char* data, void* context), void* context);
+
+/**
+ * Cleanup a chain.
+ *
+ * @param chain The chain.
+ */
+bool chain_cleanup (Chain* chain);
+
+/**
+ * Append data that has been written into space returned by chain_reserve().
+ *
+ * @param chain  The chain.
+ * @param length The length of the data, which must not exceed the reserved length.
+ */
+void chain_commit (Chain* chain, int64_t length);
+
+/**
+ * Copy data from the start of a chain without draining it.
+ *
+ * @param chain  The chain.
+ * @param data   The data.
+ * @param length The maximum length to copy.
+ */
+int64_t chain_copyout (Chain* chain, unsigned char* data, int64_t length);
+
+/**
+ * Remove data from the start of a chain.
+ *
+ * @param chain  The chain.
+ * @param length The length.
+ */
+bool chain_drain (Chain* chain, int64_t length);
+
+/**
+ * Remove data from the start of a chain using thread safety.
+ *
+ * @param chain  The chain.
+ * @param length The length.
+ */
+bool chain_drain_ts (Chain* chain, int64_t length);
+
+/**
+ * Initialize a chain.
+ *
+ * @param chain       The chain.
+ * @param thread_safe Indicates that a mutex will be initialized.
+ */
+bool chain_init (Chain* chain, bool thread_safe);
+
+/**
+ * Fill an array of iovecs with the data of a chain, in order, for use with writev().
+ *
+ * Note: The chain must be locked until the iovecs are no longer used in multithreaded
+ *       environments.
+ *
+ * @param chain The chain.
+ * @param iov   The iovecs.
+ * @param count The count of iovecs.
+ */
+int32_t chain_iovec (Chain* chain, struct iovec* iov, int32_t count);
+
+/**
+ * Retrieve the length of a chain.
+ *
+ * @param chain The chain.
+ */
+int64_t chain_length (Chain* chain);
+
+/**
+ * Retrieve the length of a chain using thread safety.
+ *
+ * @param chain The chain.
+ */
+int64_t chain_length_ts (Chain* chain);
+
+/**
+ * Lock a chain if it was initialized as thread-safe.
+ *
+ * @param chain The chain.
+ */
+void chain_lock (Chain* chain);
+
+/**
+ * Create a new chain.
+ */
+Chain* chain_new ();
+
+/**
+ * Prepend a copy of data onto the start of a chain.
+ *
+ * @param chain  The chain.
+ * @param data   The data.
+ * @param length The length of the data.
+ */
+bool chain_prepend (Chain* chain, unsigned char* data, int64_t length);
+
+/**
+ * Prepend data onto the start of a chain by reference, without copying it.
+ *
+ * @param chain     The chain.
+ * @param data      The data, which must not be modified until it is released.
+ * @param length    The length of the data.
+ * @param free_func The function called once the data is no longer referenced, or NULL.
+ * @param context   The context passed to the free function.
+ */
+bool chain_prepend_ref (Chain* chain, unsigned char* data, int64_t length,
+                        void (*free_func) (unsigned char* data, void* context), void* context);
+
+/**
+ * Reserve free space at the end of a chain and fill an array of iovecs with it, for use with
+ * readv(). The data read must then be appended with chain_commit().
+ *
+ * Note: The chain must be locked until the data is committed in multithreaded environments.
+ *
+ * @param chain  The chain.
+ * @param length The length to reserve.
+ * @param iov    The iovecs.
+ * @param count  The count of iovecs.
+ */
+int32_t chain_reserve (Chain* chain, int64_t length, struct iovec* iov, int32_t count);
+
+/**
+ * Move data from the start of a chain onto the end of another chain, without copying it.
+ *
+ * @param chain  The chain.
+ * @param length The length.
+ * @param other  The other chain.
+ */
+bool chain_split (Chain* chain, int64_t length, Chain* other);
+
+/**
+ * Append the data in a chain onto the end of a buffer. On failure nothing is appended.
+ *
+ * @param chain  The chain.
+ * @param buffer The buffer.
+ */
+bool chain_to_buffer (Chain* chain, Buffer* buffer);
+
+/**
+ * Unlock a chain if it was initialized as thread-safe.
+ *
+ * @param chain The chain.
+ */
+void chain_unlock (Chain* chain);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
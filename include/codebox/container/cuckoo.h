@@ -0,0 +1,306 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __CODEBOX_CUCKOO_H
+#define __CODEBOX_CUCKOO_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "codebox/container/table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __CUCKOO_BUCKET_SLOTS          6
+#define __CUCKOO_CACHE_LINE            64
+#define __CUCKOO_DEFAULT_BUCKET_COUNT  16
+#define __CUCKOO_DEFAULT_COMP_FUNC     __TABLE_DEFAULT_COMP_FUNC
+#define __CUCKOO_DEFAULT_HASH_FUNC     __TABLE_DEFAULT_HASH_FUNC
+
+// -------------------------------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------------------------------
+
+typedef struct __cuckoo_entry {
+    /** The next entry removed in the same epoch, while the entry waits to be freed. */
+    struct __cuckoo_entry* next;
+
+    /** The value. */
+    void* value;
+
+    /** The hashcode. */
+    uint32_t hashcode;
+
+    /** The key length. */
+    int32_t length;
+
+    /** The copy of the key, which is not modified while the entry can be read. */
+    unsigned char key[];
+} CuckooEntry;
+
+typedef struct {
+    /** The version, which is odd while a writer modifies the bucket. */
+    uint64_t version;
+
+    /** The slot tags, one byte per slot. A zero tag marks an empty slot. */
+    uint64_t tags;
+
+    /** The entries. */
+    CuckooEntry* entries[__CUCKOO_BUCKET_SLOTS];
+} CuckooBucket;
+
+typedef struct __cuckoo_array {
+    /** The array replaced by the last resize, which is freed on cleanup. */
+    struct __cuckoo_array* retired;
+
+    /** The buckets, each of which fills a cache line. */
+    CuckooBucket* buckets;
+
+    /** The bucket mask. */
+    uint64_t mask;
+} CuckooArray;
+
+typedef struct {
+    /** The key comparision function. */
+    bool (*comp_func) (unsigned char* key1, int32_t length1,
+                       unsigned char* key2, int32_t length2);
+
+    /** The hash function. */
+    uint32_t (*hash_func) (unsigned char* key, int32_t length);
+
+    /** The bucket array. */
+    CuckooArray* array;
+
+    /** The mutex. */
+    pthread_mutex_t* mutex;
+
+    /** The key count. */
+    int64_t key_count;
+
+    /** The state of the random generator used to pick eviction slots. */
+    uint64_t seed;
+
+    /** The epoch, which advances once no optimistic reader remains in the one before it. */
+    uint64_t epoch;
+
+    /** The count of optimistic readers in the current and the previous epoch, by parity. */
+    int64_t readers[2];
+
+    /** The entries removed in the current and the previous epoch, by parity. */
+    CuckooEntry* removed[2];
+} Cuckoo;
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Retrieve the bucket count of a cuckoo table.
+ *
+ * @param cuckoo The cuckoo table.
+ */
+int64_t cuckoo_bucket_count (Cuckoo* cuckoo);
+
+/**
+ * Cleanup a cuckoo table.
+ *
+ * @param cuckoo The cuckoo table.
+ */
+bool cuckoo_cleanup (Cuckoo* cuckoo);
+
+/**
+ * Retrieve a value from a cuckoo table.
+ *
+ * @param cuckoo The cuckoo table.
+ * @param key    The key.
+ * @param length The key length.
+ */
+void* cuckoo_get (Cuckoo* cuckoo, unsigned char* key, int32_t length);
+
+/**
+ * Retrieve a value from a cuckoo table using thread safety.
+ *
+ * This does not lock the table. The read is validated against the versions of both candidate
+ * buckets and retried if a writer modified either of them meanwhile.
+ *
+ * Keys are only ever compared against the copies the table keeps, and a removed copy is freed once
+ * every reader that could have seen it has finished, so the caller may free a key as soon as the
+ * put or remove of it returns. A value is returned as it was stored, so the caller must not free a
+ * value while readers may still be returning it.
+ *
+ * @param cuckoo The cuckoo table.
+ * @param key    The key.
+ * @param length The key length.
+ */
+void* cuckoo_get_ts (Cuckoo* cuckoo, unsigned char* key, int32_t length);
+
+/**
+ * Indicates whether or not a cuckoo table contains a key.
+ *
+ * @param cuckoo The cuckoo table.
+ * @param key    The key.
+ * @param length The key length.
+ */
+bool cuckoo_has_key (Cuckoo* cuckoo, unsigned char* key, int32_t length);
+
+/**
+ * Indicates whether or not a cuckoo table contains a key using thread safety.
+ *
+ * This does not lock the table, and follows the contract of cuckoo_get_ts().
+ *
+ * @param cuckoo The cuckoo table.
+ * @param key    The key.
+ * @param length The key length.
+ */
+bool cuckoo_has_key_ts (Cuckoo* cuckoo, unsigned char* key, int32_t length);
+
+/**
+ * Initialize a cuckoo table.
+ *
+ * @param cuckoo       The cuckoo table.
+ * @param bucket_count The initial bucket count, which is rounded up to a power of two of at
+ *                     least two.
+ * @param comp_func    The comparison function.
+ * @param hash_func    The hash function.
+ * @param thread_safe  Indicates that a mutex will be initialized and bucket versions maintained.
+ */
+bool cuckoo_init (Cuckoo* cuckoo, int64_t bucket_count,
+                  bool (*comp_func) (unsigned char* key1, int32_t length1,
+                                     unsigned char* key2, int32_t length2),
+                  uint32_t (*hash_func) (unsigned char* key, int32_t length),
+                  bool thread_safe);
+
+/**
+ * Initialize a cuckoo table with default settings.
+ *
+ * Defaults:
+ *   * bucket_count = 16
+ *   * comp_func    = binary
+ *   * hash_func    = djb2
+ *   * thread_safe  = false
+ *
+ * @param cuckoo The cuckoo table.
+ */
+bool cuckoo_init_defaults (Cuckoo* cuckoo);
+
+/**
+ * Initialize a thread-safe cuckoo table with default settings.
+ *
+ * Defaults:
+ *   * bucket_count = 16
+ *   * comp_func    = binary
+ *   * hash_func    = djb2
+ *   * thread_safe  = true
+ *
+ * @param cuckoo The cuckoo table.
+ */
+bool cuckoo_init_defaults_ts (Cuckoo* cuckoo);
+
+/**
+ * Retrieve the count of keys in a cuckoo table.
+ *
+ * @param cuckoo The cuckoo table.
+ */
+int64_t cuckoo_key_count (Cuckoo* cuckoo);
+
+/**
+ * Retrieve the count of keys in a cuckoo table using thread safety.
+ *
+ * @param cuckoo The cuckoo table.
+ */
+int64_t cuckoo_key_count_ts (Cuckoo* cuckoo);
+
+/**
+ * Lock a cuckoo table if it was initialized as thread-safe.
+ *
+ * Only writers need to hold the lock.
+ *
+ * @param cuckoo The cuckoo table.
+ */
+void cuckoo_lock (Cuckoo* cuckoo);
+
+/**
+ * Create a new cuckoo table.
+ */
+Cuckoo* cuckoo_new ();
+
+/**
+ * Put an item into a cuckoo table, replacing the value of an existing key.
+ *
+ * The table keeps its own copy of the key.
+ *
+ * @param cuckoo The cuckoo table.
+ * @param key    The key.
+ * @param length The key length.
+ * @param value  The value.
+ */
+bool cuckoo_put (Cuckoo* cuckoo, unsigned char* key, int32_t length, void* value);
+
+/**
+ * Put an item into a cuckoo table using thread safety.
+ *
+ * @param cuckoo The cuckoo table.
+ * @param key    The key.
+ * @param length The key length.
+ * @param value  The value.
+ */
+bool cuckoo_put_ts (Cuckoo* cuckoo, unsigned char* key, int32_t length, void* value);
+
+/**
+ * Remove an item from a cuckoo table.
+ *
+ * @param cuckoo The cuckoo table.
+ * @param key    The key.
+ * @param length The key length.
+ */
+void* cuckoo_remove (Cuckoo* cuckoo, unsigned char* key, int32_t length);
+
+/**
+ * Remove an item from a cuckoo table using thread safety.
+ *
+ * @param cuckoo The cuckoo table.
+ * @param key    The key.
+ * @param length The key length.
+ */
+void* cuckoo_remove_ts (Cuckoo* cuckoo, unsigned char* key, int32_t length);
+
+/**
+ * Resize a cuckoo table.
+ *
+ * @param cuckoo       The cuckoo table.
+ * @param bucket_count The bucket count, which is rounded up to a power of two.
+ */
+bool cuckoo_resize (Cuckoo* cuckoo, int64_t bucket_count);
+
+/**
+ * Resize a cuckoo table using thread safety.
+ *
+ * @param cuckoo       The cuckoo table.
+ * @param bucket_count The bucket count, which is rounded up to a power of two.
+ */
+bool cuckoo_resize_ts (Cuckoo* cuckoo, int64_t bucket_count);
+
+/**
+ * Unlock a cuckoo table if it was initialized as thread-safe.
+ *
+ * @param cuckoo The cuckoo table.
+ */
+void cuckoo_unlock (Cuckoo* cuckoo);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __CODEBOX_LOG_H
+#define __CODEBOX_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "codebox/container/buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __APPEND_LOG_CACHE_LINE 64
+
+// the bytes of the header that precedes each record
+#define APPEND_LOG_HEADER 8
+
+// -------------------------------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------------------------------
+
+typedef struct {
+    /** The data. */
+    unsigned char* data;
+
+    /** The position mask. */
+    uint64_t mask;
+
+    /** The size of the log, which is a power of two. */
+    uint64_t size;
+
+    /** Padding that keeps the consumer position on its own cache line. */
+    unsigned char pad1[__APPEND_LOG_CACHE_LINE];
+
+    /** The stream position up to which records have been consumed. */
+    uint64_t head;
+
+    /** Padding that keeps the producer position on its own cache line. */
+    unsigned char pad2[__APPEND_LOG_CACHE_LINE];
+
+    /** The stream position up to which space has been reserved. */
+    uint64_t reserved;
+
+    /** Padding that keeps the producer position off the following cache line. */
+    unsigned char pad3[__APPEND_LOG_CACHE_LINE];
+} AppendLog;
+
+typedef struct {
+    /** The data of the record, in up to two parts when the record wraps. */
+    unsigned char* data[2];
+
+    /** The lengths of the parts. */
+    int64_t length[2];
+
+    /** The stream position of the header of the record. */
+    uint64_t position;
+} AppendLogRegion;
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Cleanup a log.
+ *
+ * @param log The log.
+ */
+bool append_log_cleanup (AppendLog* log);
+
+/**
+ * Commit a reserved record, publishing it to the consumer.
+ *
+ * Unlike a multi-producer ring, a commit never waits for records reserved before it. The consumer
+ * stops at the first record that is not yet committed, so records are still read in the order
+ * they were reserved.
+ *
+ * @param log    The log.
+ * @param region The region of the record.
+ */
+void append_log_commit (AppendLog* log, AppendLogRegion* region);
+
+/**
+ * Consume a record that has been read, returning its space to the producers.
+ *
+ * This must only be called by the consumer.
+ *
+ * @param log    The log.
+ * @param region The region of the record.
+ */
+void append_log_consume (AppendLog* log, AppendLogRegion* region);
+
+/**
+ * Append the data of every committed record onto the end of a buffer, in order, and consume them.
+ *
+ * This must only be called by the consumer.
+ *
+ * @param log  The log.
+ * @param dest The destination buffer.
+ */
+bool append_log_drain (AppendLog* log, Buffer* dest);
+
+/**
+ * Initialize a log.
+ *
+ * A log does not use a mutex. Any number of producers reserve records by adding to a shared
+ * position, write them and commit them independently, and a single consumer reads them in order.
+ * Each record takes an 8-byte header and is padded to a multiple of 8 bytes.
+ *
+ * @param log  The log.
+ * @param size The minimum size, which is rounded up to a power of two.
+ */
+bool append_log_init (AppendLog* log, int64_t size);
+
+/**
+ * Create a new log.
+ */
+AppendLog* append_log_new ();
+
+/**
+ * Retrieve the region of the next committed record, without consuming it.
+ *
+ * This must only be called by the consumer.
+ *
+ * @param log    The log.
+ * @param region The region.
+ */
+bool append_log_read (AppendLog* log, AppendLogRegion* region);
+
+/**
+ * Reserve a record to write into, which must be committed once written.
+ *
+ * This waits while the log is full for the consumer to make room, and fails when the record could
+ * never fit.
+ *
+ * @param log    The log.
+ * @param length The length of the record.
+ * @param region The region.
+ */
+bool append_log_reserve (AppendLog* log, int64_t length, AppendLogRegion* region);
+
+/**
+ * Retrieve the size of a log.
+ *
+ * @param log The log.
+ */
+int64_t append_log_size (AppendLog* log);
+
+/**
+ * Write a record into a log.
+ *
+ * @param log    The log.
+ * @param data   The data.
+ * @param length The length of the data.
+ */
+bool append_log_write (AppendLog* log, unsigned char* data, int64_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __CODEBOX_POOL_H
+#define __CODEBOX_POOL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "codebox/container/buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+// size classes are powers of two from the minimum size up to 1MB
+#define __BUFFER_POOL_CLASS_COUNT 13
+#define __BUFFER_POOL_MIN_SIZE    256
+
+// the count of buffers of each class a thread keeps before returning half of them to the pool
+#define __BUFFER_POOL_CACHE_COUNT 8
+
+#define __BUFFER_POOL_DEFAULT_RETAINED (16 * 1024 * 1024)
+
+// -------------------------------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------------------------------
+
+typedef struct __buffer_pool_cache {
+    /** The count of buffers in each class. */
+    int32_t counts[__BUFFER_POOL_CLASS_COUNT];
+
+    /** The first buffer in each class. */
+    Buffer* heads[__BUFFER_POOL_CLASS_COUNT];
+
+    /** The next cache of the pool. */
+    struct __buffer_pool_cache* next;
+
+    /** The pool. */
+    struct __buffer_pool* pool;
+} BufferPoolCache;
+
+typedef struct {
+    /** The count of buffers acquired. */
+    int64_t acquired;
+
+    /** The count of buffers acquired that had to be allocated. */
+    int64_t allocated;
+
+    /** The count of buffers released that were freed rather than retained. */
+    int64_t discarded;
+
+    /** The count of buffers released. */
+    int64_t released;
+
+    /** The bytes of buffer data retained by the pool and its thread caches. */
+    int64_t retained;
+} BufferPoolStats;
+
+typedef struct __buffer_pool {
+    /** The thread caches. */
+    BufferPoolCache* caches;
+
+    /** The count of buffers in each class shared between threads. */
+    int32_t counts[__BUFFER_POOL_CLASS_COUNT];
+
+    /** The first buffer in each class shared between threads. */
+    Buffer* heads[__BUFFER_POOL_CLASS_COUNT];
+
+    /** The key of the thread caches. */
+    pthread_key_t key;
+
+    /** The maximum bytes of buffer data to retain. */
+    int64_t max_retained;
+
+    /** The mutex. */
+    pthread_mutex_t* mutex;
+
+    /** The statistics. */
+    BufferPoolStats stats;
+} BufferPool;
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Acquire an empty buffer with at least a size from a pool.
+ *
+ * The buffer is taken from the cache of the calling thread, then from the buffers shared between
+ * threads, and is only allocated when neither has one of its size class.
+ *
+ * @param pool The pool.
+ * @param size The minimum size.
+ */
+Buffer* buffer_pool_acquire (BufferPool* pool, int64_t size);
+
+/**
+ * Cleanup a pool, freeing every buffer it retains.
+ *
+ * Note: Threads must not use the pool once this is called.
+ *
+ * @param pool The pool.
+ */
+bool buffer_pool_cleanup (BufferPool* pool);
+
+/**
+ * Retrieve the pool shared by the library, which retains up to 16MB.
+ */
+BufferPool* buffer_pool_default ();
+
+/**
+ * Initialize a pool.
+ *
+ * @param pool         The pool.
+ * @param max_retained The maximum bytes of buffer data to retain.
+ */
+bool buffer_pool_init (BufferPool* pool, int64_t max_retained);
+
+/**
+ * Create a new pool.
+ */
+BufferPool* buffer_pool_new ();
+
+/**
+ * Release a buffer created by buffer_new() to a pool, which keeps its capacity for reuse.
+ *
+ * Buffers that are thread-safe, share their data with slices, have an allocation mode set with
+ * buffer_set_alloc(), are outside the size classes or would exceed the retained memory of the pool
+ * are freed instead.
+ *
+ * @param pool   The pool.
+ * @param buffer The buffer.
+ */
+void buffer_pool_release (BufferPool* pool, Buffer* buffer);
+
+/**
+ * Retrieve the statistics of a pool.
+ *
+ * @param pool  The pool.
+ * @param stats The statistics.
+ */
+void buffer_pool_stats (BufferPool* pool, BufferPoolStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
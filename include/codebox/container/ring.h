@@ -0,0 +1,187 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __CODEBOX_RING_H
+#define __CODEBOX_RING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __RING_CACHE_LINE 64
+
+// -------------------------------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------------------------------
+
+typedef enum _ring_type {
+    RING_MPSC,
+    RING_SPSC
+} RingType;
+
+typedef struct {
+    /** The data. */
+    unsigned char* data;
+
+    /** The position mask. */
+    uint64_t mask;
+
+    /** The size of the ring, which is a power of two. */
+    uint64_t size;
+
+    /** Indicates that the data is mapped twice in a row, so regions never wrap. */
+    bool mapped;
+
+    /** The ring type. */
+    RingType type;
+
+    /** Padding that keeps the consumer position on its own cache line. */
+    unsigned char pad1[__RING_CACHE_LINE];
+
+    /** The stream position up to which data has been consumed. */
+    uint64_t head;
+
+    /** Padding that keeps the producer positions on their own cache line. */
+    unsigned char pad2[__RING_CACHE_LINE];
+
+    /** The stream position up to which data has been committed. */
+    uint64_t tail;
+
+    /** The stream position up to which space has been reserved. */
+    uint64_t reserved;
+
+    /** Padding that keeps the producer positions off the following cache line. */
+    unsigned char pad3[__RING_CACHE_LINE];
+} Ring;
+
+typedef struct {
+    /** The data of the region, in up to two parts when the region wraps. */
+    unsigned char* data[2];
+
+    /** The lengths of the parts. */
+    int64_t length[2];
+
+    /** The stream position of the region. */
+    uint64_t position;
+} RingRegion;
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Cleanup a ring.
+ *
+ * @param ring The ring.
+ */
+bool ring_cleanup (Ring* ring);
+
+/**
+ * Commit a reserved region, making it visible to the consumer.
+ *
+ * In a multi-producer ring regions become visible in the order they were reserved, so a commit
+ * waits for the commits of regions reserved before it.
+ *
+ * @param ring   The ring.
+ * @param region The region.
+ */
+void ring_commit (Ring* ring, RingRegion* region);
+
+/**
+ * Consume data that has been peeked.
+ *
+ * This must only be called by the consumer.
+ *
+ * @param ring   The ring.
+ * @param length The length.
+ */
+void ring_consume (Ring* ring, int64_t length);
+
+/**
+ * Initialize a ring.
+ *
+ * A ring does not use a mutex. A single-producer ring must only be written by one thread at a
+ * time, while a multi-producer ring may be written by any number of threads, and both must only
+ * be read by one thread at a time.
+ *
+ * @param ring   The ring.
+ * @param size   The minimum size, which is rounded up to a power of two.
+ * @param type   The type.
+ * @param mapped Indicates that the data will be mapped twice in a row using a memory file, so
+ *               that regions never wrap. The size is then rounded up to at least a page.
+ */
+bool ring_init (Ring* ring, int64_t size, RingType type, bool mapped);
+
+/**
+ * Retrieve the length of committed data that has not been consumed.
+ *
+ * @param ring The ring.
+ */
+int64_t ring_length (Ring* ring);
+
+/**
+ * Create a new ring.
+ */
+Ring* ring_new ();
+
+/**
+ * Retrieve the region of committed data that has not been consumed, without consuming it.
+ *
+ * This must only be called by the consumer.
+ *
+ * @param ring   The ring.
+ * @param region The region.
+ */
+bool ring_peek (Ring* ring, RingRegion* region);
+
+/**
+ * Read and consume up to a length of data.
+ *
+ * @param ring   The ring.
+ * @param data   The data.
+ * @param length The maximum length to read.
+ */
+int64_t ring_read (Ring* ring, unsigned char* data, int64_t length);
+
+/**
+ * Reserve a region of free space to write into, which must be committed once written.
+ *
+ * @param ring   The ring.
+ * @param length The length.
+ * @param region The region.
+ */
+bool ring_reserve (Ring* ring, int64_t length, RingRegion* region);
+
+/**
+ * Retrieve the size of a ring.
+ *
+ * @param ring The ring.
+ */
+int64_t ring_size (Ring* ring);
+
+/**
+ * Write data into a ring.
+ *
+ * @param ring   The ring.
+ * @param data   The data.
+ * @param length The length of the data.
+ */
+bool ring_write (Ring* ring, unsigned char* data, int64_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
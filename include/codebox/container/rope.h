@@ -0,0 +1,289 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __CODEBOX_ROPE_H
+#define __CODEBOX_ROPE_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "codebox/container/buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __ROPE_CHUNK_SIZE 65536
+#define __ROPE_MAX_DEPTH  96
+#define __ROPE_MERGE_SIZE 1024
+
+// -------------------------------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------------------------------
+
+typedef struct {
+    /** The reference count. */
+    int32_t refs;
+
+    /** The length of the data. */
+    int64_t length;
+
+    /** The size of the data allocated. */
+    int64_t size;
+
+    /** The data, which is only ever appended to past the ranges its leaves reference. */
+    unsigned char data[];
+} RopeChunk;
+
+typedef struct __rope_node {
+    /** The chunk referenced by a leaf node. */
+    RopeChunk* chunk;
+
+    /** The left child of a branch node. */
+    struct __rope_node* left;
+
+    /** The right child of a branch node. */
+    struct __rope_node* right;
+
+    /** The length of the data under the node. */
+    int64_t length;
+
+    /** The offset into the chunk of a leaf node. */
+    int64_t offset;
+
+    /** The height of the node, where leaves have a height of 1. */
+    int32_t height;
+
+    /** The reference count. */
+    int32_t refs;
+} RopeNode;
+
+typedef struct {
+    /** The mutex. */
+    pthread_mutex_t* mutex;
+
+    /** The root node, or NULL when the rope is empty. */
+    RopeNode* root;
+} Rope;
+
+typedef struct {
+    /** The current leaf node. */
+    RopeNode* leaf;
+
+    /** The branch nodes whose right children have not been visited. */
+    RopeNode* stack[__ROPE_MAX_DEPTH];
+
+    /** The count of nodes on the stack. */
+    int32_t depth;
+} RopeIterator;
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Append data onto the end of a rope.
+ *
+ * @param rope   The rope.
+ * @param data   The data.
+ * @param length The length of the data.
+ */
+bool rope_append (Rope* rope, unsigned char* data, int64_t length);
+
+/**
+ * Append data onto the end of a rope using thread safety.
+ *
+ * @param rope   The rope.
+ * @param data   The data.
+ * @param length The length of the data.
+ */
+bool rope_append_ts (Rope* rope, unsigned char* data, int64_t length);
+
+/**
+ * Append the data in a buffer onto the end of a rope.
+ *
+ * @param rope   The rope.
+ * @param buffer The buffer.
+ */
+bool rope_append_buffer (Rope* rope, Buffer* buffer);
+
+/**
+ * Cleanup a rope.
+ *
+ * @param rope The rope.
+ */
+bool rope_cleanup (Rope* rope);
+
+/**
+ * Copy a slice of a rope.
+ *
+ * The copy shares its chunks with the rope, so no data is copied and this runs in O(log n).
+ *
+ * @param rope   The rope.
+ * @param start  The starting position.
+ * @param length The length.
+ */
+Rope* rope_copy (Rope* rope, int64_t start, int64_t length);
+
+/**
+ * Copy a slice of a rope using thread safety.
+ *
+ * @param rope   The rope.
+ * @param start  The starting position.
+ * @param length The length.
+ */
+Rope* rope_copy_ts (Rope* rope, int64_t start, int64_t length);
+
+/**
+ * Find the position of a character sequence.
+ *
+ * @param rope     The rope.
+ * @param start    The start index.
+ * @param sequence The character sequence.
+ * @param length   The length of the character sequence.
+ */
+int64_t rope_indexof (Rope* rope, int64_t start, unsigned char* sequence, int32_t length);
+
+/**
+ * Find the position of a character sequence using thread safety.
+ *
+ * @param rope     The rope.
+ * @param start    The start index.
+ * @param sequence The character sequence.
+ * @param length   The length of the character sequence.
+ */
+int64_t rope_indexof_ts (Rope* rope, int64_t start, unsigned char* sequence, int32_t length);
+
+/**
+ * Initialize a rope.
+ *
+ * @param rope        The rope.
+ * @param thread_safe Indicates that a mutex will be initialized.
+ */
+bool rope_init (Rope* rope, bool thread_safe);
+
+/**
+ * Insert data into a rope.
+ *
+ * @param rope   The rope.
+ * @param index  The index.
+ * @param data   The data.
+ * @param length The length of the data.
+ */
+bool rope_insert (Rope* rope, int64_t index, unsigned char* data, int64_t length);
+
+/**
+ * Insert data into a rope using thread safety.
+ *
+ * @param rope   The rope.
+ * @param index  The index.
+ * @param data   The data.
+ * @param length The length of the data.
+ */
+bool rope_insert_ts (Rope* rope, int64_t index, unsigned char* data, int64_t length);
+
+/**
+ * Retrieve the data of the current chunk.
+ *
+ * @param iter The rope iterator.
+ */
+unsigned char* rope_iter_data (RopeIterator* iter);
+
+/**
+ * Initialize a rope iterator, which visits the chunks of a rope in order.
+ *
+ * Note: The rope must be locked prior to iterating in multithreaded environments.
+ *
+ * @param iter The rope iterator.
+ * @param rope The rope.
+ */
+void rope_iter_init (RopeIterator* iter, Rope* rope);
+
+/**
+ * Retrieve the length of the current chunk.
+ *
+ * @param iter The rope iterator.
+ */
+int64_t rope_iter_length (RopeIterator* iter);
+
+/**
+ * Skip to the next chunk.
+ *
+ * @param iter The rope iterator.
+ */
+bool rope_iter_next (RopeIterator* iter);
+
+/**
+ * Retrieve the length of a rope.
+ *
+ * @param rope The rope.
+ */
+int64_t rope_length (Rope* rope);
+
+/**
+ * Retrieve the length of a rope using thread safety.
+ *
+ * @param rope The rope.
+ */
+int64_t rope_length_ts (Rope* rope);
+
+/**
+ * Lock a rope if it was initialized as thread-safe.
+ *
+ * @param rope The rope.
+ */
+void rope_lock (Rope* rope);
+
+/**
+ * Create a new rope.
+ */
+Rope* rope_new ();
+
+/**
+ * Remove a slice of a rope.
+ *
+ * @param rope   The rope.
+ * @param start  The starting position.
+ * @param length The length.
+ */
+bool rope_remove (Rope* rope, int64_t start, int64_t length);
+
+/**
+ * Remove a slice of a rope using thread safety.
+ *
+ * @param rope   The rope.
+ * @param start  The starting position.
+ * @param length The length.
+ */
+bool rope_remove_ts (Rope* rope, int64_t start, int64_t length);
+
+/**
+ * Append the data in a rope onto the end of a buffer.
+ *
+ * @param rope   The rope.
+ * @param buffer The buffer.
+ */
+bool rope_to_buffer (Rope* rope, Buffer* buffer);
+
+/**
+ * Unlock a rope if it was initialized as thread-safe.
+ *
+ * @param rope The rope.
+ */
+void rope_unlock (Rope* rope);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,336 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __CODEBOX_SERIAL_H
+#define __CODEBOX_SERIAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "codebox/container/buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+// the most bytes a varint of 64 bits is encoded in
+#define BUFFER_VARINT_MAX 10
+
+// -------------------------------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------------------------------
+
+typedef struct {
+    /** The data. */
+    unsigned char* data;
+
+    /** Indicates that a read ran past the end of the data or decoded a malformed value. */
+    bool error;
+
+    /** The length of the data. */
+    int64_t length;
+
+    /** The position of the next byte to read. */
+    int64_t position;
+} BufferReader;
+
+typedef struct {
+    /** The buffer. */
+    Buffer* buffer;
+} BufferWriter;
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Read a length-prefixed blob without copying it, returning a pointer into the data of the reader
+ * or NULL on error.
+ *
+ * @param reader The reader.
+ * @param length The length of the blob.
+ */
+unsigned char* buffer_reader_blob (BufferReader* reader, int64_t* length);
+
+/**
+ * Copy bytes out of a reader.
+ *
+ * @param reader The reader.
+ * @param data   The data.
+ * @param length The length.
+ */
+bool buffer_reader_bytes (BufferReader* reader, unsigned char* data, int64_t length);
+
+/**
+ * Read a big-endian float.
+ *
+ * @param reader The reader.
+ */
+float buffer_reader_f32be (BufferReader* reader);
+
+/**
+ * Read a little-endian float.
+ *
+ * @param reader The reader.
+ */
+float buffer_reader_f32le (BufferReader* reader);
+
+/**
+ * Read a big-endian double.
+ *
+ * @param reader The reader.
+ */
+double buffer_reader_f64be (BufferReader* reader);
+
+/**
+ * Read a little-endian double.
+ *
+ * @param reader The reader.
+ */
+double buffer_reader_f64le (BufferReader* reader);
+
+/**
+ * Initialize a reader of the data in a buffer, which must not be modified while it is read.
+ *
+ * Reads past the end of the data return 0 and set the error flag of the reader rather than
+ * failing individually, so a frame of values can be decoded and checked for errors once.
+ *
+ * @param reader The reader.
+ * @param buffer The buffer.
+ */
+void buffer_reader_init (BufferReader* reader, Buffer* buffer);
+
+/**
+ * Retrieve the count of bytes left to read.
+ *
+ * @param reader The reader.
+ */
+int64_t buffer_reader_remaining (BufferReader* reader);
+
+/**
+ * Check once that a frame of a length can be read, setting the error flag if it cannot.
+ *
+ * @param reader The reader.
+ * @param length The length.
+ */
+bool buffer_reader_require (BufferReader* reader, int64_t length);
+
+/**
+ * Read a zigzag encoded signed varint.
+ *
+ * @param reader The reader.
+ */
+int64_t buffer_reader_svarint (BufferReader* reader);
+
+/**
+ * Read a big-endian 16-bit integer.
+ *
+ * @param reader The reader.
+ */
+uint16_t buffer_reader_u16be (BufferReader* reader);
+
+/**
+ * Read a little-endian 16-bit integer.
+ *
+ * @param reader The reader.
+ */
+uint16_t buffer_reader_u16le (BufferReader* reader);
+
+/**
+ * Read a big-endian 32-bit integer.
+ *
+ * @param reader The reader.
+ */
+uint32_t buffer_reader_u32be (BufferReader* reader);
+
+/**
+ * Read a little-endian 32-bit integer.
+ *
+ * @param reader The reader.
+ */
+uint32_t buffer_reader_u32le (BufferReader* reader);
+
+/**
+ * Read a big-endian 64-bit integer.
+ *
+ * @param reader The reader.
+ */
+uint64_t buffer_reader_u64be (BufferReader* reader);
+
+/**
+ * Read a little-endian 64-bit integer.
+ *
+ * @param reader The reader.
+ */
+uint64_t buffer_reader_u64le (BufferReader* reader);
+
+/**
+ * Read a byte.
+ *
+ * @param reader The reader.
+ */
+uint8_t buffer_reader_u8 (BufferReader* reader);
+
+/**
+ * Read an unsigned LEB128 varint.
+ *
+ * @param reader The reader.
+ */
+uint64_t buffer_reader_varint (BufferReader* reader);
+
+/**
+ * Write a blob prefixed with its length as a varint.
+ *
+ * @param writer The writer.
+ * @param data   The data.
+ * @param length The length of the data.
+ */
+bool buffer_writer_blob (BufferWriter* writer, unsigned char* data, int64_t length);
+
+/**
+ * Write bytes.
+ *
+ * @param writer The writer.
+ * @param data   The data.
+ * @param length The length of the data.
+ */
+bool buffer_writer_bytes (BufferWriter* writer, unsigned char* data, int64_t length);
+
+/**
+ * Write a big-endian float.
+ *
+ * @param writer The writer.
+ * @param value  The value.
+ */
+bool buffer_writer_f32be (BufferWriter* writer, float value);
+
+/**
+ * Write a little-endian float.
+ *
+ * @param writer The writer.
+ * @param value  The value.
+ */
+bool buffer_writer_f32le (BufferWriter* writer, float value);
+
+/**
+ * Write a big-endian double.
+ *
+ * @param writer The writer.
+ * @param value  The value.
+ */
+bool buffer_writer_f64be (BufferWriter* writer, double value);
+
+/**
+ * Write a little-endian double.
+ *
+ * @param writer The writer.
+ * @param value  The value.
+ */
+bool buffer_writer_f64le (BufferWriter* writer, double value);
+
+/**
+ * Initialize a writer that appends onto the end of a buffer.
+ *
+ * Each write checks the capacity of the buffer with a single comparison and stores its bytes
+ * directly, so reserving the size of a whole message with buffer_writer_reserve() first leaves no
+ * other work per value.
+ *
+ * @param writer The writer.
+ * @param buffer The buffer.
+ */
+void buffer_writer_init (BufferWriter* writer, Buffer* buffer);
+
+/**
+ * Reserve space for a count of bytes to be written without growing the buffer.
+ *
+ * @param writer The writer.
+ * @param length The count of bytes.
+ */
+bool buffer_writer_reserve (BufferWriter* writer, int64_t length);
+
+/**
+ * Write a signed varint using zigzag encoding, so that small negative values stay short.
+ *
+ * @param writer The writer.
+ * @param value  The value.
+ */
+bool buffer_writer_svarint (BufferWriter* writer, int64_t value);
+
+/**
+ * Write a big-endian 16-bit integer.
+ *
+ * @param writer The writer.
+ * @param value  The value.
+ */
+bool buffer_writer_u16be (BufferWriter* writer, uint16_t value);
+
+/**
+ * Write a little-endian 16-bit integer.
+ *
+ * @param writer The writer.
+ * @param value  The value.
+ */
+bool buffer_writer_u16le (BufferWriter* writer, uint16_t value);
+
+/**
+ * Write a big-endian 32-bit integer.
+ *
+ * @param writer The writer.
+ * @param value  The value.
+ */
+bool buffer_writer_u32be (BufferWriter* writer, uint32_t value);
+
+/**
+ * Write a little-endian 32-bit integer.
+ *
+ * @param writer The writer.
+ * @param value  The value.
+ */
+bool buffer_writer_u32le (BufferWriter* writer, uint32_t value);
+
+/**
+ * Write a big-endian 64-bit integer.
+ *
+ * @param writer The writer.
+ * @param value  The value.
+ */
+bool buffer_writer_u64be (BufferWriter* writer, uint64_t value);
+
+/**
+ * Write a little-endian 64-bit integer.
+ *
+ * @param writer The writer.
+ * @param value  The value.
+ */
+bool buffer_writer_u64le (BufferWriter* writer, uint64_t value);
+
+/**
+ * Write a byte.
+ *
+ * @param writer The writer.
+ * @param value  The value.
+ */
+bool buffer_writer_u8 (BufferWriter* writer, uint8_t value);
+
+/**
+ * Write an unsigned LEB128 varint.
+ *
+ * @param writer The writer.
+ * @param value  The value.
+ */
+bool buffer_writer_varint (BufferWriter* writer, uint64_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -18,6 +18,17 @@
 extern "C" {
 #endif
 
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __TABLE_DEFAULT_BUCKET_COUNT 53
+#define __TABLE_DEFAULT_COMP_FUNC    compare_binary
+#define __TABLE_DEFAULT_HASH_FUNC    hash_djb2
+#define __TABLE_DEFAULT_HASH64_FUNC  hash_fnv1a_64
+#define __TABLE_DEFAULT_LOAD_FACTOR  0.75
+#define __TABLE_SMALL_COUNT          8
+
 // -------------------------------------------------------------------------------------------------
 // TYPEDEFS
 // -------------------------------------------------------------------------------------------------
@@ -33,7 +44,7 @@ typedef struct __bucket {
     void* value;
 
     /** The hashcode. */
-    uint32_t hashcode;
+    uint64_t hashcode;
 
     /** The key length. */
     int32_t length;
@@ -47,6 +58,9 @@ typedef struct {
     /** The hash function. */
     uint32_t (*hash_func) (unsigned char* key, int32_t length);
 
+    /** The 64-bit hash function, which is only set for 64-bit tables. */
+    uint64_t (*hash64_func) (unsigned char* key, int32_t length);
+
     /** The buckets. */
     Bucket** buckets;
 
@@ -54,16 +68,31 @@ typedef struct {
     pthread_mutex_t* mutex;
 
     /** The bucket count. */
-    int32_t bucket_count;
+    int64_t bucket_count;
 
     /** The key count. */
-    int32_t key_count;
+    int64_t key_count;
 
     /** The resize load factor. */
     float load_factor;
 
     /** The resize count. */
-    int32_t resize_count;
+    int64_t resize_count;
+
+    /** The count of active thread-safe iterators, while non-zero resizes are deferred. */
+    int32_t iter_count;
+
+    /** The inline hashcodes, used until the key count outgrows the small table size. */
+    uint64_t small_hashcodes[__TABLE_SMALL_COUNT];
+
+    /** The inline keys. */
+    unsigned char* small_keys[__TABLE_SMALL_COUNT];
+
+    /** The inline key lengths. */
+    int32_t small_lengths[__TABLE_SMALL_COUNT];
+
+    /** The inline values. */
+    void* small_values[__TABLE_SMALL_COUNT];
 } Table;
 
 typedef struct {
@@ -74,24 +103,36 @@ typedef struct {
     Table* table;
 
     /** The current bucket index. */
-    int32_t bucket_index;
-} TableIterator;
+    int64_t bucket_index;
 
-// -------------------------------------------------------------------------------------------------
-// MACROS
-// -------------------------------------------------------------------------------------------------
+    /** The keys copied from the current bucket during a thread-safe iteration. */
+    unsigned char** keys;
 
-#define __TABLE_DEFAULT_BUCKET_COUNT 53
-#define __TABLE_DEFAULT_COMP_FUNC    compare_binary
-#define __TABLE_DEFAULT_HASH_FUNC    hash_djb2
-#define __TABLE_DEFAULT_LOAD_FACTOR  0.75
+    /** The values copied from the current bucket during a thread-safe iteration. */
+    void** values;
+
+    /** The count of copied key/value pairs. */
+    int32_t count;
+
+    /** The index of the current copied key/value pair. */
+    int32_t index;
+
+    /** The capacity of the copied key/value arrays. */
+    int32_t size;
+
+    /** Indicates the iterator was initialized using thread safety. */
+    bool thread_safe;
+} TableIterator;
 
 // -------------------------------------------------------------------------------------------------
 // FUNCTIONS
 // -------------------------------------------------------------------------------------------------
 
 /**
- * Compare two pointers.
+ * Compare two keys for equality.
+ *
+ * Keys of different lengths are never equal. Keys of 16 bytes or more are compared 16 or 32 bytes
+ * at a time, using the widest vector instructions the processor supports.
  *
  * @param key1    The first key.
  * @param length1 The first key length.
@@ -109,6 +150,14 @@ bool compare_binary (unsigned char* key1, int32_t length1,
  */
 uint32_t hash_djb2 (unsigned char* bytes, int32_t length);
 
+/**
+ * The 64-bit FNV-1a hash function.
+ *
+ * @param bytes  The bytes.
+ * @param length The length.
+ */
+uint64_t hash_fnv1a_64 (unsigned char* bytes, int32_t length);
+
 /**
  * Cleanup a hash table.
  *
@@ -155,6 +204,9 @@ bool table_has_key_ts (Table* table, unsigned char* key, int32_t length);
 /**
  * Initialize a hash table.
  *
+ * Tables initialized with the default bucket count or less start in small mode, holding up to 8
+ * keys inline without any heap allocation, and allocate their buckets once they grow past that.
+ *
  * @param table        The hash table.
  * @param bucket_count The initial bucket count.
  * @param load_factor  The resize load factor.
@@ -162,12 +214,31 @@ bool table_has_key_ts (Table* table, unsigned char* key, int32_t length);
  * @param hash_func    The hash function.
  * @param thread_safe  Indicates that a mutex will be initialized.
  */
-bool table_init (Table* table, int32_t bucket_count, float load_factor,
+bool table_init (Table* table, int64_t bucket_count, float load_factor,
                  bool (*comp_func) (unsigned char* key1, int32_t length1,
                                     unsigned char* key2, int32_t length2),
                  uint32_t (*hash_func) (unsigned char* key, int32_t length),
                  bool thread_safe);
 
+/**
+ * Initialize a 64-bit hash table.
+ *
+ * A 64-bit table stores 64-bit hashcodes and may grow beyond 2^31 buckets, which keeps full-hash
+ * collisions, and therefore calls to the comparison function, rare on very large tables.
+ *
+ * @param table        The hash table.
+ * @param bucket_count The initial bucket count.
+ * @param load_factor  The resize load factor.
+ * @param comp_func    The comparison function.
+ * @param hash64_func  The 64-bit hash function.
+ * @param thread_safe  Indicates that a mutex will be initialized.
+ */
+bool table_init_64 (Table* table, int64_t bucket_count, float load_factor,
+                    bool (*comp_func) (unsigned char* key1, int32_t length1,
+                                       unsigned char* key2, int32_t length2),
+                    uint64_t (*hash64_func) (unsigned char* key, int32_t length),
+                    bool thread_safe);
+
 /**
  * Initialize a hash table with default settings.
  *
@@ -196,6 +267,44 @@ bool table_init_defaults (Table* table);
  */
 bool table_init_defaults_ts (Table* table);
 
+/**
+ * Initialize a 64-bit hash table with default settings.
+ *
+ * Defaults:
+ *   * bucket_count = 53
+ *   * load_factor  = 0.75
+ *   * comp_func    = binary
+ *   * hash64_func  = fnv1a_64
+ *   * thread_safe  = false
+ *
+ * @param table The hash table.
+ */
+bool table_init_defaults_64 (Table* table);
+
+/**
+ * Initialize a thread-safe 64-bit hash table with default settings.
+ *
+ * Defaults:
+ *   * bucket_count = 53
+ *   * load_factor  = 0.75
+ *   * comp_func    = binary
+ *   * hash64_func  = fnv1a_64
+ *   * thread_safe  = true
+ *
+ * @param table The hash table.
+ */
+bool table_init_defaults_64_ts (Table* table);
+
+/**
+ * Cleanup a table iterator that was initialized using thread safety.
+ *
+ * If this is the last active thread-safe iterator, a resize deferred during iteration is
+ * performed.
+ *
+ * @param iter The table iterator.
+ */
+void table_iter_cleanup_ts (TableIterator* iter);
+
 /**
  * Initialize a table iterator.
  *
@@ -206,6 +315,20 @@ bool table_init_defaults_ts (Table* table);
  */
 void table_iter_init (TableIterator* iter, Table* table);
 
+/**
+ * Initialize a table iterator using thread safety.
+ *
+ * The table does not need to be locked while iterating. The lock is held only long enough to copy
+ * each bucket, and resizes are deferred until every thread-safe iterator has been cleaned up, so
+ * no pair is yielded twice. Every key present for the whole iteration is yielded, while keys put
+ * or removed concurrently may or may not be. Keys and values of removed pairs must stay valid
+ * until the iteration has moved past them.
+ *
+ * @param iter  The table iterator.
+ * @param table The table.
+ */
+void table_iter_init_ts (TableIterator* iter, Table* table);
+
 /**
  * Retrieve the key for the current table iteration.
  *
@@ -224,6 +347,13 @@ void* table_iter_key (TableIterator* iter);
  */
 bool table_iter_next (TableIterator* iter);
 
+/**
+ * Skip to the next key/value pair using thread safety.
+ *
+ * @param iter The table iterator.
+ */
+bool table_iter_next_ts (TableIterator* iter);
+
 /**
  * Retrieve the value for the current table iteration.
  *
@@ -238,14 +368,14 @@ void* table_iter_value (TableIterator* iter);
  *
  * @param table The table.
  */
-int32_t table_key_count (Table* table);
+int64_t table_key_count (Table* table);
 
 /**
  * Retrieve the count of keys in a table using thread safety.
  *
  * @param table The table.
  */
-int32_t table_key_count_ts (Table* table);
+int64_t table_key_count_ts (Table* table);
 
 /**
  * Lock a table if it was initialized as thread-safe.
@@ -300,10 +430,12 @@ void* table_remove_ts (Table* table, unsigned char* key, int32_t length);
 /**
  * Resize a hash table.
  *
+ * This fails while thread-safe iterators are active.
+ *
  * @param table        The table.
  * @param bucket_count The estimated bucket count.
  */
-bool table_resize (Table* table, int32_t bucket_count);
+bool table_resize (Table* table, int64_t bucket_count);
 
 /**
  * Resize a hash table using thread safety.
@@ -311,7 +443,7 @@ bool table_resize (Table* table, int32_t bucket_count);
  * @param table        The table.
  * @param bucket_count The estimated bucket count.
  */
-bool table_resize_ts (Table* table, int32_t bucket_count);
+bool table_resize_ts (Table* table, int64_t bucket_count);
 
 /**
  * Unlock a table if it was initialized as thread-safe.
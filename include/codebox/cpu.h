@@ -0,0 +1,41 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __CODEBOX_CPU_H
+#define __CODEBOX_CPU_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Indicates whether or not the processor supports AVX2.
+ */
+bool cpu_has_avx2 ();
+
+/**
+ * Indicates whether or not the processor supports SSE4.2.
+ */
+bool cpu_has_sse42 ();
+
+/**
+ * Indicates whether or not the processor supports SSSE3.
+ */
+bool cpu_has_ssse3 ();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __CODEBOX_ENCODING_H
+#define __CODEBOX_ENCODING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "codebox/container/buffer.h"
+
+// -------------------------------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------------------------------
+
+typedef enum {
+    /** The alphabet of RFC 4648 section 4, using + and /, padded with =. */
+    BASE64_STANDARD,
+
+    /** The URL and filename safe alphabet of RFC 4648 section 5, using - and _, not padded. */
+    BASE64_URL
+} Base64Alphabet;
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Decode base64 data onto the end of a buffer, leaving the buffer unchanged when the data is not
+ * valid. Padding is optional with either alphabet.
+ *
+ * @param dest     The destination buffer.
+ * @param data     The data.
+ * @param length   The length of the data.
+ * @param alphabet The alphabet.
+ */
+bool base64_decode (Buffer* dest, unsigned char* data, int64_t length, Base64Alphabet alphabet);
+
+/**
+ * Decode the base64 data of a buffer onto the end of another buffer.
+ *
+ * @param dest     The destination buffer.
+ * @param source   The source buffer.
+ * @param alphabet The alphabet.
+ */
+bool base64_decode_buffer (Buffer* dest, Buffer* source, Base64Alphabet alphabet);
+
+/**
+ * Encode data as base64 onto the end of a buffer.
+ *
+ * Blocks of input are encoded 24 or 12 bytes at a time with AVX2 or SSSE3 when the processor
+ * supports them, and the remainder a byte triple at a time.
+ *
+ * @param dest     The destination buffer.
+ * @param data     The data.
+ * @param length   The length of the data.
+ * @param alphabet The alphabet.
+ */
+bool base64_encode (Buffer* dest, unsigned char* data, int64_t length, Base64Alphabet alphabet);
+
+/**
+ * Encode the data of a buffer as base64 onto the end of another buffer.
+ *
+ * @param dest     The destination buffer.
+ * @param source   The source buffer.
+ * @param alphabet The alphabet.
+ */
+bool base64_encode_buffer (Buffer* dest, Buffer* source, Base64Alphabet alphabet);
+
+/**
+ * Decode hex data of either case onto the end of a buffer, leaving the buffer unchanged when the
+ * data is not valid.
+ *
+ * @param dest   The destination buffer.
+ * @param data   The data.
+ * @param length The length of the data.
+ */
+bool hex_decode (Buffer* dest, unsigned char* data, int64_t length);
+
+/**
+ * Decode the hex data of a buffer onto the end of another buffer.
+ *
+ * @param dest   The destination buffer.
+ * @param source The source buffer.
+ */
+bool hex_decode_buffer (Buffer* dest, Buffer* source);
+
+/**
+ * Encode data as lowercase hex onto the end of a buffer.
+ *
+ * @param dest   The destination buffer.
+ * @param data   The data.
+ * @param length The length of the data.
+ */
+bool hex_encode (Buffer* dest, unsigned char* data, int64_t length);
+
+/**
+ * Encode the data of a buffer as lowercase hex onto the end of another buffer.
+ *
+ * @param dest   The destination buffer.
+ * @param source The source buffer.
+ */
+bool hex_encode_buffer (Buffer* dest, Buffer* source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __CODEBOX_FORMAT_H
+#define __CODEBOX_FORMAT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+// the most characters written by each format function, which does not terminate its output
+#define FORMAT_F64_MAX 24
+#define FORMAT_I64_MAX 20
+#define FORMAT_U64_MAX 20
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Format a double with the fewest digits that parse back to the same value, returning the count of
+ * characters written.
+ *
+ * Values with a decimal exponent from -5 up to 20 are written in fixed notation, such as 0.001 or
+ * 1500, and other values in scientific notation, such as 1e-7 or 2.5e+300. Infinities are written
+ * as inf or -inf, and NaNs as nan.
+ *
+ * @param dest  The destination, which must have room for FORMAT_F64_MAX characters.
+ * @param value The value.
+ */
+int32_t format_f64 (char* dest, double value);
+
+/**
+ * Format a signed integer, returning the count of characters written.
+ *
+ * @param dest  The destination, which must have room for FORMAT_I64_MAX characters.
+ * @param value The value.
+ */
+int32_t format_i64 (char* dest, int64_t value);
+
+/**
+ * Format an unsigned integer, returning the count of characters written.
+ *
+ * @param dest  The destination, which must have room for FORMAT_U64_MAX characters.
+ * @param value The value.
+ */
+int32_t format_u64 (char* dest, uint64_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
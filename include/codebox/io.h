@@ -17,6 +17,57 @@ extern "C" {
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "codebox/container/buffer.h"
+#include "codebox/string.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+// the bytes a reader asks a file descriptor for at a time
+#define IO_READER_READ (64 * 1024)
+
+// -------------------------------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------------------------------
+
+typedef enum {
+    /** Records end with a delimiter, which is not part of the record. */
+    IO_RECORD_DELIMITED,
+
+    /** Records are prefixed with their length as a varint, as buffer_writer_blob() writes them. */
+    IO_RECORD_PREFIXED
+} IoRecordFormat;
+
+typedef struct {
+    /** The data that has been read. */
+    Buffer buffer;
+
+    /** The delimiter of delimited records. */
+    SearchPattern delimiter;
+
+    /** Indicates that the end of the file has been reached. */
+    bool eof;
+
+    /** Indicates that a read failed, or a record was malformed, truncated or too long. */
+    bool error;
+
+    /** The file descriptor. */
+    int fd;
+
+    /** The record format. */
+    IoRecordFormat format;
+
+    /** The maximum length of a record. */
+    int64_t max_length;
+
+    /** The bytes past the position that have been searched for a delimiter without a match. */
+    int64_t scanned;
+
+    /** The position in the buffer of the next record. */
+    int64_t position;
+} IoReader;
+
 // -------------------------------------------------------------------------------------------------
 // FUNCTIONS
 // -------------------------------------------------------------------------------------------------
@@ -33,9 +84,9 @@ bool io_dir_list (char* path, void (*callback) (char*, struct dirent*));
  * Read a binary file.
  *
  * @param path   The filesystem path.
- * @param length The bytes read.
+ * @param length The bytes read, which is 0 when the file cannot be read.
  */
-unsigned char* io_file_read (char* path, uint32_t* length);
+unsigned char* io_file_read (char* path, int64_t* length);
 
 /**
  * Read an ASCII file.
@@ -44,6 +95,45 @@ unsigned char* io_file_read (char* path, uint32_t* length);
  */
 char* io_file_read_str (char* path);
 
+/**
+ * Cleanup a reader. This does not close its file descriptor.
+ *
+ * @param reader The reader.
+ */
+bool io_reader_cleanup (IoReader* reader);
+
+/**
+ * Initialize a reader of the records of a file descriptor.
+ *
+ * The reader fills a buffer with large reads and returns each record as a view into it, so a record
+ * is neither copied nor removed from the front of the buffer. The remainder of a partial record is
+ * only moved to the front once the buffer has no room left for a read.
+ *
+ * @param reader           The reader.
+ * @param fd               The file descriptor.
+ * @param format           The record format.
+ * @param delimiter        The delimiter of delimited records, such as "\n" for lines, which must
+ *                         remain valid while the reader is used.
+ * @param delimiter_length The length of the delimiter.
+ * @param max_length       The maximum length of a record, past which the reader fails.
+ */
+bool io_reader_init (IoReader* reader, int fd, IoRecordFormat format, unsigned char* delimiter,
+                     int64_t delimiter_length, int64_t max_length);
+
+/**
+ * Retrieve the next record, which remains valid until the next call.
+ *
+ * This fails at the end of the file, on error, and when a non-blocking file descriptor has no data
+ * ready, which the eof and error fields of the reader tell apart. A final delimited record that is
+ * missing its delimiter is still returned, but a final prefixed record that is cut short is an
+ * error.
+ *
+ * @param reader The reader.
+ * @param record The record.
+ * @param length The length of the record.
+ */
+bool io_reader_next (IoReader* reader, unsigned char** record, int64_t* length);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,236 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __CODEBOX_LZ_H
+#define __CODEBOX_LZ_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "codebox/container/buffer.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+// the most data compressed as a single block
+#define LZ_BLOCK_MAX (1 << 30)
+
+// the most bytes a block of a length compresses to
+#define LZ_BOUND(__length) ((__length) + (__length) / 255 + 16)
+
+// flags of lz_encoder_init() and lz_frame_compress()
+#define LZ_FRAME_BLOCK_CHECKSUM   1
+#define LZ_FRAME_CONTENT_CHECKSUM 2
+
+// the length of the data of a frame compressed as each block
+#define LZ_FRAME_BLOCK_SIZE (1 << 16)
+
+// -------------------------------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------------------------------
+
+typedef struct {
+    /** The length of the block being read. */
+    int64_t block_length;
+
+    /** The most data a block of the frame decompresses to. */
+    int64_t block_max;
+
+    /** The checksum of the data decompressed so far. */
+    uint32_t content_crc;
+
+    /** The flags of the frame. */
+    int32_t flags;
+
+    /** The part of the frame that is incomplete. */
+    Buffer pending;
+
+    /** The part of the frame expected next. */
+    int32_t state;
+} LzDecoder;
+
+typedef struct {
+    /** The checksum of the data written so far. */
+    uint32_t content_crc;
+
+    /** The flags of the frame. */
+    int32_t flags;
+
+    /** The data of a block that is not yet full. */
+    Buffer pending;
+
+    /** Indicates that the header of the frame has been written. */
+    bool started;
+} LzEncoder;
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Compress data as a single block in the LZ4 block format onto the end of a buffer.
+ *
+ * Matches of at least 4 bytes within the previous 64KB are found through a hash table of recent
+ * positions, and the search skips ahead faster the longer it goes without finding one, so data
+ * that does not compress costs little time.
+ *
+ * @param dest   The destination buffer.
+ * @param data   The data, which may be no longer than LZ_BLOCK_MAX.
+ * @param length The length of the data.
+ */
+bool lz_compress (Buffer* dest, unsigned char* data, int64_t length);
+
+/**
+ * Compress the data of a buffer as a single block onto the end of another buffer.
+ *
+ * @param dest   The destination buffer.
+ * @param source The source buffer.
+ */
+bool lz_compress_buffer (Buffer* dest, Buffer* source);
+
+/**
+ * Decompress a single block onto the end of a buffer, leaving the buffer unchanged when the block
+ * is not valid or decompresses to more than a length.
+ *
+ * @param dest       The destination buffer.
+ * @param data       The block.
+ * @param length     The length of the block.
+ * @param max_length The most bytes the block may decompress to.
+ */
+bool lz_decompress (Buffer* dest, unsigned char* data, int64_t length, int64_t max_length);
+
+/**
+ * Decompress the single block held by a buffer onto the end of another buffer.
+ *
+ * @param dest       The destination buffer.
+ * @param source     The source buffer.
+ * @param max_length The most bytes the block may decompress to.
+ */
+bool lz_decompress_buffer (Buffer* dest, Buffer* source, int64_t max_length);
+
+/**
+ * Cleanup a decoder.
+ *
+ * @param decoder The decoder.
+ */
+bool lz_decoder_cleanup (LzDecoder* decoder);
+
+/**
+ * Indicates whether or not a decoder has read the end of its frame.
+ *
+ * @param decoder The decoder.
+ */
+bool lz_decoder_done (LzDecoder* decoder);
+
+/**
+ * Initialize a decoder of a frame written by an encoder.
+ *
+ * @param decoder The decoder.
+ */
+bool lz_decoder_init (LzDecoder* decoder);
+
+/**
+ * Decode part of a frame, appending the data of each block completed by it onto the end of a
+ * buffer. Blocks that arrive whole are decoded in place, and only an incomplete block is copied.
+ *
+ * This fails when the frame is not valid, a checksum does not match, or data follows its end.
+ *
+ * @param decoder The decoder.
+ * @param dest    The destination buffer.
+ * @param data    The part of the frame.
+ * @param length  The length of the part of the frame.
+ */
+bool lz_decoder_write (LzDecoder* decoder, Buffer* dest, unsigned char* data, int64_t length);
+
+/**
+ * Cleanup an encoder.
+ *
+ * @param encoder The encoder.
+ */
+bool lz_encoder_cleanup (LzEncoder* encoder);
+
+/**
+ * Write the data of an incomplete block and the end of the frame onto the end of a buffer.
+ *
+ * @param encoder The encoder.
+ * @param dest    The destination buffer.
+ */
+bool lz_encoder_finish (LzEncoder* encoder, Buffer* dest);
+
+/**
+ * Initialize an encoder of a frame of independently compressed blocks.
+ *
+ * A frame starts with a header of the magic bytes CBLZ, a version, its flags, its block size as a
+ * power of two and a check byte. Each block follows as its little-endian 32-bit length, with the
+ * high bit set when it is stored uncompressed, then its data and, with LZ_FRAME_BLOCK_CHECKSUM,
+ * the CRC32C of its data. A length of 0 ends the frame and is followed, with
+ * LZ_FRAME_CONTENT_CHECKSUM, by the CRC32C of all the data of the frame.
+ *
+ * @param encoder The encoder.
+ * @param flags   The flags.
+ */
+bool lz_encoder_init (LzEncoder* encoder, int32_t flags);
+
+/**
+ * Write data to a frame, appending each block completed by it onto the end of a buffer. Whole
+ * blocks of the data are compressed in place, and only the rest is copied.
+ *
+ * @param encoder The encoder.
+ * @param dest    The destination buffer.
+ * @param data    The data.
+ * @param length  The length of the data.
+ */
+bool lz_encoder_write (LzEncoder* encoder, Buffer* dest, unsigned char* data, int64_t length);
+
+/**
+ * Compress data as a whole frame onto the end of a buffer.
+ *
+ * @param dest   The destination buffer.
+ * @param data   The data.
+ * @param length The length of the data.
+ * @param flags  The flags.
+ */
+bool lz_frame_compress (Buffer* dest, unsigned char* data, int64_t length, int32_t flags);
+
+/**
+ * Compress the data of a buffer as a whole frame onto the end of another buffer.
+ *
+ * @param dest   The destination buffer.
+ * @param source The source buffer.
+ * @param flags  The flags.
+ */
+bool lz_frame_compress_buffer (Buffer* dest, Buffer* source, int32_t flags);
+
+/**
+ * Decompress a whole frame onto the end of a buffer, leaving the buffer unchanged when the frame is
+ * not valid or is incomplete.
+ *
+ * @param dest   The destination buffer.
+ * @param data   The frame.
+ * @param length The length of the frame.
+ */
+bool lz_frame_decompress (Buffer* dest, unsigned char* data, int64_t length);
+
+/**
+ * Decompress the whole frame held by a buffer onto the end of another buffer.
+ *
+ * @param dest   The destination buffer.
+ * @param source The source buffer.
+ */
+bool lz_frame_decompress_buffer (Buffer* dest, Buffer* source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -13,12 +13,43 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 // -------------------------------------------------------------------------------------------------
 // TYPEDEFS
 // -------------------------------------------------------------------------------------------------
 
+typedef struct {
+    /** The set of bytes in the sequence. */
+    size_t byteset[32 / sizeof(size_t)];
+
+    /** The length of the sequence. */
+    int64_t length;
+
+    /** The count of bytes a periodic sequence may skip after shifting by its period. */
+    size_t memory;
+
+    /** The period the two-way search shifts by after a match of the right half fails. */
+    size_t period;
+
+    /** The positions of the two rarest bytes of the sequence, which are compared first. */
+    int64_t rare[2];
+
+    /** The sequence, which must remain valid while the pattern is used. */
+    unsigned char* sequence;
+
+    /** The distance from the last occurrence of each byte to the end, capped at INT32_MAX. */
+    int32_t shift[256];
+
+    /** The position of the critical factorization of the sequence. */
+    size_t suffix;
+
+    /** Indicates that the fields used by the two-way search have been computed. */
+    bool twoway;
+} SearchPattern;
+
 typedef struct __token {
     /** The data. */
     union {
@@ -30,7 +61,7 @@ typedef struct __token {
     struct __token* next;
 
     /** The length. */
-    uint32_t length;
+    int64_t length;
 } Token;
 
 // -------------------------------------------------------------------------------------------------
@@ -46,8 +77,19 @@ typedef struct __token {
  * @param sequence        The character sequence.
  * @param sequence_length The length of the character sequence.
  */
-int32_t chr_indexof (unsigned char* data, int32_t data_length, int32_t start,
-                     unsigned char* sequence, int32_t sequence_length);
+int64_t chr_indexof (unsigned char* data, int64_t data_length, int64_t start,
+                     unsigned char* sequence, int64_t sequence_length);
+
+/**
+ * Find the position of a precompiled search pattern.
+ *
+ * @param data        The data to search.
+ * @param data_length The length of the data.
+ * @param start       The start position.
+ * @param pattern     The search pattern.
+ */
+int64_t chr_indexof_pattern (unsigned char* data, int64_t data_length, int64_t start,
+                             SearchPattern* pattern);
 
 /**
  * Split data into tokens.
@@ -57,8 +99,35 @@ int32_t chr_indexof (unsigned char* data, int32_t data_length, int32_t start,
  * @param delimiter        The delimiter.
  * @param delimiter_length The length of the delimiter.
  */
-Token* chr_split (unsigned char* data, int32_t data_length, unsigned char* delimiter,
-                  int32_t delimiter_length);
+Token* chr_split (unsigned char* data, int64_t data_length, unsigned char* delimiter,
+                  int64_t delimiter_length);
+
+/**
+ * Split data into tokens on a precompiled search pattern.
+ *
+ * @param data        The data.
+ * @param data_length The length of the data.
+ * @param pattern     The search pattern of the delimiter.
+ */
+Token* chr_split_pattern (unsigned char* data, int64_t data_length, SearchPattern* pattern);
+
+/**
+ * Initialize a search pattern, which does the setup work of a search once so that it can be
+ * reused by any number of searches, including concurrent ones.
+ *
+ * @param pattern  The search pattern.
+ * @param sequence The character sequence, which must remain valid while the pattern is used.
+ * @param length   The length of the character sequence.
+ */
+void search_pattern_init (SearchPattern* pattern, unsigned char* sequence, int64_t length);
+
+/**
+ * Initialize a search pattern from a string.
+ *
+ * @param pattern  The search pattern.
+ * @param sequence The string, which must remain valid while the pattern is used.
+ */
+void search_pattern_init_str (SearchPattern* pattern, char* sequence);
 
 /**
  * Find the position of a character sequence.
@@ -67,7 +136,17 @@ Token* chr_split (unsigned char* data, int32_t data_length, unsigned char* delim
  * @param start    The start position.
  * @param sequence The character sequence.
  */
-int32_t str_indexof (char* data, int32_t start, char* sequence);
+int64_t str_indexof (char* data, int64_t start, char* sequence);
+
+/**
+ * Find the position of a precompiled search pattern in a string, without measuring or preparing
+ * the sequence again on each call.
+ *
+ * @param data    The data to search.
+ * @param start   The start position.
+ * @param pattern The search pattern.
+ */
+int64_t str_indexof_pattern (char* data, int64_t start, SearchPattern* pattern);
 
 /**
  * Split a string into tokens. This function does not yield string data that is NULL terminated.
@@ -78,6 +157,15 @@ int32_t str_indexof (char* data, int32_t start, char* sequence);
  */
 Token* str_split (char* data, char* delimiter);
 
+/**
+ * Split a string into tokens on a precompiled search pattern. This function does not yield string
+ * data that is NULL terminated.
+ *
+ * @param data    The data.
+ * @param pattern The search pattern of the delimiter.
+ */
+Token* str_split_pattern (char* data, SearchPattern* pattern);
+
 /**
  * Cleanup a token.
  *
@@ -0,0 +1,505 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <string.h>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+#include "codebox/checksum.h"
+#include "codebox/cpu.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+// the reflected CRC32C polynomial
+#define __CRC32C_POLY 0x82F63B78
+
+// the lengths of the three blocks the hardware checksum interleaves
+#define __CRC32C_LONG  8192
+#define __CRC32C_SHORT 256
+
+#define __HASH64_PRIME1 0x9E3779B185EBCA87ULL
+#define __HASH64_PRIME2 0xC2B2AE3D27D4EB4FULL
+#define __HASH64_PRIME3 0x165667B19E3779F9ULL
+#define __HASH64_PRIME4 0x85EBCA77C2B2AE63ULL
+#define __HASH64_PRIME5 0x27D4EB2F165667C5ULL
+
+#define __HASH64_ROTL(__value, __bits) (((__value) << (__bits)) | ((__value) >> (64 - (__bits))))
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define __CHECKSUM_LE32(__value) __builtin_bswap32(__value)
+#define __CHECKSUM_LE64(__value) __builtin_bswap64(__value)
+#else
+#define __CHECKSUM_LE32(__value) (__value)
+#define __CHECKSUM_LE64(__value) (__value)
+#endif
+
+// -------------------------------------------------------------------------------------------------
+// STATIC VARIABLES
+// -------------------------------------------------------------------------------------------------
+
+static uint32_t (*__crc32c_func) (uint32_t crc, unsigned char* data, int64_t length) = NULL;
+
+// the operators that append the zeros of a long or short block to a checksum, by byte of it
+static uint32_t __crc32c_long[4][256];
+static uint32_t __crc32c_short[4][256];
+
+static pthread_once_t __crc32c_once = PTHREAD_ONCE_INIT;
+
+// the checksums of each byte followed by 0 to 7 zero bytes
+static uint32_t __crc32c_table[8][256];
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Read a little-endian 32-bit integer.
+ */
+static uint32_t __checksum_read32 (unsigned char* data) {
+    uint32_t value;
+
+    memcpy(&value, data, sizeof(uint32_t));
+
+    return __CHECKSUM_LE32(value);
+}
+
+/**
+ * Read a little-endian 64-bit integer.
+ */
+static uint64_t __checksum_read64 (unsigned char* data) {
+    uint64_t value;
+
+    memcpy(&value, data, sizeof(uint64_t));
+
+    return __CHECKSUM_LE64(value);
+}
+
+/**
+ * Multiply a vector by a 32x32 matrix over GF(2).
+ */
+static uint32_t __crc32c_matrix_times (uint32_t* matrix, uint32_t vector) {
+    uint32_t sum = 0;
+
+    for (; 0 != vector; vector >>= 1, matrix++) {
+        if (vector & 1) {
+            sum ^= *matrix;
+        }
+    }
+
+    return sum;
+}
+
+/**
+ * Square a 32x32 matrix over GF(2).
+ */
+static void __crc32c_matrix_square (uint32_t* square, uint32_t* matrix) {
+    for (int32_t i = 0; i < 32; i++) {
+        square[i] = __crc32c_matrix_times(matrix, matrix[i]);
+    }
+}
+
+/**
+ * Build the tables of the operator that appends a power of two of zero bytes to a checksum.
+ */
+static void __crc32c_zeros (uint32_t zeros[4][256], int64_t length) {
+    uint32_t  even[32];
+    uint32_t  odd[32];
+    uint32_t* op = even;
+
+    // the operator for a single zero bit, squared to 2 and 4 bits
+    odd[0] = __CRC32C_POLY;
+
+    for (int32_t i = 1; i < 32; i++) {
+        odd[i] = 1U << (i - 1);
+    }
+
+    __crc32c_matrix_square(even, odd);
+    __crc32c_matrix_square(odd, even);
+
+    // squared again for each bit of the length in bytes, starting from 8 bits
+    for (;;) {
+        __crc32c_matrix_square(even, odd);
+
+        op       = even;
+        length >>= 1;
+
+        if (0 == length) {
+            break;
+        }
+
+        __crc32c_matrix_square(odd, even);
+
+        op       = odd;
+        length >>= 1;
+
+        if (0 == length) {
+            break;
+        }
+    }
+
+    for (uint32_t i = 0; i < 256; i++) {
+        zeros[0][i] = __crc32c_matrix_times(op, i);
+        zeros[1][i] = __crc32c_matrix_times(op, i << 8);
+        zeros[2][i] = __crc32c_matrix_times(op, i << 16);
+        zeros[3][i] = __crc32c_matrix_times(op, i << 24);
+    }
+}
+
+/**
+ * Build the tables.
+ */
+static void __crc32c_init () {
+    uint32_t crc;
+
+    for (uint32_t i = 0; i < 256; i++) {
+        crc = i;
+
+        for (int32_t j = 0; j < 8; j++) {
+            crc = crc & 1 ? (crc >> 1) ^ __CRC32C_POLY : crc >> 1;
+        }
+
+        __crc32c_table[0][i] = crc;
+    }
+
+    for (uint32_t i = 0; i < 256; i++) {
+        crc = __crc32c_table[0][i];
+
+        for (int32_t j = 1; j < 8; j++) {
+            crc                  = __crc32c_table[0][crc & 0xFF] ^ (crc >> 8);
+            __crc32c_table[j][i] = crc;
+        }
+    }
+
+    __crc32c_zeros(__crc32c_long, __CRC32C_LONG);
+    __crc32c_zeros(__crc32c_short, __CRC32C_SHORT);
+}
+
+/**
+ * Append the zeros of a long or short block to a checksum.
+ */
+static uint32_t __crc32c_shift (uint32_t zeros[4][256], uint32_t crc) {
+    return zeros[0][crc & 0xFF] ^ zeros[1][(crc >> 8) & 0xFF] ^ zeros[2][(crc >> 16) & 0xFF] ^
+           zeros[3][crc >> 24];
+}
+
+/**
+ * Update a checksum eight bytes at a time using the tables.
+ */
+static uint32_t __crc32c_sw (uint32_t crc, unsigned char* data, int64_t length) {
+    uint64_t word;
+
+    crc = ~crc;
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (; 8 <= length; data += 8, length -= 8) {
+        memcpy(&word, data, sizeof(uint64_t));
+
+        word ^= crc;
+        crc   = __crc32c_table[7][word & 0xFF] ^ __crc32c_table[6][(word >> 8) & 0xFF] ^
+                __crc32c_table[5][(word >> 16) & 0xFF] ^ __crc32c_table[4][(word >> 24) & 0xFF] ^
+                __crc32c_table[3][(word >> 32) & 0xFF] ^ __crc32c_table[2][(word >> 40) & 0xFF] ^
+                __crc32c_table[1][(word >> 48) & 0xFF] ^ __crc32c_table[0][word >> 56];
+    }
+#endif
+
+    for (; 0 < length; data++, length--) {
+        crc = __crc32c_table[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+#ifdef __x86_64__
+/**
+ * Update a checksum with the crc32 instruction.
+ *
+ * The instruction has a latency of three cycles but can start every cycle, so three blocks are
+ * checksummed at once, and the checksums of the first two are shifted over the blocks after them
+ * by table and combined.
+ */
+__attribute__((target("sse4.2")))
+static uint32_t __crc32c_sse42 (uint32_t crc, unsigned char* data, int64_t length) {
+    uint64_t crc0 = ~crc;
+    uint64_t crc1;
+    uint64_t crc2;
+    uint64_t word0;
+    uint64_t word1;
+    uint64_t word2;
+
+    for (; 3 * __CRC32C_LONG <= length; data += 3 * __CRC32C_LONG, length -= 3 * __CRC32C_LONG) {
+        crc1 = 0;
+        crc2 = 0;
+
+        for (int32_t i = 0; i < __CRC32C_LONG; i += 8) {
+            memcpy(&word0, data + i, sizeof(uint64_t));
+            memcpy(&word1, data + __CRC32C_LONG + i, sizeof(uint64_t));
+            memcpy(&word2, data + 2 * __CRC32C_LONG + i, sizeof(uint64_t));
+
+            crc0 = _mm_crc32_u64(crc0, word0);
+            crc1 = _mm_crc32_u64(crc1, word1);
+            crc2 = _mm_crc32_u64(crc2, word2);
+        }
+
+        crc0 = __crc32c_shift(__crc32c_long, crc0) ^ crc1;
+        crc0 = __crc32c_shift(__crc32c_long, crc0) ^ crc2;
+    }
+
+    for (; 3 * __CRC32C_SHORT <= length; data += 3 * __CRC32C_SHORT,
+                                         length -= 3 * __CRC32C_SHORT) {
+        crc1 = 0;
+        crc2 = 0;
+
+        for (int32_t i = 0; i < __CRC32C_SHORT; i += 8) {
+            memcpy(&word0, data + i, sizeof(uint64_t));
+            memcpy(&word1, data + __CRC32C_SHORT + i, sizeof(uint64_t));
+            memcpy(&word2, data + 2 * __CRC32C_SHORT + i, sizeof(uint64_t));
+
+            crc0 = _mm_crc32_u64(crc0, word0);
+            crc1 = _mm_crc32_u64(crc1, word1);
+            crc2 = _mm_crc32_u64(crc2, word2);
+        }
+
+        crc0 = __crc32c_shift(__crc32c_short, crc0) ^ crc1;
+        crc0 = __crc32c_shift(__crc32c_short, crc0) ^ crc2;
+    }
+
+    for (; 8 <= length; data += 8, length -= 8) {
+        memcpy(&word0, data, sizeof(uint64_t));
+
+        crc0 = _mm_crc32_u64(crc0, word0);
+    }
+
+    for (; 0 < length; data++, length--) {
+        crc0 = _mm_crc32_u8(crc0, *data);
+    }
+
+    return ~(uint32_t) crc0;
+}
+#endif
+
+/**
+ * Mix a lane of input into an accumulator.
+ */
+static uint64_t __hash64_round (uint64_t accumulator, uint64_t input) {
+    accumulator += input * __HASH64_PRIME2;
+    accumulator  = __HASH64_ROTL(accumulator, 31);
+
+    return accumulator * __HASH64_PRIME1;
+}
+
+/**
+ * Merge an accumulator into the hash of a long input.
+ */
+static uint64_t __hash64_merge (uint64_t hash, uint64_t accumulator) {
+    hash ^= __hash64_round(0, accumulator);
+
+    return hash * __HASH64_PRIME1 + __HASH64_PRIME4;
+}
+
+/**
+ * Mix stripes of 32 bytes into the accumulators of a hash, returning the count of bytes mixed.
+ */
+static int64_t __hash64_stripes (Hash64* hash, unsigned char* data, int64_t length) {
+    uint64_t v1 = hash->accumulators[0];
+    uint64_t v2 = hash->accumulators[1];
+    uint64_t v3 = hash->accumulators[2];
+    uint64_t v4 = hash->accumulators[3];
+    int64_t  i  = 0;
+
+    for (; i + 32 <= length; i += 32) {
+        v1 = __hash64_round(v1, __checksum_read64(data + i));
+        v2 = __hash64_round(v2, __checksum_read64(data + i + 8));
+        v3 = __hash64_round(v3, __checksum_read64(data + i + 16));
+        v4 = __hash64_round(v4, __checksum_read64(data + i + 24));
+    }
+
+    hash->accumulators[0] = v1;
+    hash->accumulators[1] = v2;
+    hash->accumulators[2] = v3;
+    hash->accumulators[3] = v4;
+
+    return i;
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+uint32_t crc32c (uint32_t crc, unsigned char* data, int64_t length) {
+    assert(0 <= length);
+    assert(NULL != data || 0 == length);
+
+    uint32_t (*func) (uint32_t, unsigned char*, int64_t) =
+        __atomic_load_n(&__crc32c_func, __ATOMIC_ACQUIRE);
+
+    if (NULL == func) {
+        pthread_once(&__crc32c_once, __crc32c_init);
+
+        func = __crc32c_sw;
+
+#ifdef __x86_64__
+        if (cpu_has_sse42()) {
+            func = __crc32c_sse42;
+        }
+#endif
+
+        __atomic_store_n(&__crc32c_func, func, __ATOMIC_RELEASE);
+    }
+
+    return func(crc, data, length);
+}
+
+uint32_t crc32c_buffer (uint32_t crc, Buffer* buffer) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->data);
+
+    if (-1 == buffer->gap) {
+        return crc32c(crc, buffer->data, buffer->length);
+    }
+
+    crc = crc32c(crc, buffer->data, buffer->gap);
+
+    return crc32c(crc, buffer->data + buffer->gap + buffer->size - buffer->length,
+                  buffer->length - buffer->gap);
+}
+
+uint64_t hash64 (unsigned char* data, int64_t length, uint64_t seed) {
+    Hash64 hash;
+
+    hash64_init(&hash, seed);
+    hash64_update(&hash, data, length);
+
+    return hash64_digest(&hash);
+}
+
+uint64_t hash64_buffer (Buffer* buffer, uint64_t seed) {
+    Hash64 hash;
+
+    hash64_init(&hash, seed);
+    hash64_update_buffer(&hash, buffer);
+
+    return hash64_digest(&hash);
+}
+
+uint64_t hash64_digest (Hash64* hash) {
+    assert(NULL != hash);
+
+    unsigned char* data   = hash->pending;
+    int32_t        length = hash->pending_length;
+    uint64_t       value;
+
+    if (32 <= hash->total_length) {
+        value = __HASH64_ROTL(hash->accumulators[0], 1) + __HASH64_ROTL(hash->accumulators[1], 7) +
+                __HASH64_ROTL(hash->accumulators[2], 12) + __HASH64_ROTL(hash->accumulators[3], 18);
+
+        for (int32_t i = 0; i < 4; i++) {
+            value = __hash64_merge(value, hash->accumulators[i]);
+        }
+    } else {
+        value = hash->seed + __HASH64_PRIME5;
+    }
+
+    value += hash->total_length;
+
+    for (; 8 <= length; data += 8, length -= 8) {
+        value ^= __hash64_round(0, __checksum_read64(data));
+        value  = __HASH64_ROTL(value, 27) * __HASH64_PRIME1 + __HASH64_PRIME4;
+    }
+
+    if (4 <= length) {
+        value  ^= __checksum_read32(data) * __HASH64_PRIME1;
+        value   = __HASH64_ROTL(value, 23) * __HASH64_PRIME2 + __HASH64_PRIME3;
+        data   += 4;
+        length -= 4;
+    }
+
+    for (; 0 < length; data++, length--) {
+        value ^= *data * __HASH64_PRIME5;
+        value  = __HASH64_ROTL(value, 11) * __HASH64_PRIME1;
+    }
+
+    value ^= value >> 33;
+    value *= __HASH64_PRIME2;
+    value ^= value >> 29;
+    value *= __HASH64_PRIME3;
+    value ^= value >> 32;
+
+    return value;
+}
+
+void hash64_init (Hash64* hash, uint64_t seed) {
+    assert(NULL != hash);
+
+    hash->accumulators[0] = seed + __HASH64_PRIME1 + __HASH64_PRIME2;
+    hash->accumulators[1] = seed + __HASH64_PRIME2;
+    hash->accumulators[2] = seed;
+    hash->accumulators[3] = seed - __HASH64_PRIME1;
+    hash->pending_length  = 0;
+    hash->seed            = seed;
+    hash->total_length    = 0;
+}
+
+void hash64_update (Hash64* hash, unsigned char* data, int64_t length) {
+    assert(NULL != hash);
+    assert(0 <= length);
+    assert(NULL != data || 0 == length);
+
+    int64_t fill;
+
+    if (0 == length) {
+        return;
+    }
+
+    hash->total_length += length;
+
+    if (0 < hash->pending_length) {
+        // complete the pending stripe first
+        fill = 32 - hash->pending_length < length ? 32 - hash->pending_length : length;
+
+        memcpy(hash->pending + hash->pending_length, data, fill);
+
+        hash->pending_length += fill;
+        data                 += fill;
+        length               -= fill;
+
+        if (32 > hash->pending_length) {
+            return;
+        }
+
+        __hash64_stripes(hash, hash->pending, 32);
+
+        hash->pending_length = 0;
+    }
+
+    fill = __hash64_stripes(hash, data, length);
+
+    memcpy(hash->pending, data + fill, length - fill);
+
+    hash->pending_length = length - fill;
+}
+
+void hash64_update_buffer (Hash64* hash, Buffer* buffer) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->data);
+
+    if (-1 == buffer->gap) {
+        hash64_update(hash, buffer->data, buffer->length);
+
+        return;
+    }
+
+    hash64_update(hash, buffer->data, buffer->gap);
+    hash64_update(hash, buffer->data + buffer->gap + buffer->size - buffer->length,
+                  buffer->length - buffer->gap);
+}
@@ -6,23 +6,56 @@
  * @author Sean Kerr: sean@code-box.org
  */
 
+#define _GNU_SOURCE
+
 #include <assert.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "codebox/container/buffer.h"
+#include "codebox/format.h"
 #include "codebox/string.h"
 
 // -------------------------------------------------------------------------------------------------
 // MACROS
 // -------------------------------------------------------------------------------------------------
 
-#define __BUFFER_ALIGN_SIZE(__size) \
-    (__size) < __BUFFER_CHUNK_SIZE \
-    ? __BUFFER_CHUNK_SIZE \
-    : (__size) % __BUFFER_CHUNK_SIZE == 0 \
-      ? (__size) \
-      : (__size) + __BUFFER_CHUNK_SIZE - ((__size) % __BUFFER_CHUNK_SIZE)
+// the flags of buffer_set_alloc() that map the data whatever its size
+#define __BUFFER_ALLOC_MAPPED (BUFFER_ALLOC_PAGE | BUFFER_ALLOC_HUGE)
+
+// the largest size that can be aligned and allocated
+#define __BUFFER_MAX_SIZE \
+    ((int64_t) (SIZE_MAX < INT64_MAX ? SIZE_MAX : INT64_MAX) - __BUFFER_CHUNK_SIZE)
+
+// the size of a transparent huge page, which huge data is aligned to
+#define __BUFFER_HUGE_SIZE ((int64_t) 2 * 1024 * 1024)
+
+#define __BUFFER_INLINE(__buffer) \
+    ((__buffer)->data == (__buffer)->inline_data)
+
+// data larger than this is mapped even without flags, so that its growth moves pages rather than
+// copying them, as glibc does for allocations past its largest mmap() threshold
+#define __BUFFER_MAP_THRESHOLD ((int64_t) 32 * 1024 * 1024)
+
+#define __BUFFER_MAPPED(__alloc, __size) \
+    (0 != ((__alloc) & __BUFFER_ALLOC_MAPPED) || __BUFFER_MAP_THRESHOLD < (__size))
+
+#define __BUFFER_LINEARIZE(__buffer) \
+    if (-1 != (__buffer)->gap) { \
+        __buffer_gap_move(__buffer, (__buffer)->length); \
+    }
+
+#define __BUFFER_UNSHARE(__buffer) \
+    if (NULL != (__buffer)->storage && !__buffer_writable(__buffer) && \
+        !__buffer_unshare(__buffer, (__buffer)->size)) { \
+        return false; \
+    }
 
 // -------------------------------------------------------------------------------------------------
 // STATIC VARIABLES
@@ -30,17 +63,330 @@
 
 static uint8_t __BUFFER_CHUNK_SIZE = sizeof(char*);
 
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Retrieve the size of the allocation that holds a size of data allocated with flags.
+ */
+static int64_t __buffer_alloc_size (int32_t alloc, int64_t size) {
+    int64_t align = __BUFFER_CHUNK_SIZE;
+
+    if (__BUFFER_MAPPED(alloc, size)) {
+        align = alloc & BUFFER_ALLOC_HUGE && __BUFFER_HUGE_SIZE <= size ? __BUFFER_HUGE_SIZE
+                                                                       : sysconf(_SC_PAGESIZE);
+    } else if (alloc & BUFFER_ALLOC_ALIGN64) {
+        align = 64;
+    }
+
+    if (__BUFFER_MAX_SIZE - align < size) {
+        // too large to allocate anyway
+        return size;
+    }
+
+    return (size + align - 1) / align * align;
+}
+
+/**
+ * Allocate data of a size returned by __buffer_alloc_size() with flags.
+ */
+static unsigned char* __buffer_allocate (int32_t alloc, int64_t size) {
+    unsigned char* data;
+    int64_t        extra = 0;
+    int64_t        head;
+
+    if (!__BUFFER_MAPPED(alloc, size)) {
+        if (alloc & BUFFER_ALLOC_ALIGN64) {
+            return 0 == posix_memalign((void**) &data, 64, size) ? data : NULL;
+        }
+
+        return malloc(size);
+    } else if (alloc & BUFFER_ALLOC_HUGE && __BUFFER_HUGE_SIZE <= size) {
+        // the mapping is made a huge page larger so that it can be trimmed to a huge page boundary
+        extra = __BUFFER_HUGE_SIZE;
+    }
+
+    data = mmap(NULL, size + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (MAP_FAILED == data) {
+        return NULL;
+    } else if (0 == extra) {
+        return data;
+    }
+
+    head = (__BUFFER_HUGE_SIZE - (int64_t) ((uintptr_t) data % __BUFFER_HUGE_SIZE)) %
+           __BUFFER_HUGE_SIZE;
+
+    if (0 < head) {
+        munmap(data, head);
+    }
+
+    if (head < extra) {
+        munmap(data + head + size, extra - head);
+    }
+
+#ifdef MADV_HUGEPAGE
+    // only advice, so the data stays on small pages where huge pages are disabled or unavailable
+    madvise(data + head, size, MADV_HUGEPAGE);
+#endif
+
+    return data + head;
+}
+
+/**
+ * Free the data a buffer owns.
+ */
+static void __buffer_free (Buffer* buffer) {
+    if (__BUFFER_INLINE(buffer)) {
+        return;
+    } else if (__BUFFER_MAPPED(buffer->alloc, buffer->size)) {
+        munmap(buffer->data, buffer->size);
+    } else {
+        free(buffer->data);
+    }
+}
+
+/**
+ * Move the gap of a gapped buffer to a position. Every byte of free space forms the gap.
+ */
+static void __buffer_gap_move (Buffer* buffer, int64_t index) {
+    int64_t gap        = -1 == buffer->gap ? buffer->length : buffer->gap;
+    int64_t gap_length = buffer->size - buffer->length;
+
+    if (index < gap) {
+        memmove(buffer->data + index + gap_length, buffer->data + index, gap - index);
+    } else if (gap < index) {
+        memmove(buffer->data + gap, buffer->data + gap + gap_length, index - gap);
+    }
+
+    buffer->gap = index == buffer->length ? -1 : index;
+}
+
+/**
+ * Grow a buffer by its growth factor, or to the given size if that is larger.
+ */
+static bool __buffer_grow (Buffer* buffer, int64_t size) {
+    double grown = buffer->size * (double) buffer->growth;
+
+    if (__BUFFER_MAX_SIZE <= grown) {
+        grown = __BUFFER_MAX_SIZE;
+    }
+
+    return buffer_resize(buffer, size < grown ? (int64_t) grown : size);
+}
+
+/**
+ * Release shared storage, freeing or unmapping it once it is no longer referenced.
+ */
+static void __buffer_release (BufferStorage* storage) {
+    if (0 < __atomic_sub_fetch(&storage->refs, 1, __ATOMIC_ACQ_REL)) {
+        return;
+    }
+
+    if (0 == storage->mapped) {
+        free(storage->data);
+    } else {
+        munmap(storage->data, storage->mapped);
+    }
+
+    if (-1 != storage->fd) {
+        close(storage->fd);
+    }
+
+    free(storage);
+}
+
+/**
+ * Take back ownership of shared storage once every slice of it has been cleaned up.
+ */
+static bool __buffer_reclaim (Buffer* buffer) {
+    if (0 != buffer->storage->mapped || buffer->storage->data != buffer->data ||
+        1 != __atomic_load_n(&buffer->storage->refs, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+
+    free(buffer->storage);
+
+    buffer->storage = NULL;
+
+    return true;
+}
+
+/**
+ * Resize the shared file mapping of a buffer along with its file.
+ */
+static bool __buffer_remap (Buffer* buffer, int64_t size) {
+    BufferStorage* storage = buffer->storage;
+    unsigned char* data;
+
+    // no page of the mapping may lie beyond the end of the file once it is written
+    if (0 != ftruncate(storage->fd, size)) {
+        return false;
+    }
+
+    data = mremap(storage->data, storage->mapped, size, MREMAP_MAYMOVE);
+
+    if (MAP_FAILED == data) {
+        return false;
+    }
+
+    storage->data   = data;
+    storage->mapped = size;
+    buffer->data    = data;
+    buffer->length  = buffer->length < size ? buffer->length : size;
+    buffer->size    = size;
+
+    return true;
+}
+
+/**
+ * Resize the mapped data a buffer owns, in place when the pages after it are free and otherwise by
+ * moving its pages, keeping huge data on a huge page boundary.
+ */
+static unsigned char* __buffer_remap_anonymous (Buffer* buffer, int64_t size) {
+    unsigned char* data = mremap(buffer->data, buffer->size, size, 0);
+    bool           huge = buffer->alloc & BUFFER_ALLOC_HUGE && __BUFFER_HUGE_SIZE <= size;
+    unsigned char* target;
+
+    if (MAP_FAILED == data && huge) {
+        // the pages are moved onto a mapping at a huge page boundary, which they replace
+        if (NULL == (target = __buffer_allocate(buffer->alloc, size))) {
+            return NULL;
+        }
+
+        data = mremap(buffer->data, buffer->size, size, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+
+        if (MAP_FAILED == data) {
+            munmap(target, size);
+
+            return NULL;
+        }
+    } else if (MAP_FAILED == data) {
+        if (MAP_FAILED == (data = mremap(buffer->data, buffer->size, size, MREMAP_MAYMOVE))) {
+            return NULL;
+        }
+    }
+
+#ifdef MADV_HUGEPAGE
+    // the pages an extension adds need the advice as well
+    if (huge) {
+        madvise(data, size, MADV_HUGEPAGE);
+    }
+#endif
+
+    return data;
+}
+
+/**
+ * Move the inline data of a small buffer onto the heap.
+ */
+static bool __buffer_spill (Buffer* buffer) {
+    unsigned char* data = malloc(buffer->size);
+
+    if (NULL == data) {
+        return false;
+    }
+
+    memcpy(data, buffer->data, buffer->length);
+
+    buffer->data = data;
+
+    return true;
+}
+
+/**
+ * Make room for a count of bytes after the data of a buffer, closing its gap first.
+ */
+static bool __buffer_tail (Buffer* buffer, int64_t length) {
+    __BUFFER_LINEARIZE(buffer);
+
+    if (__BUFFER_MAX_SIZE - buffer->length < length) {
+        return false;
+    }
+
+    return buffer->length + length <= buffer->size || __buffer_grow(buffer, buffer->length + length);
+}
+
+/**
+ * Append printf() formatted data onto the end of a buffer.
+ */
+static bool __buffer_append_vfmt (Buffer* buffer, char* format, va_list args) {
+    va_list copy;
+    int     length;
+
+    __BUFFER_LINEARIZE(buffer);
+
+    va_copy(copy, args);
+
+    length = vsnprintf((char*) buffer->data + buffer->length, buffer->size - buffer->length, format,
+                       copy);
+
+    va_end(copy);
+
+    if (0 > length) {
+        return false;
+    } else if (buffer->size - buffer->length <= length) {
+        // the terminator written by vsnprintf() needs a byte that is not counted in the length
+        if (!__buffer_tail(buffer, (int64_t) length + 1)) {
+            return false;
+        }
+
+        vsnprintf((char*) buffer->data + buffer->length, length + 1, format, args);
+    }
+
+    buffer->length += length;
+
+    return true;
+}
+
+/**
+ * Give a buffer that shares its storage data of its own, copying the data it refers to into a
+ * new allocation of the given size unless the storage can be reclaimed.
+ */
+static bool __buffer_unshare (Buffer* buffer, int64_t size) {
+    if (__buffer_reclaim(buffer)) {
+        return true;
+    }
+
+    int64_t        _size = __buffer_alloc_size(buffer->alloc, size);
+    unsigned char* data  = _size <= __BUFFER_INLINE_SIZE && 0 == buffer->alloc
+                           ? buffer->inline_data : __buffer_allocate(buffer->alloc, _size);
+
+    if (NULL == data) {
+        return false;
+    }
+
+    buffer->length = buffer->length < size ? buffer->length : size;
+
+    memcpy(data, buffer->data, buffer->length);
+    __buffer_release(buffer->storage);
+
+    buffer->data    = data;
+    buffer->size    = _size;
+    buffer->storage = NULL;
+
+    return true;
+}
+
+/**
+ * Indicate that a buffer may write its file mapping in place, as no slice refers to it.
+ */
+static bool __buffer_writable (Buffer* buffer) {
+    return buffer->storage->writable &&
+           1 == __atomic_load_n(&buffer->storage->refs, __ATOMIC_ACQUIRE);
+}
+
 // -------------------------------------------------------------------------------------------------
 // FUNCTIONS
 // -------------------------------------------------------------------------------------------------
 
-bool buffer_append (Buffer* buffer, unsigned char* data, int32_t length) {
+bool buffer_append (Buffer* buffer, unsigned char* data, int64_t length) {
     assert(NULL != buffer);
     assert(NULL != buffer->data);
     assert(0 < length);
 
-    if (buffer->size < buffer->length + length &&
-        !buffer_resize(buffer, buffer->length + length)) {
+    if (!__buffer_tail(buffer, length)) {
         return false;
     }
 
@@ -51,7 +397,7 @@ bool buffer_append (Buffer* buffer, unsigned char* data, int32_t length) {
     return true;
 }
 
-bool buffer_append_ts (Buffer* buffer, unsigned char* data, int32_t length) {
+bool buffer_append_ts (Buffer* buffer, unsigned char* data, int64_t length) {
     assert(NULL != buffer);
     assert(NULL != buffer->mutex);
 
@@ -64,6 +410,92 @@ bool buffer_append_ts (Buffer* buffer, unsigned char* data, int32_t length) {
     return ret;
 }
 
+bool buffer_append_f64 (Buffer* buffer, double value) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->data);
+
+    if (!__buffer_tail(buffer, FORMAT_F64_MAX)) {
+        return false;
+    }
+
+    buffer->length += format_f64((char*) buffer->data + buffer->length, value);
+
+    return true;
+}
+
+bool buffer_append_f64_ts (Buffer* buffer, double value) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->mutex);
+
+    pthread_mutex_lock(buffer->mutex);
+
+    bool ret = buffer_append_f64(buffer, value);
+
+    pthread_mutex_unlock(buffer->mutex);
+
+    return ret;
+}
+
+bool buffer_append_fmt (Buffer* buffer, char* format, ...) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->data);
+    assert(NULL != format);
+
+    va_list args;
+
+    va_start(args, format);
+
+    bool ret = __buffer_append_vfmt(buffer, format, args);
+
+    va_end(args);
+
+    return ret;
+}
+
+bool buffer_append_fmt_ts (Buffer* buffer, char* format, ...) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->mutex);
+    assert(NULL != format);
+
+    va_list args;
+
+    va_start(args, format);
+    pthread_mutex_lock(buffer->mutex);
+
+    bool ret = __buffer_append_vfmt(buffer, format, args);
+
+    pthread_mutex_unlock(buffer->mutex);
+    va_end(args);
+
+    return ret;
+}
+
+bool buffer_append_i64 (Buffer* buffer, int64_t value) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->data);
+
+    if (!__buffer_tail(buffer, FORMAT_I64_MAX)) {
+        return false;
+    }
+
+    buffer->length += format_i64((char*) buffer->data + buffer->length, value);
+
+    return true;
+}
+
+bool buffer_append_i64_ts (Buffer* buffer, int64_t value) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->mutex);
+
+    pthread_mutex_lock(buffer->mutex);
+
+    bool ret = buffer_append_i64(buffer, value);
+
+    pthread_mutex_unlock(buffer->mutex);
+
+    return ret;
+}
+
 bool buffer_append_str (Buffer* buffer, char* data) {
     return buffer_append(buffer, (unsigned char*) data, strlen((char*) data));
 }
@@ -72,27 +504,67 @@ bool buffer_append_str_ts (Buffer* buffer, char* data) {
     return buffer_append_ts(buffer, (unsigned char*) data, strlen((char*) data));
 }
 
+bool buffer_append_u64 (Buffer* buffer, uint64_t value) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->data);
+
+    if (!__buffer_tail(buffer, FORMAT_U64_MAX)) {
+        return false;
+    }
+
+    buffer->length += format_u64((char*) buffer->data + buffer->length, value);
+
+    return true;
+}
+
+bool buffer_append_u64_ts (Buffer* buffer, uint64_t value) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->mutex);
+
+    pthread_mutex_lock(buffer->mutex);
+
+    bool ret = buffer_append_u64(buffer, value);
+
+    pthread_mutex_unlock(buffer->mutex);
+
+    return ret;
+}
+
 bool buffer_cleanup (Buffer* buffer) {
     assert(NULL != buffer);
     assert(NULL != buffer->data);
 
-    free(buffer->data);
+    bool ret = true;
+
+    if (NULL != buffer->storage) {
+        if (-1 != buffer->storage->fd) {
+            // the file of a shared mapping is left with the data of the buffer
+            __BUFFER_LINEARIZE(buffer);
+
+            ret = 0 == ftruncate(buffer->storage->fd, buffer->length);
+        }
+
+        __buffer_release(buffer->storage);
+    } else {
+        __buffer_free(buffer);
+    }
 
     if (NULL != buffer->mutex) {
         pthread_mutex_destroy(buffer->mutex);
-        free(buffer->mutex);
     }
 
-    return true;
+    return ret;
 }
 
-Buffer* buffer_copy (Buffer* buffer, int32_t start, int32_t length) {
+Buffer* buffer_copy (Buffer* buffer, int64_t start, int64_t length) {
     assert(NULL != buffer);
     assert(NULL != buffer->data);
     assert(0 <= start);
     assert(0 < length);
     assert(start + length <= buffer->length);
 
+    __BUFFER_LINEARIZE(buffer);
+
     Buffer* copy = buffer_new();
 
     if (NULL == copy) {
@@ -111,7 +583,7 @@ Buffer* buffer_copy (Buffer* buffer, int32_t start, int32_t length) {
     return copy;
 }
 
-Buffer* buffer_copy_ts (Buffer* buffer, int32_t start, int32_t length) {
+Buffer* buffer_copy_ts (Buffer* buffer, int64_t start, int64_t length) {
     assert(NULL != buffer);
     assert(NULL != buffer->mutex);
 
@@ -128,6 +600,8 @@ void* buffer_data (Buffer* buffer) {
     assert(NULL != buffer);
     assert(NULL != buffer->data);
 
+    __BUFFER_LINEARIZE(buffer);
+
     return buffer->data;
 }
 
@@ -137,48 +611,77 @@ void* buffer_data_ts (Buffer* buffer) {
 
     pthread_mutex_lock(buffer->mutex);
 
-    void* ret = buffer->data;
+    void* ret = buffer_data(buffer);
 
     pthread_mutex_unlock(buffer->mutex);
 
     return ret;
 }
 
-int32_t buffer_indexof (Buffer* buffer, int32_t start, unsigned char* sequence, int32_t length) {
+int64_t buffer_indexof (Buffer* buffer, int64_t start, unsigned char* sequence, int64_t length) {
     assert(NULL != buffer);
 
+    __BUFFER_LINEARIZE(buffer);
+
     return chr_indexof(buffer->data, buffer->length, start, sequence, length);
 }
 
-int32_t buffer_indexof_ts (Buffer* buffer, int32_t start, unsigned char* sequence, int32_t length) {
+int64_t buffer_indexof_ts (Buffer* buffer, int64_t start, unsigned char* sequence, int64_t length) {
     assert(NULL != buffer);
     assert(NULL != buffer->mutex);
 
     pthread_mutex_lock(buffer->mutex);
 
-    int32_t ret = chr_indexof(buffer->data, buffer->length, start, sequence, length);
+    int64_t ret = buffer_indexof(buffer, start, sequence, length);
 
     pthread_mutex_unlock(buffer->mutex);
 
     return ret;
 }
 
-bool buffer_init (Buffer* buffer, int32_t size, bool thread_safe) {
+int64_t buffer_indexof_pattern (Buffer* buffer, int64_t start, SearchPattern* pattern) {
+    assert(NULL != buffer);
+
+    __BUFFER_LINEARIZE(buffer);
+
+    return chr_indexof_pattern(buffer->data, buffer->length, start, pattern);
+}
+
+int64_t buffer_indexof_pattern_ts (Buffer* buffer, int64_t start, SearchPattern* pattern) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->mutex);
+
+    pthread_mutex_lock(buffer->mutex);
+
+    int64_t ret = buffer_indexof_pattern(buffer, start, pattern);
+
+    pthread_mutex_unlock(buffer->mutex);
+
+    return ret;
+}
+
+bool buffer_init (Buffer* buffer, int64_t size, bool thread_safe) {
     assert(NULL != buffer);
     assert(NULL == buffer->data);
     assert(0 < size);
 
-    buffer->length = 0;
-    buffer->size   = __BUFFER_ALIGN_SIZE(size);
-    buffer->data   = malloc(buffer->size);
-    buffer->mutex  = NULL;
-
-    if (NULL == buffer->data) {
+    buffer->alloc   = 0;
+    buffer->gap     = -1;
+    buffer->gapped  = false;
+    buffer->growth  = __BUFFER_DEFAULT_GROWTH;
+    buffer->length  = 0;
+    buffer->size    = __buffer_alloc_size(0, size);
+    buffer->mutex   = NULL;
+    buffer->storage = NULL;
+
+    if (buffer->size <= __BUFFER_INLINE_SIZE) {
+        buffer->data = buffer->inline_data;
+    } else if (NULL == (buffer->data = __buffer_allocate(0, buffer->size))) {
         return false;
     }
 
     if (thread_safe) {
-        buffer->mutex = (pthread_mutex_t*) malloc(sizeof(pthread_mutex_t));
+        buffer->mutex = &buffer->inline_mutex;
 
         pthread_mutex_init(buffer->mutex, NULL);
     }
@@ -186,7 +689,7 @@ bool buffer_init (Buffer* buffer, int32_t size, bool thread_safe) {
     return true;
 }
 
-bool buffer_insert (Buffer* buffer, int32_t index, unsigned char* data, int32_t length) {
+bool buffer_insert (Buffer* buffer, int64_t index, unsigned char* data, int64_t length) {
     assert(NULL != buffer);
     assert(NULL != buffer->data);
     assert(0 < length);
@@ -194,29 +697,40 @@ bool buffer_insert (Buffer* buffer, int32_t index, unsigned char* data, int32_t
 
     if (index == buffer->length) {
         return buffer_append(buffer, data, length);
+    } else if (__BUFFER_MAX_SIZE - buffer->length < length) {
+        return false;
     }
 
-    if (buffer->size < buffer->length + length && !buffer_resize(buffer, buffer->length + length)) {
-        return false;
+    __BUFFER_UNSHARE(buffer);
+
+    if (buffer->size < buffer->length + length) {
+        __BUFFER_LINEARIZE(buffer);
+
+        if (!__buffer_grow(buffer, buffer->length + length)) {
+            return false;
+        }
     }
 
-    unsigned char* tmp = malloc(__BUFFER_ALIGN_SIZE(buffer->length - index));
+    if (buffer->gapped) {
+        // fill the front of the gap, leaving it just after the inserted data
+        __buffer_gap_move(buffer, index);
+        memcpy(buffer->data + index, data, length);
 
-    if (NULL == tmp) {
-        return false;
+        buffer->gap     = index + length;
+        buffer->length += length;
+
+        return true;
     }
 
-    memcpy(tmp, buffer->data + index, buffer->length - index);
-    memcpy(buffer->data + index + length, tmp, buffer->length - index);
+    memmove(buffer->data + index + length, buffer->data + index, buffer->length - index);
     memcpy(buffer->data + index, data, length);
-    free(tmp);
 
     buffer->length += length;
 
     return true;
 }
 
-bool buffer_insert_ts (Buffer* buffer, int32_t index, unsigned char* data, int32_t length) {
+bool buffer_insert_ts (Buffer* buffer, int64_t index, unsigned char* data, int64_t length) {
     assert(NULL != buffer);
     assert(NULL != buffer->mutex);
 
@@ -229,19 +743,19 @@ bool buffer_insert_ts (Buffer* buffer, int32_t index, unsigned char* data, int32
     return ret;
 }
 
-int32_t buffer_length (Buffer* buffer) {
+int64_t buffer_length (Buffer* buffer) {
     assert(NULL != buffer);
 
     return buffer->length;
 }
 
-int32_t buffer_length_ts (Buffer* buffer) {
+int64_t buffer_length_ts (Buffer* buffer) {
     assert(NULL != buffer);
     assert(NULL != buffer->mutex);
 
     pthread_mutex_lock(buffer->mutex);
 
-    int32_t ret = buffer->length;
+    int64_t ret = buffer->length;
 
     pthread_mutex_unlock(buffer->mutex);
 
@@ -255,6 +769,120 @@ void buffer_lock (Buffer* buffer) {
     pthread_mutex_lock(buffer->mutex);
 }
 
+Buffer* buffer_map (char* path, BufferMapMode mode, int32_t flags, bool thread_safe) {
+    Buffer* buffer = buffer_new();
+
+    if (NULL == buffer) {
+        return NULL;
+    } else if (!buffer_map_init(buffer, path, mode, flags, thread_safe)) {
+        free(buffer);
+
+        return NULL;
+    }
+
+    return buffer;
+}
+
+bool buffer_map_init (Buffer* buffer, char* path, BufferMapMode mode, int32_t flags,
+                      bool thread_safe) {
+    assert(NULL != buffer);
+    assert(NULL == buffer->data);
+    assert(NULL != path);
+
+    BufferStorage* storage = NULL;
+    unsigned char* data;
+    int            fd;
+    int64_t        page;
+    int64_t        size    = 0;
+    struct stat    st;
+
+    if (BUFFER_MAP_SHARED == mode) {
+        fd = open(path, O_RDWR | O_CREAT, 0644);
+    } else {
+        fd = open(path, O_RDONLY);
+    }
+
+    if (-1 == fd) {
+        return false;
+    } else if (0 != fstat(fd, &st) || __BUFFER_MAX_SIZE < st.st_size) {
+        close(fd);
+
+        return false;
+    } else if (0 == st.st_size && BUFFER_MAP_SHARED != mode) {
+        // an empty file has nothing to map
+        close(fd);
+
+        return buffer_init(buffer, 1, thread_safe);
+    }
+
+    size = 0 < st.st_size ? st.st_size : __BUFFER_CHUNK_SIZE;
+
+    // an empty file is given room to map, and truncated back to the length of the buffer later
+    if (size != st.st_size && 0 != ftruncate(fd, size)) {
+        close(fd);
+
+        return false;
+    }
+
+    data = mmap(NULL, size, BUFFER_MAP_READ == mode ? PROT_READ : PROT_READ | PROT_WRITE,
+                (BUFFER_MAP_SHARED == mode ? MAP_SHARED : MAP_PRIVATE) |
+                (flags & BUFFER_MAP_POPULATE ? MAP_POPULATE : 0), fd, 0);
+
+    // only a shared mapping needs its file descriptor, to resize the file
+    if (BUFFER_MAP_SHARED != mode) {
+        close(fd);
+
+        fd = -1;
+    }
+
+    if (MAP_FAILED == data || NULL == (storage = (BufferStorage*) malloc(sizeof(BufferStorage)))) {
+        if (MAP_FAILED != data) {
+            munmap(data, size);
+        }
+
+        if (-1 != fd) {
+            close(fd);
+        }
+
+        return false;
+    } else if (flags & BUFFER_MAP_SEQUENTIAL) {
+        madvise(data, size, MADV_SEQUENTIAL);
+    }
+
+    storage->data     = data;
+    storage->fd       = fd;
+    storage->mapped   = size;
+    storage->refs     = 1;
+    storage->writable = BUFFER_MAP_READ != mode;
+
+    buffer->alloc   = 0;
+    buffer->data    = data;
+    buffer->gap     = -1;
+    buffer->gapped  = false;
+    buffer->growth  = __BUFFER_DEFAULT_GROWTH;
+    buffer->length  = st.st_size;
+    buffer->mutex   = NULL;
+    buffer->storage = storage;
+
+    // appends to a read-only mapping must copy it, while a private mapping can be written up to
+    // the end of its last page
+    if (BUFFER_MAP_PRIVATE == mode) {
+        page         = sysconf(_SC_PAGESIZE);
+        size         = (size + page - 1) / page * page;
+        buffer->size = size;
+    } else {
+        buffer->size = size;
+    }
+
+    if (thread_safe) {
+        buffer->mutex = &buffer->inline_mutex;
+
+        pthread_mutex_init(buffer->mutex, NULL);
+    }
+
+    return true;
+}
+
 Buffer* buffer_new () {
     Buffer* buffer = (Buffer*) malloc(sizeof(Buffer));
 
@@ -267,14 +895,29 @@ Buffer* buffer_new () {
     return buffer;
 }
 
-bool buffer_remove (Buffer* buffer, int32_t start, int32_t length) {
+bool buffer_remove (Buffer* buffer, int64_t start, int64_t length) {
     assert(NULL != buffer);
     assert(NULL != buffer->data);
     assert(0 <= start);
     assert(0 < length);
     assert(start + length <= buffer->length);
 
-    int32_t move_length = buffer->length - (start + length);
+    __BUFFER_UNSHARE(buffer);
+
+    if (buffer->gapped) {
+        // once the gap moves to the start, the removed bytes directly follow it and join it
+        __buffer_gap_move(buffer, start);
+
+        buffer->length -= length;
+
+        if (buffer->gap == buffer->length) {
+            buffer->gap = -1;
+        }
+
+        return true;
+    }
+
+    int64_t move_length = buffer->length - (start + length);
 
     if (buffer->length == move_length) {
         buffer->length = 0;
@@ -282,14 +925,14 @@ bool buffer_remove (Buffer* buffer, int32_t start, int32_t length) {
         return true;
     }
 
-    memcpy(buffer->data + start, ((char*) buffer->data) + start + length, move_length);
+    memmove(buffer->data + start, buffer->data + start + length, move_length);
 
     buffer->length -= length;
 
     return true;
 }
 
-bool buffer_remove_ts (Buffer* buffer, int32_t start, int32_t length) {
+bool buffer_remove_ts (Buffer* buffer, int64_t start, int64_t length) {
     assert(NULL != buffer);
     assert(NULL != buffer->mutex);
 
@@ -302,43 +945,107 @@ bool buffer_remove_ts (Buffer* buffer, int32_t start, int32_t length) {
     return ret;
 }
 
-bool buffer_resize (Buffer* buffer, int32_t size) {
+bool buffer_reserve (Buffer* buffer, int64_t size) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->data);
+    assert(0 < size);
+
+    if (size <= buffer->size) {
+        return true;
+    }
+
+    return buffer_resize(buffer, size);
+}
+
+bool buffer_reserve_ts (Buffer* buffer, int64_t size) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->mutex);
+
+    pthread_mutex_lock(buffer->mutex);
+
+    bool ret = buffer_reserve(buffer, size);
+
+    pthread_mutex_unlock(buffer->mutex);
+
+    return ret;
+}
+
+bool buffer_resize (Buffer* buffer, int64_t size) {
     assert(NULL != buffer);
     assert(NULL != buffer->data);
     assert(0 < size);
 
-    if (0 == size) {
+    if (0 == size || __BUFFER_MAX_SIZE < size) {
         return false;
     }
 
-    int32_t        _size = __BUFFER_ALIGN_SIZE(size);
-    unsigned char* ptr   = realloc(buffer->data, _size);
+    __BUFFER_LINEARIZE(buffer);
+
+    int64_t        _size = __buffer_alloc_size(buffer->alloc, size);
+    bool           mapped;
+    unsigned char* ptr   = NULL;
+
+    if (NULL != buffer->storage) {
+        if (-1 != buffer->storage->fd && __buffer_writable(buffer)) {
+            return __buffer_remap(buffer, _size);
+        } else if (!__buffer_unshare(buffer, size)) {
+            return false;
+        } else if (_size == buffer->size) {
+            return true;
+        }
+    }
+
+    buffer->length = buffer->length < size ? buffer->length : size;
+
+    if (_size <= __BUFFER_INLINE_SIZE && 0 == buffer->alloc) {
+        // a buffer that shrinks small enough moves its data back inline
+        if (!__BUFFER_INLINE(buffer)) {
+            memcpy(buffer->inline_data, buffer->data, buffer->length);
+            __buffer_free(buffer);
+
+            buffer->data = buffer->inline_data;
+        }
+
+        buffer->size = _size;
+
+        return true;
+    }
+
+    mapped = __BUFFER_MAPPED(buffer->alloc, buffer->size);
+
+    if (__BUFFER_INLINE(buffer)) {
+        ptr = NULL;
+    } else if (mapped && __BUFFER_MAPPED(buffer->alloc, _size)) {
+        ptr = __buffer_remap_anonymous(buffer, _size);
+    } else if (!mapped && !__BUFFER_MAPPED(buffer->alloc, _size) &&
+               0 == (buffer->alloc & BUFFER_ALLOC_ALIGN64)) {
+        // realloc() does not keep an alignment
+        ptr = realloc(buffer->data, _size);
+    }
 
     if (NULL != ptr) {
-        buffer->data   = ptr;
-        buffer->length = (buffer->length < size) ? buffer->length : size;
-        buffer->size   = _size;
+        buffer->data = ptr;
+        buffer->size = _size;
 
         return true;
     }
 
-    ptr = malloc(_size);
+    ptr = __buffer_allocate(buffer->alloc, _size);
 
     if (NULL == ptr) {
         return false;
     }
 
     memcpy(ptr, buffer->data, buffer->length);
-    free(buffer->data);
+    __buffer_free(buffer);
 
-    buffer->data   = ptr;
-    buffer->length = (buffer->length < size) ? buffer->length : size;
-    buffer->size   = _size;
+    buffer->data = ptr;
+    buffer->size = _size;
 
     return true;
 }
 
-bool buffer_resize_ts (Buffer* buffer, int32_t size) {
+bool buffer_resize_ts (Buffer* buffer, int64_t size) {
     assert(NULL != buffer);
     assert(NULL != buffer->mutex);
 
@@ -351,30 +1058,187 @@ bool buffer_resize_ts (Buffer* buffer, int32_t size) {
     return ret;
 }
 
-int32_t buffer_size (Buffer* buffer) {
+bool buffer_set_alloc (Buffer* buffer, int32_t alloc) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->data);
+    assert(0 == (alloc & ~(BUFFER_ALLOC_ALIGN64 | BUFFER_ALLOC_PAGE | BUFFER_ALLOC_HUGE)));
+
+    unsigned char* data;
+    int64_t        size;
+
+    if (alloc == buffer->alloc) {
+        return true;
+    } else if (NULL != buffer->storage) {
+        // the storage frees its data the way it was allocated
+        return false;
+    }
+
+    __BUFFER_LINEARIZE(buffer);
+
+    size = __buffer_alloc_size(alloc, buffer->size);
+    data = __buffer_allocate(alloc, size);
+
+    if (NULL == data) {
+        return false;
+    }
+
+    memcpy(data, buffer->data, buffer->length);
+    __buffer_free(buffer);
+
+    buffer->alloc = alloc;
+    buffer->data  = data;
+    buffer->size  = size;
+
+    return true;
+}
+
+void buffer_set_gapped (Buffer* buffer, bool gapped) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->data);
+
+    __BUFFER_LINEARIZE(buffer);
+
+    buffer->gapped = gapped;
+}
+
+void buffer_set_growth (Buffer* buffer, float growth) {
+    assert(NULL != buffer);
+    assert(1.0 <= growth);
+
+    buffer->growth = growth;
+}
+
+bool buffer_shrink_to_fit (Buffer* buffer) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->data);
+
+    __BUFFER_LINEARIZE(buffer);
+
+    int64_t length = 0 < buffer->length ? buffer->length : 1;
+
+    if (__buffer_alloc_size(buffer->alloc, length) == buffer->size) {
+        return true;
+    }
+
+    return buffer_resize(buffer, length);
+}
+
+bool buffer_shrink_to_fit_ts (Buffer* buffer) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->mutex);
+
+    pthread_mutex_lock(buffer->mutex);
+
+    bool ret = buffer_shrink_to_fit(buffer);
+
+    pthread_mutex_unlock(buffer->mutex);
+
+    return ret;
+}
+
+int64_t buffer_size (Buffer* buffer) {
     assert(NULL != buffer);
 
     return buffer->size;
 }
 
-int32_t buffer_size_ts (Buffer* buffer) {
+int64_t buffer_size_ts (Buffer* buffer) {
     assert(NULL != buffer);
     assert(NULL != buffer->mutex);
 
     pthread_mutex_lock(buffer->mutex);
 
-    int32_t ret = buffer->size;
+    int64_t ret = buffer->size;
 
     pthread_mutex_unlock(buffer->mutex);
 
     return ret;
 }
 
+Buffer* buffer_slice (Buffer* buffer, int64_t start, int64_t length) {
+    Buffer* slice = buffer_new();
+
+    if (NULL == slice) {
+        return NULL;
+    } else if (!buffer_slice_init(slice, buffer, start, length)) {
+        free(slice);
+
+        return NULL;
+    }
+
+    return slice;
+}
+
+Buffer* buffer_slice_ts (Buffer* buffer, int64_t start, int64_t length) {
+    assert(NULL != buffer);
+    assert(NULL != buffer->mutex);
+
+    pthread_mutex_lock(buffer->mutex);
+
+    Buffer* ret = buffer_slice(buffer, start, length);
+
+    pthread_mutex_unlock(buffer->mutex);
+
+    return ret;
+}
+
+bool buffer_slice_init (Buffer* slice, Buffer* buffer, int64_t start, int64_t length) {
+    assert(NULL != slice);
+    assert(NULL == slice->data);
+    assert(NULL != buffer);
+    assert(NULL != buffer->data);
+    assert(0 <= start);
+    assert(0 < length);
+    assert(start + length <= buffer->length);
+
+    __BUFFER_LINEARIZE(buffer);
+
+    if (NULL != buffer->storage && -1 != buffer->storage->fd) {
+        // writes to the file must not be hidden from the slice
+        return false;
+    } else if (__BUFFER_INLINE(buffer) && !__buffer_spill(buffer)) {
+        // slices cannot refer to data that lives and dies with the buffer itself
+        return false;
+    } else if (NULL == buffer->storage) {
+        buffer->storage = (BufferStorage*) malloc(sizeof(BufferStorage));
+
+        if (NULL == buffer->storage) {
+            return false;
+        }
+
+        buffer->storage->data     = buffer->data;
+        buffer->storage->fd       = -1;
+        buffer->storage->mapped   = __BUFFER_MAPPED(buffer->alloc, buffer->size) ? buffer->size : 0;
+        buffer->storage->refs     = 1;
+        buffer->storage->writable = false;
+    }
+
+    __atomic_add_fetch(&buffer->storage->refs, 1, __ATOMIC_RELAXED);
+
+    slice->alloc   = buffer->alloc;
+    slice->data    = buffer->data + start;
+    slice->gap     = -1;
+    slice->gapped  = false;
+    slice->growth  = buffer->growth;
+    slice->length  = length;
+    slice->mutex   = NULL;
+    slice->size    = length;
+    slice->storage = buffer->storage;
+
+    return true;
+}
+
 void buffer_truncate (Buffer* buffer) {
     assert(NULL != buffer);
     assert(NULL != buffer->data);
 
+    buffer->gap    = -1;
     buffer->length = 0;
+
+    if (NULL != buffer->storage && !__buffer_writable(buffer) && !__buffer_reclaim(buffer)) {
+        // slices or a read-only mapping still refer to the data, so appends must not write over it
+        buffer->size = 0;
+    }
 }
 
 void buffer_truncate_ts (Buffer* buffer) {
@@ -0,0 +1,620 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "codebox/container/chain.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __CHAIN_FREE(__segment) \
+    ((__segment)->chunk->data == (__segment)->chunk->storage && \
+     1 == __atomic_load_n(&(__segment)->chunk->refs, __ATOMIC_ACQUIRE) \
+     ? (__segment)->chunk->size - (__segment)->offset - (__segment)->length \
+     : 0)
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Release a chunk, freeing it once it is no longer referenced.
+ */
+static void __chain_release (ChainChunk* chunk) {
+    if (0 < __atomic_sub_fetch(&chunk->refs, 1, __ATOMIC_ACQ_REL)) {
+        return;
+    }
+
+    if (NULL != chunk->free_func) {
+        chunk->free_func(chunk->data, chunk->context);
+    }
+
+    free(chunk);
+}
+
+/**
+ * Create a segment covering a new chunk. When data is NULL the chunk owns storage of the size.
+ */
+static ChainSegment* __chain_segment (unsigned char* data, int64_t size,
+                                      void (*free_func) (unsigned char* data, void* context),
+                                      void* context) {
+    ChainChunk*   chunk   = (ChainChunk*) malloc(sizeof(ChainChunk) + (NULL == data ? size : 0));
+    ChainSegment* segment = (ChainSegment*) malloc(sizeof(ChainSegment));
+
+    if (NULL == chunk || NULL == segment) {
+        free(chunk);
+        free(segment);
+
+        return NULL;
+    }
+
+    chunk->context   = context;
+    chunk->data      = NULL == data ? chunk->storage : data;
+    chunk->free_func = free_func;
+    chunk->refs      = 1;
+    chunk->size      = size;
+
+    segment->chunk  = chunk;
+    segment->length = NULL == data ? 0 : size;
+    segment->next   = NULL;
+    segment->offset = 0;
+
+    return segment;
+}
+
+/**
+ * Link a segment onto the end of a chain.
+ */
+static void __chain_link (Chain* chain, ChainSegment* segment) {
+    if (NULL == chain->tail) {
+        chain->head = segment;
+    } else {
+        chain->tail->next = segment;
+    }
+
+    chain->count++;
+    chain->length += segment->length;
+    chain->tail    = segment;
+}
+
+/**
+ * Make sure the free space at the end of a chain, including spare segments, covers a length.
+ */
+static bool __chain_spare (Chain* chain, int64_t length) {
+    ChainSegment* last    = NULL;
+    ChainSegment* segment = NULL;
+
+    length -= NULL == chain->tail ? 0 : __CHAIN_FREE(chain->tail);
+
+    for (segment = chain->spare; NULL != segment; segment = segment->next) {
+        length -= segment->chunk->size;
+        last    = segment;
+    }
+
+    if (0 >= length) {
+        return true;
+    }
+
+    segment = __chain_segment(NULL, length < __CHAIN_CHUNK_SIZE ? __CHAIN_CHUNK_SIZE : length,
+                              NULL, NULL);
+
+    if (NULL == segment) {
+        return false;
+    }
+
+    if (NULL == last) {
+        chain->spare = segment;
+    } else {
+        last->next = segment;
+    }
+
+    return true;
+}
+
+/**
+ * Append a length of data into the free space at the end of a chain, which must cover it. When
+ * data is NULL, the data has already been written into the free space.
+ */
+static void __chain_fill (Chain* chain, unsigned char* data, int64_t length) {
+    ChainSegment* segment = chain->tail;
+    int64_t       copy;
+
+    if (NULL != segment && 0 < (copy = __CHAIN_FREE(segment))) {
+        copy = copy < length ? copy : length;
+
+        if (NULL != data) {
+            memcpy(segment->chunk->data + segment->offset + segment->length, data, copy);
+
+            data += copy;
+        }
+
+        segment->length += copy;
+        chain->length   += copy;
+        length          -= copy;
+    }
+
+    while (0 < length) {
+        assert(NULL != chain->spare);
+
+        segment      = chain->spare;
+        chain->spare = segment->next;
+        copy         = segment->chunk->size < length ? segment->chunk->size : length;
+
+        if (NULL != data) {
+            memcpy(segment->chunk->data, data, copy);
+
+            data += copy;
+        }
+
+        segment->length = copy;
+        segment->next   = NULL;
+        length         -= copy;
+
+        __chain_link(chain, segment);
+    }
+}
+
+/**
+ * Free a list of segments.
+ */
+static void __chain_free (ChainSegment* segment) {
+    ChainSegment* next;
+
+    for (; NULL != segment; segment = next) {
+        next = segment->next;
+
+        __chain_release(segment->chunk);
+        free(segment);
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+bool chain_append (Chain* chain, unsigned char* data, int64_t length) {
+    assert(NULL != chain);
+    assert(NULL != data);
+    assert(0 < length);
+
+    if (!__chain_spare(chain, length)) {
+        return false;
+    }
+
+    __chain_fill(chain, data, length);
+
+    return true;
+}
+
+bool chain_append_ts (Chain* chain, unsigned char* data, int64_t length) {
+    assert(NULL != chain);
+    assert(NULL != chain->mutex);
+
+    pthread_mutex_lock(chain->mutex);
+
+    bool ret = chain_append(chain, data, length);
+
+    pthread_mutex_unlock(chain->mutex);
+
+    return ret;
+}
+
+bool chain_append_chain (Chain* chain, Chain* other) {
+    assert(NULL != chain);
+    assert(NULL != other);
+    assert(chain != other);
+
+    if (NULL == other->head) {
+        return true;
+    }
+
+    if (NULL == chain->tail) {
+        chain->head = other->head;
+    } else {
+        chain->tail->next = other->head;
+    }
+
+    chain->count  += other->count;
+    chain->length += other->length;
+    chain->tail    = other->tail;
+
+    other->count  = 0;
+    other->head   = NULL;
+    other->length = 0;
+    other->tail   = NULL;
+
+    return true;
+}
+
+bool chain_append_ref (Chain* chain, unsigned char* data, int64_t length,
+                       void (*free_func) (unsigned char* data, void* context), void* context) {
+    assert(NULL != chain);
+    assert(NULL != data);
+    assert(0 < length);
+
+    ChainSegment* segment = __chain_segment(data, length, free_func, context);
+
+    if (NULL == segment) {
+        return false;
+    }
+
+    __chain_link(chain, segment);
+
+    return true;
+}
+
+bool chain_append_ref_ts (Chain* chain, unsigned char* data, int64_t length,
+                          void (*free_func) (unsigned char* data, void* context), void* context) {
+    assert(NULL != chain);
+    assert(NULL != chain->mutex);
+
+    pthread_mutex_lock(chain->mutex);
+
+    bool ret = chain_append_ref(chain, data, length, free_func, context);
+
+    pthread_mutex_unlock(chain->mutex);
+
+    return ret;
+}
+
+bool chain_cleanup (Chain* chain) {
+    assert(NULL != chain);
+
+    __chain_free(chain->head);
+    __chain_free(chain->spare);
+
+    chain->count  = 0;
+    chain->head   = NULL;
+    chain->length = 0;
+    chain->spare  = NULL;
+    chain->tail   = NULL;
+
+    if (NULL != chain->mutex) {
+        pthread_mutex_destroy(chain->mutex);
+        free(chain->mutex);
+
+        chain->mutex = NULL;
+    }
+
+    return true;
+}
+
+void chain_commit (Chain* chain, int64_t length) {
+    assert(NULL != chain);
+    assert(0 <= length);
+
+    __chain_fill(chain, NULL, length);
+}
+
+int64_t chain_copyout (Chain* chain, unsigned char* data, int64_t length) {
+    assert(NULL != chain);
+    assert(NULL != data);
+    assert(0 <= length);
+
+    ChainSegment* segment = chain->head;
+    int64_t       copied  = 0;
+    int64_t       copy;
+
+    for (; NULL != segment && copied < length; segment = segment->next) {
+        copy = segment->length < length - copied ? segment->length : length - copied;
+
+        memcpy(data + copied, segment->chunk->data + segment->offset, copy);
+
+        copied += copy;
+    }
+
+    return copied;
+}
+
+bool chain_drain (Chain* chain, int64_t length) {
+    assert(NULL != chain);
+    assert(0 <= length);
+    assert(length <= chain->length);
+
+    ChainSegment* segment;
+
+    chain->length -= length;
+
+    while (0 < length) {
+        segment = chain->head;
+
+        if (length < segment->length) {
+            segment->length -= length;
+            segment->offset += length;
+
+            break;
+        }
+
+        chain->count--;
+        chain->head  = segment->next;
+        length      -= segment->length;
+
+        if (NULL == chain->head) {
+            chain->tail = NULL;
+        }
+
+        if (NULL == chain->spare && __CHAIN_CHUNK_SIZE == segment->chunk->size &&
+            segment->chunk->data == segment->chunk->storage &&
+            1 == __atomic_load_n(&segment->chunk->refs, __ATOMIC_ACQUIRE)) {
+            // keep one drained chunk for the next append, so steady streaming does not allocate
+            segment->length = 0;
+            segment->next   = NULL;
+            segment->offset = 0;
+            chain->spare    = segment;
+        } else {
+            __chain_release(segment->chunk);
+            free(segment);
+        }
+    }
+
+    return true;
+}
+
+bool chain_drain_ts (Chain* chain, int64_t length) {
+    assert(NULL != chain);
+    assert(NULL != chain->mutex);
+
+    pthread_mutex_lock(chain->mutex);
+
+    bool ret = chain_drain(chain, length);
+
+    pthread_mutex_unlock(chain->mutex);
+
+    return ret;
+}
+
+bool chain_init (Chain* chain, bool thread_safe) {
+    assert(NULL != chain);
+    assert(NULL == chain->head);
+
+    chain->count  = 0;
+    chain->head   = NULL;
+    chain->length = 0;
+    chain->mutex  = NULL;
+    chain->spare  = NULL;
+    chain->tail   = NULL;
+
+    if (thread_safe) {
+        chain->mutex = (pthread_mutex_t*) malloc(sizeof(pthread_mutex_t));
+
+        if (NULL == chain->mutex) {
+            return false;
+        }
+
+        pthread_mutex_init(chain->mutex, NULL);
+    }
+
+    return true;
+}
+
+int32_t chain_iovec (Chain* chain, struct iovec* iov, int32_t count) {
+    assert(NULL != chain);
+    assert(NULL != iov);
+    assert(0 <= count);
+
+    ChainSegment* segment = chain->head;
+    int32_t       i       = 0;
+
+    for (; NULL != segment && i < count; segment = segment->next, i++) {
+        iov[i].iov_base = segment->chunk->data + segment->offset;
+        iov[i].iov_len  = segment->length;
+    }
+
+    return i;
+}
+
+int64_t chain_length (Chain* chain) {
+    assert(NULL != chain);
+
+    return chain->length;
+}
+
+int64_t chain_length_ts (Chain* chain) {
+    assert(NULL != chain);
+    assert(NULL != chain->mutex);
+
+    pthread_mutex_lock(chain->mutex);
+
+    int64_t ret = chain_length(chain);
+
+    pthread_mutex_unlock(chain->mutex);
+
+    return ret;
+}
+
+void chain_lock (Chain* chain) {
+    assert(NULL != chain);
+    assert(NULL != chain->mutex);
+
+    pthread_mutex_lock(chain->mutex);
+}
+
+Chain* chain_new () {
+    Chain* chain = (Chain*) malloc(sizeof(Chain));
+
+    if (NULL == chain) {
+        return NULL;
+    }
+
+    memset(chain, 0, sizeof(Chain));
+
+    return chain;
+}
+
+bool chain_prepend (Chain* chain, unsigned char* data, int64_t length) {
+    assert(NULL != chain);
+    assert(NULL != data);
+    assert(0 < length);
+
+    ChainSegment* segment = __chain_segment(NULL, length, NULL, NULL);
+
+    if (NULL == segment) {
+        return false;
+    }
+
+    memcpy(segment->chunk->data, data, length);
+
+    segment->length = length;
+    segment->next   = chain->head;
+
+    if (NULL == chain->head) {
+        chain->tail = segment;
+    }
+
+    chain->count++;
+    chain->head    = segment;
+    chain->length += length;
+
+    return true;
+}
+
+bool chain_prepend_ref (Chain* chain, unsigned char* data, int64_t length,
+                        void (*free_func) (unsigned char* data, void* context), void* context) {
+    assert(NULL != chain);
+    assert(NULL != data);
+    assert(0 < length);
+
+    ChainSegment* segment = __chain_segment(data, length, free_func, context);
+
+    if (NULL == segment) {
+        return false;
+    }
+
+    segment->next = chain->head;
+
+    if (NULL == chain->head) {
+        chain->tail = segment;
+    }
+
+    chain->count++;
+    chain->head    = segment;
+    chain->length += length;
+
+    return true;
+}
+
+int32_t chain_reserve (Chain* chain, int64_t length, struct iovec* iov, int32_t count) {
+    assert(NULL != chain);
+    assert(0 < length);
+    assert(NULL != iov);
+    assert(0 < count);
+
+    ChainSegment* segment;
+    int32_t       i = 0;
+    int64_t       available;
+
+    if (!__chain_spare(chain, length)) {
+        return 0;
+    }
+
+    if (NULL != chain->tail && 0 < (available = __CHAIN_FREE(chain->tail))) {
+        iov[i].iov_base = chain->tail->chunk->data + chain->tail->offset + chain->tail->length;
+        iov[i].iov_len  = available < length ? available : length;
+        length         -= iov[i++].iov_len;
+    }
+
+    for (segment = chain->spare; NULL != segment && 0 < length && i < count;
+         segment = segment->next) {
+        iov[i].iov_base = segment->chunk->data;
+        iov[i].iov_len  = segment->chunk->size < length ? segment->chunk->size : length;
+        length         -= iov[i++].iov_len;
+    }
+
+    return i;
+}
+
+bool chain_split (Chain* chain, int64_t length, Chain* other) {
+    assert(NULL != chain);
+    assert(NULL != other);
+    assert(chain != other);
+    assert(0 <= length);
+
+    if (chain->length < length) {
+        return false;
+    }
+
+    ChainSegment* segment;
+    ChainSegment* split;
+
+    while (0 < length && length >= chain->head->length) {
+        segment      = chain->head;
+        chain->head  = segment->next;
+        length      -= segment->length;
+
+        if (NULL == chain->head) {
+            chain->tail = NULL;
+        }
+
+        chain->count--;
+        chain->length -= segment->length;
+        segment->next  = NULL;
+
+        __chain_link(other, segment);
+    }
+
+    if (0 == length) {
+        return true;
+    }
+
+    // the split falls inside the first segment, so both chains share its chunk
+    if (NULL == (split = (ChainSegment*) malloc(sizeof(ChainSegment)))) {
+        return false;
+    }
+
+    segment = chain->head;
+
+    __atomic_add_fetch(&segment->chunk->refs, 1, __ATOMIC_RELAXED);
+
+    split->chunk  = segment->chunk;
+    split->length = length;
+    split->next   = NULL;
+    split->offset = segment->offset;
+
+    segment->length -= length;
+    segment->offset += length;
+    chain->length   -= length;
+
+    __chain_link(other, split);
+
+    return true;
+}
+
+bool chain_to_buffer (Chain* chain, Buffer* buffer) {
+    assert(NULL != chain);
+    assert(NULL != buffer);
+
+    ChainSegment* segment = chain->head;
+    int64_t       length  = buffer->length;
+
+    if (INT64_MAX - buffer->length < chain->length) {
+        return false;
+    }
+
+    for (; NULL != segment; segment = segment->next) {
+        if (!buffer_append(buffer, segment->chunk->data + segment->offset, segment->length)) {
+            // the first append made the buffer contiguous, so the segments already appended are
+            // taken back off its end
+            buffer->length = length;
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void chain_unlock (Chain* chain) {
+    assert(NULL != chain);
+    assert(NULL != chain->mutex);
+
+    pthread_mutex_unlock(chain->mutex);
+}
@@ -0,0 +1,814 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "codebox/container/cuckoo.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __CUCKOO_MAX_ATTEMPTS 16
+#define __CUCKOO_MAX_PATH     64
+
+#define __CUCKOO_LO 0x0101010101010101ULL
+#define __CUCKOO_HI 0x8080808080808080ULL
+
+// the mask of the slots of a bucket, whose tag word has spare bytes that always read as empty
+#define __CUCKOO_SLOT_MASK ((1U << __CUCKOO_BUCKET_SLOTS) - 1)
+
+// the alternate bucket is never the primary one, as long as there are at least two buckets
+#define __CUCKOO_ALT(__array, __index, __tag) \
+    (((__index) ^ (((uint64_t) (__tag) * 0x5bd1e995) | 1)) & (__array)->mask)
+
+#define __CUCKOO_TAG(__hash) \
+    (0 == ((__hash) >> 24) ? 1 : (uint8_t) ((__hash) >> 24))
+
+#define __CUCKOO_TAG_AT(__tags, __slot) \
+    ((uint8_t) ((__tags) >> ((__slot) * 8)))
+
+// cuckoo placement needs well mixed bits, so hashcodes are passed through the murmur3 finalizer
+#define __CUCKOO_HASH(__cuckoo, __key, __length) \
+    __cuckoo_mix((__cuckoo)->hash_func(__key, __length))
+
+#define __CUCKOO_LOAD(__ptr) \
+    __atomic_load_n(__ptr, __ATOMIC_RELAXED)
+
+#define __CUCKOO_STORE(__ptr, __value) \
+    __atomic_store_n(__ptr, __value, __ATOMIC_RELAXED)
+
+#define __CUCKOO_ENTRY(__array, __index) \
+    ((__array)->buckets[(__index) / __CUCKOO_BUCKET_SLOTS].entries[(__index) % \
+                                                                   __CUCKOO_BUCKET_SLOTS])
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Allocate an empty bucket array with at least the given bucket count.
+ */
+static CuckooArray* __cuckoo_array_new (int64_t bucket_count) {
+    uint64_t count = 2;
+
+    for (; (int64_t) count < bucket_count; count <<= 1);
+
+    CuckooArray* array = (CuckooArray*) malloc(sizeof(CuckooArray));
+
+    if (NULL == array) {
+        return NULL;
+    }
+
+    array->mask    = count - 1;
+    array->retired = NULL;
+
+    if (0 != posix_memalign((void**) &array->buckets, __CUCKOO_CACHE_LINE,
+                            count * sizeof(CuckooBucket))) {
+        free(array);
+
+        return NULL;
+    }
+
+    memset(array->buckets, 0, count * sizeof(CuckooBucket));
+
+    return array;
+}
+
+/**
+ * Free a bucket array along with every array it retired. The entries are not freed.
+ */
+static void __cuckoo_array_free (CuckooArray* array) {
+    while (NULL != array) {
+        CuckooArray* retired = array->retired;
+
+        free(array->buckets);
+        free(array);
+
+        array = retired;
+    }
+}
+
+/**
+ * Free a list of removed entries.
+ */
+static void __cuckoo_entry_free_list (CuckooEntry* entry) {
+    CuckooEntry* next;
+
+    for (; NULL != entry; entry = next) {
+        next = entry->next;
+
+        free(entry);
+    }
+}
+
+/**
+ * Create an entry holding a copy of a key.
+ */
+static CuckooEntry* __cuckoo_entry_new (uint32_t hash, unsigned char* key, int32_t length,
+                                        void* value) {
+    CuckooEntry* entry = (CuckooEntry*) malloc(sizeof(CuckooEntry) + length);
+
+    if (NULL == entry) {
+        return NULL;
+    }
+
+    memcpy(entry->key, key, length);
+
+    entry->hashcode = hash;
+    entry->length   = length;
+    entry->next     = NULL;
+    entry->value    = value;
+
+    return entry;
+}
+
+/**
+ * Mix the bits of a hashcode.
+ */
+static uint32_t __cuckoo_mix (uint32_t hash) {
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+/**
+ * Retrieve a mask with bit n set for every slot n of the first bucket whose tag matches, and bit
+ * 8 + n for every slot n of the second.
+ */
+static uint32_t __cuckoo_match (uint64_t tags1, uint64_t tags2, uint8_t tag) {
+#ifdef __SSE2__
+    __m128i eq = _mm_cmpeq_epi8(_mm_set_epi64x((long long) tags2, (long long) tags1),
+                                _mm_set1_epi8((char) tag));
+
+    return (uint32_t) _mm_movemask_epi8(eq);
+#else
+    uint64_t x1   = tags1 ^ (__CUCKOO_LO * tag);
+    uint64_t x2   = tags2 ^ (__CUCKOO_LO * tag);
+    uint64_t z1   = ~((((x1 & ~__CUCKOO_HI) + ~__CUCKOO_HI) | x1) | ~__CUCKOO_HI);
+    uint64_t z2   = ~((((x2 & ~__CUCKOO_HI) + ~__CUCKOO_HI) | x2) | ~__CUCKOO_HI);
+    uint32_t mask = 0;
+
+    for (int32_t i = 0; i < 8; i++) {
+        mask |= (uint32_t) ((z1 >> (i * 8 + 7)) & 1) << i;
+        mask |= (uint32_t) ((z2 >> (i * 8 + 7)) & 1) << (i + 8);
+    }
+
+    return mask;
+#endif
+}
+
+/**
+ * Retrieve the slot index holding a key, or -1 if the key is not present.
+ *
+ * Only the lines of the two candidate buckets are read before the entry of a tag that matches.
+ * An entry is compared by its own copy of the key, which a concurrent writer never modifies, and
+ * a slot that was emptied meanwhile reads as NULL.
+ */
+static int64_t __cuckoo_find (Cuckoo* cuckoo, CuckooArray* array, uint32_t hash,
+                              unsigned char* key, int32_t length) {
+    uint8_t  tag  = __CUCKOO_TAG(hash);
+    uint64_t i1   = hash & array->mask;
+    uint64_t i2   = __CUCKOO_ALT(array, i1, tag);
+    uint32_t mask = __cuckoo_match(__CUCKOO_LOAD(&array->buckets[i1].tags),
+                                   __CUCKOO_LOAD(&array->buckets[i2].tags), tag);
+
+    for (; 0 != mask; mask &= mask - 1) {
+        int32_t      bit   = __builtin_ctz(mask);
+        uint64_t     index = (bit < 8 ? i1 : i2) * __CUCKOO_BUCKET_SLOTS + (bit & 7);
+        CuckooEntry* entry = __atomic_load_n(&__CUCKOO_ENTRY(array, index), __ATOMIC_ACQUIRE);
+
+        if (NULL != entry && entry->hashcode == hash &&
+            cuckoo->comp_func(entry->key, entry->length, key, length)) {
+            return (int64_t) index;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Retrieve the first empty slot in a bucket, or -1 if the bucket is full.
+ */
+static int32_t __cuckoo_empty (CuckooArray* array, uint64_t bucket) {
+    uint32_t mask = __cuckoo_match(array->buckets[bucket].tags, 0, 0) & __CUCKOO_SLOT_MASK;
+
+    return 0 == mask ? -1 : __builtin_ctz(mask);
+}
+
+/**
+ * Enter the current epoch as an optimistic reader, so entries removed meanwhile are not freed.
+ */
+static uint64_t __cuckoo_pin (Cuckoo* cuckoo) {
+    for (;;) {
+        uint64_t epoch = __atomic_load_n(&cuckoo->epoch, __ATOMIC_SEQ_CST);
+
+        __atomic_fetch_add(cuckoo->readers + (epoch & 1), 1, __ATOMIC_SEQ_CST);
+
+        // a reader counted against an epoch that has since ended could see entries the writer is
+        // about to free, so it enters again
+        if (epoch == __atomic_load_n(&cuckoo->epoch, __ATOMIC_SEQ_CST)) {
+            return epoch;
+        }
+
+        __atomic_fetch_sub(cuckoo->readers + (epoch & 1), 1, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * Retrieve the next pseudo-random number.
+ */
+static uint64_t __cuckoo_random (Cuckoo* cuckoo) {
+    cuckoo->seed ^= cuckoo->seed << 13;
+    cuckoo->seed ^= cuckoo->seed >> 7;
+    cuckoo->seed ^= cuckoo->seed << 17;
+
+    return cuckoo->seed;
+}
+
+/**
+ * Free the entries removed two epochs ago once their readers have left, and advance the epoch.
+ *
+ * A reader of the previous epoch entered before the entries removed in it were unlinked, and one
+ * of the current epoch may still hold entries removed in the previous one. The previous epoch's
+ * entries are freed once its readers are gone, which is also what lets the epoch advance.
+ */
+static void __cuckoo_reclaim (Cuckoo* cuckoo) {
+    uint64_t epoch    = cuckoo->epoch;
+    int32_t  previous = (int32_t) ((epoch + 1) & 1);
+
+    if ((NULL == cuckoo->removed[0] && NULL == cuckoo->removed[1]) ||
+        0 != __atomic_load_n(cuckoo->readers + previous, __ATOMIC_SEQ_CST)) {
+        return;
+    }
+
+    __cuckoo_entry_free_list(cuckoo->removed[previous]);
+
+    cuckoo->removed[previous] = NULL;
+
+    __atomic_store_n(&cuckoo->epoch, epoch + 1, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * Leave the epoch entered by an optimistic reader.
+ */
+static void __cuckoo_unpin (Cuckoo* cuckoo, uint64_t epoch) {
+    __atomic_fetch_sub(cuckoo->readers + (epoch & 1), 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Mark the start or end of a write to two buckets, for versioned arrays.
+ */
+static void __cuckoo_version (CuckooArray* array, uint64_t bucket1, uint64_t bucket2,
+                              bool start) {
+    uint64_t* v1 = &array->buckets[bucket1].version;
+    uint64_t* v2 = &array->buckets[bucket2].version;
+
+    if (start) {
+        __CUCKOO_STORE(v1, *v1 + 1);
+
+        if (v1 != v2) {
+            __CUCKOO_STORE(v2, *v2 + 1);
+        }
+
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    } else {
+        __atomic_store_n(v1, *v1 + 1, __ATOMIC_RELEASE);
+
+        if (v1 != v2) {
+            __atomic_store_n(v2, *v2 + 1, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+/**
+ * Write an entry into a slot, or empty the slot when the entry is NULL.
+ */
+static void __cuckoo_write (CuckooArray* array, uint64_t bucket, int32_t slot,
+                            CuckooEntry* entry) {
+    CuckooBucket* dst  = array->buckets + bucket;
+    uint64_t      tags = dst->tags & ~(0xFFULL << (slot * 8));
+
+    if (NULL != entry) {
+        tags |= (uint64_t) __CUCKOO_TAG(entry->hashcode) << (slot * 8);
+    }
+
+    // the entry is published with a release, so a reader that loads it sees its key initialized
+    __atomic_store_n(&dst->entries[slot], entry, __ATOMIC_RELEASE);
+    __CUCKOO_STORE(&dst->tags, tags);
+}
+
+/**
+ * Insert an entry into an array without checking for an existing key.
+ *
+ * When the array is versioned, every displacement copies an entry into its alternate bucket
+ * before emptying its old slot, so concurrent readers always find it in one of its buckets.
+ */
+static bool __cuckoo_insert (Cuckoo* cuckoo, CuckooArray* array, CuckooEntry* entry,
+                             bool versioned) {
+    uint64_t buckets[__CUCKOO_MAX_PATH + 1];
+    int32_t  slots[__CUCKOO_MAX_PATH];
+    uint8_t  tag    = __CUCKOO_TAG(entry->hashcode);
+    uint64_t i1     = entry->hashcode & array->mask;
+    uint64_t i2     = __CUCKOO_ALT(array, i1, tag);
+    uint64_t bucket = i1;
+    int32_t  slot   = __cuckoo_empty(array, i1);
+
+    if (-1 == slot) {
+        bucket = i2;
+        slot   = __cuckoo_empty(array, i2);
+    }
+
+    if (-1 != slot) {
+        if (versioned) {
+            __cuckoo_version(array, bucket, bucket, true);
+        }
+
+        __cuckoo_write(array, bucket, slot, entry);
+
+        if (versioned) {
+            __cuckoo_version(array, bucket, bucket, false);
+        }
+
+        return true;
+    }
+
+    for (int32_t attempt = 0; attempt < __CUCKOO_MAX_ATTEMPTS; attempt++) {
+        int32_t depth = 0;
+        bool    found = false;
+
+        buckets[0] = (__cuckoo_random(cuckoo) & 1) ? i1 : i2;
+
+        // search for a path of displacements ending in an empty slot, without modifying anything
+        while (!found && depth < __CUCKOO_MAX_PATH) {
+            uint64_t bucket = buckets[depth];
+            int32_t  victim = __cuckoo_random(cuckoo) % __CUCKOO_BUCKET_SLOTS;
+            uint64_t next   = __CUCKOO_ALT(array, bucket,
+                                           __CUCKOO_TAG_AT(array->buckets[bucket].tags, victim));
+            bool     cycle  = false;
+
+            for (int32_t i = 0; i <= depth; i++) {
+                cycle |= buckets[i] == next;
+            }
+
+            if (cycle) {
+                break;
+            }
+
+            slots[depth]     = victim;
+            buckets[++depth] = next;
+            found            = -1 != __cuckoo_empty(array, next);
+        }
+
+        if (!found) {
+            continue;
+        }
+
+        // walk the path backwards, moving each victim into the slot freed ahead of it
+        for (int32_t i = depth - 1; 0 <= i; i--) {
+            int32_t empty = __cuckoo_empty(array, buckets[i + 1]);
+
+            if (versioned) {
+                __cuckoo_version(array, buckets[i], buckets[i + 1], true);
+            }
+
+            __cuckoo_write(array, buckets[i + 1], empty,
+                           array->buckets[buckets[i]].entries[slots[i]]);
+            __cuckoo_write(array, buckets[i], slots[i], NULL);
+
+            if (versioned) {
+                __cuckoo_version(array, buckets[i], buckets[i + 1], false);
+            }
+        }
+
+        if (versioned) {
+            __cuckoo_version(array, buckets[0], buckets[0], true);
+        }
+
+        __cuckoo_write(array, buckets[0], slots[0], entry);
+
+        if (versioned) {
+            __cuckoo_version(array, buckets[0], buckets[0], false);
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+int64_t cuckoo_bucket_count (Cuckoo* cuckoo) {
+    assert(NULL != cuckoo);
+    assert(NULL != cuckoo->array);
+
+    return (int64_t) cuckoo->array->mask + 1;
+}
+
+bool cuckoo_cleanup (Cuckoo* cuckoo) {
+    assert(NULL != cuckoo);
+    assert(NULL != cuckoo->array);
+
+    CuckooArray* array = cuckoo->array;
+
+    // retired arrays only hold entries that are also in the current array or were removed
+    for (uint64_t i = 0; i < (array->mask + 1) * __CUCKOO_BUCKET_SLOTS; i++) {
+        if (0 != __CUCKOO_TAG_AT(array->buckets[i / __CUCKOO_BUCKET_SLOTS].tags,
+                                 i % __CUCKOO_BUCKET_SLOTS)) {
+            free(__CUCKOO_ENTRY(array, i));
+        }
+    }
+
+    __cuckoo_array_free(array);
+    __cuckoo_entry_free_list(cuckoo->removed[0]);
+    __cuckoo_entry_free_list(cuckoo->removed[1]);
+
+    cuckoo->array      = NULL;
+    cuckoo->removed[0] = NULL;
+    cuckoo->removed[1] = NULL;
+
+    if (NULL != cuckoo->mutex) {
+        pthread_mutex_destroy(cuckoo->mutex);
+        free(cuckoo->mutex);
+    }
+
+    return true;
+}
+
+void* cuckoo_get (Cuckoo* cuckoo, unsigned char* key, int32_t length) {
+    assert(NULL != cuckoo);
+    assert(NULL != key);
+    assert(0 < length);
+
+    int64_t index = __cuckoo_find(cuckoo, cuckoo->array, __CUCKOO_HASH(cuckoo, key, length),
+                                  key, length);
+
+    return -1 != index ? __CUCKOO_ENTRY(cuckoo->array, index)->value : NULL;
+}
+
+void* cuckoo_get_ts (Cuckoo* cuckoo, unsigned char* key, int32_t length) {
+    assert(NULL != cuckoo);
+    assert(NULL != cuckoo->mutex);
+    assert(NULL != key);
+    assert(0 < length);
+
+    uint32_t hash  = __CUCKOO_HASH(cuckoo, key, length);
+    uint8_t  tag   = __CUCKOO_TAG(hash);
+    uint64_t epoch = __cuckoo_pin(cuckoo);
+
+    for (;;) {
+        CuckooArray* array = __atomic_load_n(&cuckoo->array, __ATOMIC_ACQUIRE);
+        uint64_t     i1    = hash & array->mask;
+        uint64_t*    s1    = &array->buckets[i1].version;
+        uint64_t*    s2    = &array->buckets[__CUCKOO_ALT(array, i1, tag)].version;
+        uint64_t     v1    = __atomic_load_n(s1, __ATOMIC_ACQUIRE);
+        uint64_t     v2    = __atomic_load_n(s2, __ATOMIC_ACQUIRE);
+        void*        value = NULL;
+
+        if ((v1 | v2) & 1) {
+            continue;
+        }
+
+        int64_t index = __cuckoo_find(cuckoo, array, hash, key, length);
+
+        if (-1 != index) {
+            CuckooEntry* entry = __atomic_load_n(&__CUCKOO_ENTRY(array, index), __ATOMIC_ACQUIRE);
+
+            value = NULL == entry ? NULL : __atomic_load_n(&entry->value, __ATOMIC_ACQUIRE);
+        }
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (v1 == __CUCKOO_LOAD(s1) && v2 == __CUCKOO_LOAD(s2) &&
+            array == __CUCKOO_LOAD(&cuckoo->array)) {
+            __cuckoo_unpin(cuckoo, epoch);
+
+            return value;
+        }
+    }
+}
+
+bool cuckoo_has_key (Cuckoo* cuckoo, unsigned char* key, int32_t length) {
+    assert(NULL != cuckoo);
+    assert(NULL != key);
+    assert(0 < length);
+
+    return -1 != __cuckoo_find(cuckoo, cuckoo->array, __CUCKOO_HASH(cuckoo, key, length),
+                               key, length);
+}
+
+bool cuckoo_has_key_ts (Cuckoo* cuckoo, unsigned char* key, int32_t length) {
+    assert(NULL != cuckoo);
+    assert(NULL != cuckoo->mutex);
+    assert(NULL != key);
+    assert(0 < length);
+
+    uint32_t hash  = __CUCKOO_HASH(cuckoo, key, length);
+    uint8_t  tag   = __CUCKOO_TAG(hash);
+    uint64_t epoch = __cuckoo_pin(cuckoo);
+
+    for (;;) {
+        CuckooArray* array = __atomic_load_n(&cuckoo->array, __ATOMIC_ACQUIRE);
+        uint64_t     i1    = hash & array->mask;
+        uint64_t*    s1    = &array->buckets[i1].version;
+        uint64_t*    s2    = &array->buckets[__CUCKOO_ALT(array, i1, tag)].version;
+        uint64_t     v1    = __atomic_load_n(s1, __ATOMIC_ACQUIRE);
+        uint64_t     v2    = __atomic_load_n(s2, __ATOMIC_ACQUIRE);
+
+        if ((v1 | v2) & 1) {
+            continue;
+        }
+
+        bool ret = -1 != __cuckoo_find(cuckoo, array, hash, key, length);
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (v1 == __CUCKOO_LOAD(s1) && v2 == __CUCKOO_LOAD(s2) &&
+            array == __CUCKOO_LOAD(&cuckoo->array)) {
+            __cuckoo_unpin(cuckoo, epoch);
+
+            return ret;
+        }
+    }
+}
+
+bool cuckoo_init (Cuckoo* cuckoo, int64_t bucket_count,
+                  bool (*comp_func) (unsigned char* key1, int32_t length1,
+                                     unsigned char* key2, int32_t length2),
+                  uint32_t (*hash_func) (unsigned char* key, int32_t length),
+                  bool thread_safe) {
+    assert(NULL != cuckoo);
+    assert(NULL == cuckoo->array);
+    assert(NULL != comp_func);
+    assert(NULL != hash_func);
+    assert(0 < bucket_count);
+
+    cuckoo->array = __cuckoo_array_new(bucket_count);
+
+    if (NULL == cuckoo->array) {
+        return false;
+    }
+
+    cuckoo->comp_func  = comp_func;
+    cuckoo->epoch      = 0;
+    cuckoo->hash_func  = hash_func;
+    cuckoo->key_count  = 0;
+    cuckoo->mutex      = NULL;
+    cuckoo->readers[0] = 0;
+    cuckoo->readers[1] = 0;
+    cuckoo->removed[0] = NULL;
+    cuckoo->removed[1] = NULL;
+    cuckoo->seed       = 0x9E3779B97F4A7C15ULL;
+
+    if (thread_safe) {
+        cuckoo->mutex = (pthread_mutex_t*) malloc(sizeof(pthread_mutex_t));
+
+        if (NULL == cuckoo->mutex) {
+            __cuckoo_array_free(cuckoo->array);
+
+            cuckoo->array = NULL;
+
+            return false;
+        }
+
+        pthread_mutex_init(cuckoo->mutex, NULL);
+    }
+
+    return true;
+}
+
+bool cuckoo_init_defaults (Cuckoo* cuckoo) {
+    return cuckoo_init(cuckoo,
+                       __CUCKOO_DEFAULT_BUCKET_COUNT,
+                       __CUCKOO_DEFAULT_COMP_FUNC,
+                       __CUCKOO_DEFAULT_HASH_FUNC,
+                       false);
+}
+
+bool cuckoo_init_defaults_ts (Cuckoo* cuckoo) {
+    return cuckoo_init(cuckoo,
+                       __CUCKOO_DEFAULT_BUCKET_COUNT,
+                       __CUCKOO_DEFAULT_COMP_FUNC,
+                       __CUCKOO_DEFAULT_HASH_FUNC,
+                       true);
+}
+
+int64_t cuckoo_key_count (Cuckoo* cuckoo) {
+    assert(NULL != cuckoo);
+
+    return cuckoo->key_count;
+}
+
+int64_t cuckoo_key_count_ts (Cuckoo* cuckoo) {
+    assert(NULL != cuckoo);
+    assert(NULL != cuckoo->mutex);
+
+    pthread_mutex_lock(cuckoo->mutex);
+
+    int64_t ret = cuckoo->key_count;
+
+    pthread_mutex_unlock(cuckoo->mutex);
+
+    return ret;
+}
+
+void cuckoo_lock (Cuckoo* cuckoo) {
+    assert(NULL != cuckoo);
+    assert(NULL != cuckoo->mutex);
+
+    pthread_mutex_lock(cuckoo->mutex);
+}
+
+Cuckoo* cuckoo_new () {
+    Cuckoo* cuckoo = (Cuckoo*) malloc(sizeof(Cuckoo));
+
+    if (NULL == cuckoo) {
+        return NULL;
+    }
+
+    memset(cuckoo, 0, sizeof(Cuckoo));
+
+    return cuckoo;
+}
+
+bool cuckoo_put (Cuckoo* cuckoo, unsigned char* key, int32_t length, void* value) {
+    assert(NULL != cuckoo);
+    assert(NULL != key);
+    assert(0 < length);
+
+    uint32_t     hash  = __CUCKOO_HASH(cuckoo, key, length);
+    int64_t      index = __cuckoo_find(cuckoo, cuckoo->array, hash, key, length);
+    CuckooEntry* entry;
+
+    if (-1 != index) {
+        __atomic_store_n(&__CUCKOO_ENTRY(cuckoo->array, index)->value, value, __ATOMIC_RELEASE);
+
+        return true;
+    }
+
+    if (NULL == (entry = __cuckoo_entry_new(hash, key, length, value))) {
+        return false;
+    }
+
+    while (!__cuckoo_insert(cuckoo, cuckoo->array, entry, NULL != cuckoo->mutex)) {
+        if (!cuckoo_resize(cuckoo, (int64_t) (cuckoo->array->mask + 1) * 2)) {
+            free(entry);
+
+            return false;
+        }
+    }
+
+    cuckoo->key_count++;
+
+    return true;
+}
+
+bool cuckoo_put_ts (Cuckoo* cuckoo, unsigned char* key, int32_t length, void* value) {
+    assert(NULL != cuckoo);
+    assert(NULL != cuckoo->mutex);
+
+    pthread_mutex_lock(cuckoo->mutex);
+
+    bool ret = cuckoo_put(cuckoo, key, length, value);
+
+    pthread_mutex_unlock(cuckoo->mutex);
+
+    return ret;
+}
+
+void* cuckoo_remove (Cuckoo* cuckoo, unsigned char* key, int32_t length) {
+    assert(NULL != cuckoo);
+    assert(NULL != key);
+    assert(0 < length);
+
+    CuckooArray* array = cuckoo->array;
+    int64_t      index = __cuckoo_find(cuckoo, array, __CUCKOO_HASH(cuckoo, key, length),
+                                       key, length);
+
+    if (-1 == index) {
+        return NULL;
+    }
+
+    uint64_t     bucket = index / __CUCKOO_BUCKET_SLOTS;
+    CuckooEntry* entry  = __CUCKOO_ENTRY(array, index);
+    void*        value  = entry->value;
+
+    cuckoo->key_count--;
+
+    if (NULL == cuckoo->mutex) {
+        __cuckoo_write(array, bucket, index % __CUCKOO_BUCKET_SLOTS, NULL);
+        free(entry);
+
+        return value;
+    }
+
+    __cuckoo_version(array, bucket, bucket, true);
+    __cuckoo_write(array, bucket, index % __CUCKOO_BUCKET_SLOTS, NULL);
+    __cuckoo_version(array, bucket, bucket, false);
+
+    // optimistic readers may still be comparing the key of the entry, so it waits for them
+    entry->next                         = cuckoo->removed[cuckoo->epoch & 1];
+    cuckoo->removed[cuckoo->epoch & 1] = entry;
+
+    __cuckoo_reclaim(cuckoo);
+
+    return value;
+}
+
+void* cuckoo_remove_ts (Cuckoo* cuckoo, unsigned char* key, int32_t length) {
+    assert(NULL != cuckoo);
+    assert(NULL != cuckoo->mutex);
+
+    pthread_mutex_lock(cuckoo->mutex);
+
+    void* ret = cuckoo_remove(cuckoo, key, length);
+
+    pthread_mutex_unlock(cuckoo->mutex);
+
+    return ret;
+}
+
+bool cuckoo_resize (Cuckoo* cuckoo, int64_t bucket_count) {
+    assert(NULL != cuckoo);
+    assert(NULL != cuckoo->array);
+    assert(0 < bucket_count);
+
+    CuckooArray* old_array = cuckoo->array;
+    CuckooArray* array     = NULL;
+    bool         complete  = false;
+
+    while (!complete) {
+        array = __cuckoo_array_new(bucket_count);
+
+        if (NULL == array) {
+            return false;
+        }
+
+        complete = true;
+
+        for (uint64_t bucket = 0; complete && bucket <= old_array->mask; bucket++) {
+            CuckooBucket* src = old_array->buckets + bucket;
+
+            for (int32_t slot = 0; complete && slot < __CUCKOO_BUCKET_SLOTS; slot++) {
+                if (0 != __CUCKOO_TAG_AT(src->tags, slot)) {
+                    complete = __cuckoo_insert(cuckoo, array, src->entries[slot], false);
+                }
+            }
+        }
+
+        if (!complete) {
+            bucket_count = (int64_t) (array->mask + 1) * 2;
+
+            __cuckoo_array_free(array);
+        }
+    }
+
+    if (NULL != cuckoo->mutex) {
+        // optimistic readers may still be scanning the old array, so it lives until cleanup
+        array->retired = old_array;
+    } else {
+        __cuckoo_array_free(old_array);
+    }
+
+    __atomic_store_n(&cuckoo->array, array, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+bool cuckoo_resize_ts (Cuckoo* cuckoo, int64_t bucket_count) {
+    assert(NULL != cuckoo);
+    assert(NULL != cuckoo->mutex);
+
+    pthread_mutex_lock(cuckoo->mutex);
+
+    bool ret = cuckoo_resize(cuckoo, bucket_count);
+
+    pthread_mutex_unlock(cuckoo->mutex);
+
+    return ret;
+}
+
+void cuckoo_unlock (Cuckoo* cuckoo) {
+    assert(NULL != cuckoo);
+    assert(NULL != cuckoo->mutex);
+
+    pthread_mutex_unlock(cuckoo->mutex);
+}
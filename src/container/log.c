@@ -0,0 +1,221 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#include <assert.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "codebox/container/log.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+// the bit of a header that marks its record committed, so a header of zero is still being written
+#define __APPEND_LOG_COMMITTED ((uint64_t) 1 << 63)
+
+#define __APPEND_LOG_HEADER_AT(__log, __position) \
+    ((uint64_t*) ((__log)->data + ((__position) & (__log)->mask)))
+
+// the space a record takes, with its header and padding
+#define __APPEND_LOG_SPAN(__length) \
+    (APPEND_LOG_HEADER + (((uint64_t) (__length) + 7) & ~(uint64_t) 7))
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Set the region of the data of the record whose header is at a position.
+ */
+static void __append_log_region (AppendLog* log, AppendLogRegion* region, uint64_t position,
+                                 int64_t length) {
+    uint64_t index = (position + APPEND_LOG_HEADER) & log->mask;
+    int64_t  first = (int64_t) (log->size - index);
+
+    region->position = position;
+    region->data[0]  = log->data + index;
+    region->data[1]  = log->data;
+
+    if (length <= first) {
+        region->length[0] = length;
+        region->length[1] = 0;
+    } else {
+        region->length[0] = first;
+        region->length[1] = length - first;
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+bool append_log_cleanup (AppendLog* log) {
+    assert(NULL != log);
+    assert(NULL != log->data);
+
+    free(log->data);
+
+    log->data = NULL;
+
+    return true;
+}
+
+void append_log_commit (AppendLog* log, AppendLogRegion* region) {
+    assert(NULL != log);
+    assert(NULL != region);
+
+    __atomic_store_n(__APPEND_LOG_HEADER_AT(log, region->position),
+                     (uint64_t) (region->length[0] + region->length[1]) | __APPEND_LOG_COMMITTED,
+                     __ATOMIC_RELEASE);
+}
+
+void append_log_consume (AppendLog* log, AppendLogRegion* region) {
+    assert(NULL != log);
+    assert(NULL != region);
+    assert(region->position == log->head);
+
+    uint64_t span  = __APPEND_LOG_SPAN(region->length[0] + region->length[1]);
+    uint64_t index = log->head & log->mask;
+
+    // the header of a later record may land anywhere in the space, so all of it reads as
+    // uncommitted until it is written again
+    if (span <= log->size - index) {
+        memset(log->data + index, 0, span);
+    } else {
+        memset(log->data + index, 0, log->size - index);
+        memset(log->data, 0, span - (log->size - index));
+    }
+
+    __atomic_store_n(&log->head, log->head + span, __ATOMIC_RELEASE);
+}
+
+bool append_log_drain (AppendLog* log, Buffer* dest) {
+    assert(NULL != log);
+    assert(NULL != dest);
+
+    AppendLogRegion region;
+
+    while (append_log_read(log, &region)) {
+        if (!buffer_append(dest, region.data[0], region.length[0])) {
+            return false;
+        } else if (0 < region.length[1] && !buffer_append(dest, region.data[1], region.length[1])) {
+            // the record stays in the log, so the first part is taken back
+            dest->length -= region.length[0];
+
+            return false;
+        }
+
+        append_log_consume(log, &region);
+    }
+
+    return true;
+}
+
+bool append_log_init (AppendLog* log, int64_t size) {
+    assert(NULL != log);
+    assert(NULL == log->data);
+    assert(0 < size);
+
+    uint64_t _size = __APPEND_LOG_CACHE_LINE;
+
+    for (; _size < (uint64_t) size; _size <<= 1);
+
+    // the headers are read and written atomically, so each must be aligned
+    if (0 != posix_memalign((void**) &log->data, __APPEND_LOG_CACHE_LINE, _size)) {
+        log->data = NULL;
+
+        return false;
+    }
+
+    memset(log->data, 0, _size);
+
+    log->head     = 0;
+    log->mask     = _size - 1;
+    log->reserved = 0;
+    log->size     = _size;
+
+    return true;
+}
+
+AppendLog* append_log_new () {
+    AppendLog* log = (AppendLog*) malloc(sizeof(AppendLog));
+
+    if (NULL == log) {
+        return NULL;
+    }
+
+    memset(log, 0, sizeof(AppendLog));
+
+    return log;
+}
+
+bool append_log_read (AppendLog* log, AppendLogRegion* region) {
+    assert(NULL != log);
+    assert(NULL != region);
+
+    uint64_t header = __atomic_load_n(__APPEND_LOG_HEADER_AT(log, log->head), __ATOMIC_ACQUIRE);
+
+    if (0 == (header & __APPEND_LOG_COMMITTED)) {
+        return false;
+    }
+
+    __append_log_region(log, region, log->head, (int64_t) (header & ~__APPEND_LOG_COMMITTED));
+
+    return true;
+}
+
+bool append_log_reserve (AppendLog* log, int64_t length, AppendLogRegion* region) {
+    assert(NULL != log);
+    assert(NULL != region);
+    assert(0 < length);
+
+    uint64_t position;
+    uint64_t span;
+
+    if (log->size - APPEND_LOG_HEADER < (uint64_t) length) {
+        return false;
+    }
+
+    span     = __APPEND_LOG_SPAN(length);
+    position = __atomic_fetch_add(&log->reserved, span, __ATOMIC_RELAXED);
+
+    // wait for the consumer to free the space of the record
+    while (log->size < position + span - __atomic_load_n(&log->head, __ATOMIC_ACQUIRE)) {
+        sched_yield();
+    }
+
+    __append_log_region(log, region, position, length);
+
+    return true;
+}
+
+int64_t append_log_size (AppendLog* log) {
+    assert(NULL != log);
+
+    return (int64_t) log->size;
+}
+
+bool append_log_write (AppendLog* log, unsigned char* data, int64_t length) {
+    assert(NULL != log);
+    assert(NULL != data);
+    assert(0 < length);
+
+    AppendLogRegion region;
+
+    if (!append_log_reserve(log, length, &region)) {
+        return false;
+    }
+
+    memcpy(region.data[0], data, region.length[0]);
+    memcpy(region.data[1], data + region.length[0], region.length[1]);
+    append_log_commit(log, &region);
+
+    return true;
+}
@@ -0,0 +1,330 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "codebox/container/pool.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __BUFFER_POOL_CLASS_SIZE(__class) (__BUFFER_POOL_MIN_SIZE << (__class))
+
+// a retained buffer links to the next one through the start of its unused data
+#define __BUFFER_POOL_NEXT(__buffer) (*(Buffer**) (__buffer)->data)
+
+#define __BUFFER_POOL_STAT(__pool, __field, __value) \
+    __atomic_add_fetch(&(__pool)->stats.__field, __value, __ATOMIC_RELAXED)
+
+// -------------------------------------------------------------------------------------------------
+// STATIC VARIABLES
+// -------------------------------------------------------------------------------------------------
+
+static BufferPool     __buffer_pool_default;
+static pthread_once_t __buffer_pool_default_once = PTHREAD_ONCE_INIT;
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Free a buffer.
+ */
+static void __buffer_pool_free (Buffer* buffer) {
+    buffer_cleanup(buffer);
+    free(buffer);
+}
+
+/**
+ * Free a list of retained buffers.
+ */
+static void __buffer_pool_free_list (Buffer* buffer) {
+    Buffer* next;
+
+    for (; NULL != buffer; buffer = next) {
+        next = __BUFFER_POOL_NEXT(buffer);
+
+        __buffer_pool_free(buffer);
+    }
+}
+
+/**
+ * Move a count of buffers from the start of one list onto the start of another.
+ */
+static void __buffer_pool_move (Buffer** from, int32_t* from_count, Buffer** to, int32_t* to_count,
+                                int32_t count) {
+    Buffer* buffer;
+
+    for (int32_t i = 0; i < count && NULL != *from; i++) {
+        buffer                     = *from;
+        *from                      = __BUFFER_POOL_NEXT(buffer);
+        __BUFFER_POOL_NEXT(buffer) = *to;
+        *to                        = buffer;
+
+        (*from_count)--;
+        (*to_count)++;
+    }
+}
+
+/**
+ * Return the buffers of a thread cache to its pool when the thread exits.
+ */
+static void __buffer_pool_cache_exit (void* data) {
+    BufferPoolCache*  cache = (BufferPoolCache*) data;
+    BufferPool*       pool  = cache->pool;
+    BufferPoolCache** link;
+
+    pthread_mutex_lock(pool->mutex);
+
+    for (int32_t i = 0; i < __BUFFER_POOL_CLASS_COUNT; i++) {
+        __buffer_pool_move(&cache->heads[i], &cache->counts[i], &pool->heads[i], &pool->counts[i],
+                           cache->counts[i]);
+    }
+
+    for (link = &pool->caches; *link != cache; link = &(*link)->next);
+
+    *link = cache->next;
+
+    pthread_mutex_unlock(pool->mutex);
+
+    free(cache);
+}
+
+/**
+ * Retrieve the cache of the calling thread, creating it on first use.
+ */
+static BufferPoolCache* __buffer_pool_cache (BufferPool* pool) {
+    BufferPoolCache* cache = (BufferPoolCache*) pthread_getspecific(pool->key);
+
+    if (NULL != cache) {
+        return cache;
+    }
+
+    cache = (BufferPoolCache*) malloc(sizeof(BufferPoolCache));
+
+    if (NULL == cache) {
+        return NULL;
+    }
+
+    memset(cache, 0, sizeof(BufferPoolCache));
+
+    cache->pool = pool;
+
+    if (0 != pthread_setspecific(pool->key, cache)) {
+        free(cache);
+
+        return NULL;
+    }
+
+    pthread_mutex_lock(pool->mutex);
+
+    cache->next  = pool->caches;
+    pool->caches = cache;
+
+    pthread_mutex_unlock(pool->mutex);
+
+    return cache;
+}
+
+/**
+ * Initialize the default pool.
+ */
+static void __buffer_pool_default_init () {
+    buffer_pool_init(&__buffer_pool_default, __BUFFER_POOL_DEFAULT_RETAINED);
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+Buffer* buffer_pool_acquire (BufferPool* pool, int64_t size) {
+    assert(NULL != pool);
+    assert(NULL != pool->mutex);
+
+    BufferPoolCache* cache  = __buffer_pool_cache(pool);
+    Buffer*          buffer = NULL;
+    int32_t          class  = 0;
+
+    for (; class < __BUFFER_POOL_CLASS_COUNT && __BUFFER_POOL_CLASS_SIZE(class) < size; class++);
+
+    __BUFFER_POOL_STAT(pool, acquired, 1);
+
+    if (__BUFFER_POOL_CLASS_COUNT != class && NULL != cache) {
+        if (NULL == cache->heads[class]) {
+            // refill half of the thread cache at once, so the lock is taken once per few acquires
+            pthread_mutex_lock(pool->mutex);
+
+            __buffer_pool_move(&pool->heads[class], &pool->counts[class], &cache->heads[class],
+                               &cache->counts[class], __BUFFER_POOL_CACHE_COUNT / 2);
+
+            pthread_mutex_unlock(pool->mutex);
+        }
+
+        if (NULL != (buffer = cache->heads[class])) {
+            cache->heads[class] = __BUFFER_POOL_NEXT(buffer);
+            cache->counts[class]--;
+
+            __BUFFER_POOL_STAT(pool, retained, -buffer->size);
+
+            return buffer;
+        }
+    }
+
+    __BUFFER_POOL_STAT(pool, allocated, 1);
+
+    if (NULL == (buffer = buffer_new())) {
+        return NULL;
+    } else if (!buffer_init(buffer, __BUFFER_POOL_CLASS_COUNT == class
+                                    ? size : __BUFFER_POOL_CLASS_SIZE(class), false)) {
+        free(buffer);
+
+        return NULL;
+    }
+
+    return buffer;
+}
+
+bool buffer_pool_cleanup (BufferPool* pool) {
+    assert(NULL != pool);
+    assert(NULL != pool->mutex);
+
+    BufferPoolCache* cache;
+
+    pthread_key_delete(pool->key);
+
+    for (; NULL != (cache = pool->caches); free(cache)) {
+        pool->caches = cache->next;
+
+        for (int32_t i = 0; i < __BUFFER_POOL_CLASS_COUNT; i++) {
+            __buffer_pool_free_list(cache->heads[i]);
+        }
+    }
+
+    for (int32_t i = 0; i < __BUFFER_POOL_CLASS_COUNT; i++) {
+        __buffer_pool_free_list(pool->heads[i]);
+
+        pool->counts[i] = 0;
+        pool->heads[i]  = NULL;
+    }
+
+    pthread_mutex_destroy(pool->mutex);
+    free(pool->mutex);
+
+    pool->mutex          = NULL;
+    pool->stats.retained = 0;
+
+    return true;
+}
+
+BufferPool* buffer_pool_default () {
+    pthread_once(&__buffer_pool_default_once, __buffer_pool_default_init);
+
+    return &__buffer_pool_default;
+}
+
+bool buffer_pool_init (BufferPool* pool, int64_t max_retained) {
+    assert(NULL != pool);
+    assert(0 <= max_retained);
+
+    memset(pool, 0, sizeof(BufferPool));
+
+    pool->max_retained = max_retained;
+    pool->mutex        = (pthread_mutex_t*) malloc(sizeof(pthread_mutex_t));
+
+    if (NULL == pool->mutex) {
+        return false;
+    }
+
+    if (0 != pthread_key_create(&pool->key, __buffer_pool_cache_exit)) {
+        free(pool->mutex);
+
+        pool->mutex = NULL;
+
+        return false;
+    }
+
+    pthread_mutex_init(pool->mutex, NULL);
+
+    return true;
+}
+
+BufferPool* buffer_pool_new () {
+    BufferPool* pool = (BufferPool*) malloc(sizeof(BufferPool));
+
+    if (NULL == pool) {
+        return NULL;
+    }
+
+    memset(pool, 0, sizeof(BufferPool));
+
+    return pool;
+}
+
+void buffer_pool_release (BufferPool* pool, Buffer* buffer) {
+    assert(NULL != pool);
+    assert(NULL != pool->mutex);
+    assert(NULL != buffer);
+    assert(NULL != buffer->data);
+
+    BufferPoolCache* cache = NULL;
+    int32_t          class = __BUFFER_POOL_CLASS_COUNT - 1;
+
+    __BUFFER_POOL_STAT(pool, released, 1);
+
+    for (; 0 <= class && buffer->size < __BUFFER_POOL_CLASS_SIZE(class); class--);
+
+    if (-1 == class || __BUFFER_POOL_CLASS_SIZE(__BUFFER_POOL_CLASS_COUNT - 1) < buffer->size ||
+        NULL != buffer->mutex || NULL != buffer->storage || 0 != buffer->alloc ||
+        NULL == (cache = __buffer_pool_cache(pool))) {
+        __BUFFER_POOL_STAT(pool, discarded, 1);
+        __buffer_pool_free(buffer);
+
+        return;
+    }
+
+    if (pool->max_retained < __BUFFER_POOL_STAT(pool, retained, buffer->size)) {
+        __BUFFER_POOL_STAT(pool, retained, -buffer->size);
+        __BUFFER_POOL_STAT(pool, discarded, 1);
+        __buffer_pool_free(buffer);
+
+        return;
+    }
+
+    buffer_set_gapped(buffer, false);
+    buffer_set_growth(buffer, __BUFFER_DEFAULT_GROWTH);
+    buffer_truncate(buffer);
+
+    if (__BUFFER_POOL_CACHE_COUNT == cache->counts[class]) {
+        // share half of a full thread cache with the other threads
+        pthread_mutex_lock(pool->mutex);
+
+        __buffer_pool_move(&cache->heads[class], &cache->counts[class], &pool->heads[class],
+                           &pool->counts[class], __BUFFER_POOL_CACHE_COUNT / 2);
+
+        pthread_mutex_unlock(pool->mutex);
+    }
+
+    __BUFFER_POOL_NEXT(buffer) = cache->heads[class];
+    cache->heads[class]        = buffer;
+
+    cache->counts[class]++;
+}
+
+void buffer_pool_stats (BufferPool* pool, BufferPoolStats* stats) {
+    assert(NULL != pool);
+    assert(NULL != stats);
+
+    stats->acquired  = __atomic_load_n(&pool->stats.acquired, __ATOMIC_RELAXED);
+    stats->allocated = __atomic_load_n(&pool->stats.allocated, __ATOMIC_RELAXED);
+    stats->discarded = __atomic_load_n(&pool->stats.discarded, __ATOMIC_RELAXED);
+    stats->released  = __atomic_load_n(&pool->stats.released, __ATOMIC_RELAXED);
+    stats->retained  = __atomic_load_n(&pool->stats.retained, __ATOMIC_RELAXED);
+}
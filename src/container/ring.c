@@ -0,0 +1,253 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#define _GNU_SOURCE
+
+#include <assert.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "codebox/container/ring.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __RING_REGION(__ring, __region, __position, __length) \
+    { \
+        uint64_t __index = (__position) & (__ring)->mask; \
+        int64_t  __first = (int64_t) ((__ring)->size - __index); \
+        (__region)->position = (__position); \
+        (__region)->data[0]  = (__ring)->data + __index; \
+        (__region)->data[1]  = (__ring)->data; \
+        if ((__ring)->mapped || (__length) <= __first) { \
+            (__region)->length[0] = (__length); \
+            (__region)->length[1] = 0; \
+        } else { \
+            (__region)->length[0] = __first; \
+            (__region)->length[1] = (__length) - __first; \
+        } \
+    }
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Map a memory file twice in a row, so that data written past its end appears at its start.
+ */
+static unsigned char* __ring_map (uint64_t size) {
+#ifdef __linux__
+    int fd = memfd_create("codebox-ring", 0);
+
+    if (-1 == fd) {
+        return NULL;
+    }
+
+    if (0 != ftruncate(fd, size)) {
+        close(fd);
+
+        return NULL;
+    }
+
+    // reserve the address range for both mappings, then map the file over each half
+    unsigned char* data = mmap(NULL, size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (MAP_FAILED == data) {
+        close(fd);
+
+        return NULL;
+    }
+
+    if (MAP_FAILED == mmap(data, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) ||
+        MAP_FAILED == mmap(data + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+                           fd, 0)) {
+        munmap(data, size * 2);
+        close(fd);
+
+        return NULL;
+    }
+
+    close(fd);
+
+    return data;
+#else
+    return NULL;
+#endif
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+bool ring_cleanup (Ring* ring) {
+    assert(NULL != ring);
+    assert(NULL != ring->data);
+
+    if (ring->mapped) {
+        munmap(ring->data, ring->size * 2);
+    } else {
+        free(ring->data);
+    }
+
+    ring->data = NULL;
+
+    return true;
+}
+
+void ring_commit (Ring* ring, RingRegion* region) {
+    assert(NULL != ring);
+    assert(NULL != region);
+
+    if (RING_MPSC == ring->type) {
+        // wait for producers that reserved earlier regions to commit them
+        while (region->position != __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE)) {
+            sched_yield();
+        }
+    }
+
+    __atomic_store_n(&ring->tail, region->position + region->length[0] + region->length[1],
+                     __ATOMIC_RELEASE);
+}
+
+void ring_consume (Ring* ring, int64_t length) {
+    assert(NULL != ring);
+    assert(0 <= length);
+    assert(length <= ring_length(ring));
+
+    __atomic_store_n(&ring->head, ring->head + length, __ATOMIC_RELEASE);
+}
+
+bool ring_init (Ring* ring, int64_t size, RingType type, bool mapped) {
+    assert(NULL != ring);
+    assert(NULL == ring->data);
+    assert(0 < size);
+
+    uint64_t _size = mapped ? (uint64_t) sysconf(_SC_PAGESIZE) : 1;
+
+    for (; _size < (uint64_t) size; _size <<= 1);
+
+    ring->data     = mapped ? __ring_map(_size) : (unsigned char*) malloc(_size);
+    ring->head     = 0;
+    ring->mapped   = mapped;
+    ring->mask     = _size - 1;
+    ring->reserved = 0;
+    ring->size     = _size;
+    ring->tail     = 0;
+    ring->type     = type;
+
+    return NULL != ring->data;
+}
+
+int64_t ring_length (Ring* ring) {
+    assert(NULL != ring);
+
+    return (int64_t) (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) -
+                      __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE));
+}
+
+Ring* ring_new () {
+    Ring* ring = (Ring*) malloc(sizeof(Ring));
+
+    if (NULL == ring) {
+        return NULL;
+    }
+
+    memset(ring, 0, sizeof(Ring));
+
+    return ring;
+}
+
+bool ring_peek (Ring* ring, RingRegion* region) {
+    assert(NULL != ring);
+    assert(NULL != region);
+
+    uint64_t head   = ring->head;
+    int64_t  length = (int64_t) (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) - head);
+
+    __RING_REGION(ring, region, head, length);
+
+    return 0 < length;
+}
+
+int64_t ring_read (Ring* ring, unsigned char* data, int64_t length) {
+    assert(NULL != ring);
+    assert(NULL != data);
+    assert(0 < length);
+
+    RingRegion region;
+
+    ring_peek(ring, &region);
+
+    int64_t first  = region.length[0] < length ? region.length[0] : length;
+    int64_t second = region.length[1] < length - first ? region.length[1] : length - first;
+
+    memcpy(data, region.data[0], first);
+    memcpy(data + first, region.data[1], second);
+    ring_consume(ring, first + second);
+
+    return first + second;
+}
+
+bool ring_reserve (Ring* ring, int64_t length, RingRegion* region) {
+    assert(NULL != ring);
+    assert(NULL != region);
+    assert(0 < length);
+
+    uint64_t position = 0;
+
+    if (RING_SPSC == ring->type) {
+        position = ring->tail;
+
+        if (ring->size - (position - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) <
+            (uint64_t) length) {
+            return false;
+        }
+    } else {
+        position = __atomic_load_n(&ring->reserved, __ATOMIC_RELAXED);
+
+        do {
+            if (ring->size - (position - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) <
+                (uint64_t) length) {
+                return false;
+            }
+        } while (!__atomic_compare_exchange_n(&ring->reserved, &position, position + length,
+                                              true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+    }
+
+    __RING_REGION(ring, region, position, length);
+
+    return true;
+}
+
+int64_t ring_size (Ring* ring) {
+    assert(NULL != ring);
+
+    return (int64_t) ring->size;
+}
+
+bool ring_write (Ring* ring, unsigned char* data, int64_t length) {
+    assert(NULL != ring);
+    assert(NULL != data);
+    assert(0 < length);
+
+    RingRegion region;
+
+    if (!ring_reserve(ring, length, &region)) {
+        return false;
+    }
+
+    memcpy(region.data[0], data, region.length[0]);
+    memcpy(region.data[1], data + region.length[0], region.length[1]);
+    ring_commit(ring, &region);
+
+    return true;
+}
@@ -0,0 +1,803 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "codebox/container/rope.h"
+#include "codebox/string.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __ROPE_HEIGHT(__node) \
+    (NULL == (__node) ? 0 : (__node)->height)
+
+#define __ROPE_LENGTH(__node) \
+    (NULL == (__node) ? 0 : (__node)->length)
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/*
+ * Nodes are immutable once created and are shared between ropes through reference counts. Unless
+ * noted otherwise, the static functions below consume the references to the nodes they are given
+ * and return a new reference, so the tree a rope held before an operation stays intact until the
+ * operation succeeds. Any allocation failure clears the ok flag, and the result is then discarded.
+ */
+
+/**
+ * Retain a node.
+ */
+static RopeNode* __rope_retain (RopeNode* node) {
+    if (NULL != node) {
+        __atomic_add_fetch(&node->refs, 1, __ATOMIC_RELAXED);
+    }
+
+    return node;
+}
+
+/**
+ * Release a node, freeing it and releasing its children and chunk when unreferenced.
+ */
+static void __rope_release (RopeNode* node) {
+    while (NULL != node && 0 == __atomic_sub_fetch(&node->refs, 1, __ATOMIC_ACQ_REL)) {
+        RopeNode* right = node->right;
+
+        if (NULL != node->chunk && 0 == __atomic_sub_fetch(&node->chunk->refs, 1,
+                                                           __ATOMIC_ACQ_REL)) {
+            free(node->chunk);
+        }
+
+        __rope_release(node->left);
+        free(node);
+
+        node = right;
+    }
+}
+
+/**
+ * Create a leaf node referencing a range of a chunk. The chunk reference is not consumed.
+ */
+static RopeNode* __rope_leaf (RopeChunk* chunk, int64_t offset, int64_t length, bool* ok) {
+    RopeNode* node = (RopeNode*) malloc(sizeof(RopeNode));
+
+    if (NULL == node) {
+        *ok = false;
+
+        return NULL;
+    }
+
+    __atomic_add_fetch(&chunk->refs, 1, __ATOMIC_RELAXED);
+
+    node->chunk  = chunk;
+    node->height = 1;
+    node->left   = NULL;
+    node->length = length;
+    node->offset = offset;
+    node->refs   = 1;
+    node->right  = NULL;
+
+    return node;
+}
+
+/**
+ * Create a branch node over two non-empty trees.
+ */
+static RopeNode* __rope_branch (RopeNode* left, RopeNode* right, bool* ok) {
+    if (NULL == left || NULL == right) {
+        __rope_release(left);
+        __rope_release(right);
+
+        *ok = false;
+
+        return NULL;
+    }
+
+    RopeNode* node = (RopeNode*) malloc(sizeof(RopeNode));
+
+    if (NULL == node) {
+        __rope_release(left);
+        __rope_release(right);
+
+        *ok = false;
+
+        return NULL;
+    }
+
+    node->chunk  = NULL;
+    node->height = 1 + (left->height > right->height ? left->height : right->height);
+    node->left   = left;
+    node->length = left->length + right->length;
+    node->offset = 0;
+    node->refs   = 1;
+    node->right  = right;
+
+    return node;
+}
+
+/**
+ * Create a branch node over two trees whose heights differ by at most 2, rotating to keep it
+ * balanced.
+ */
+static RopeNode* __rope_balance (RopeNode* left, RopeNode* right, bool* ok) {
+    if (__ROPE_HEIGHT(left) > __ROPE_HEIGHT(right) + 1) {
+        RopeNode* ll = __rope_retain(left->left);
+        RopeNode* lr = __rope_retain(left->right);
+
+        __rope_release(left);
+
+        if (__ROPE_HEIGHT(ll) >= __ROPE_HEIGHT(lr)) {
+            return __rope_branch(ll, __rope_branch(lr, right, ok), ok);
+        }
+
+        RopeNode* lrl = __rope_retain(lr->left);
+        RopeNode* lrr = __rope_retain(lr->right);
+
+        __rope_release(lr);
+
+        return __rope_branch(__rope_branch(ll, lrl, ok), __rope_branch(lrr, right, ok), ok);
+    }
+
+    if (__ROPE_HEIGHT(right) > __ROPE_HEIGHT(left) + 1) {
+        RopeNode* rl = __rope_retain(right->left);
+        RopeNode* rr = __rope_retain(right->right);
+
+        __rope_release(right);
+
+        if (__ROPE_HEIGHT(rr) >= __ROPE_HEIGHT(rl)) {
+            return __rope_branch(__rope_branch(left, rl, ok), rr, ok);
+        }
+
+        RopeNode* rll = __rope_retain(rl->left);
+        RopeNode* rlr = __rope_retain(rl->right);
+
+        __rope_release(rl);
+
+        return __rope_branch(__rope_branch(left, rll, ok), __rope_branch(rlr, rr, ok), ok);
+    }
+
+    return __rope_branch(left, right, ok);
+}
+
+/**
+ * Concatenate two trees.
+ */
+static RopeNode* __rope_join (RopeNode* left, RopeNode* right, bool* ok) {
+    if (NULL == left) {
+        return right;
+    } else if (NULL == right) {
+        return left;
+    }
+
+    if (left->height > right->height + 1) {
+        RopeNode* ll = __rope_retain(left->left);
+        RopeNode* lr = __rope_retain(left->right);
+
+        __rope_release(left);
+
+        return __rope_balance(ll, __rope_join(lr, right, ok), ok);
+    }
+
+    if (right->height > left->height + 1) {
+        RopeNode* rl = __rope_retain(right->left);
+        RopeNode* rr = __rope_retain(right->right);
+
+        __rope_release(right);
+
+        return __rope_balance(__rope_join(left, rl, ok), rr, ok);
+    }
+
+    return __rope_branch(left, right, ok);
+}
+
+/**
+ * Split a tree into the data before an index and the data from it on.
+ */
+static void __rope_split (RopeNode* node, int64_t index, RopeNode** left, RopeNode** right,
+                          bool* ok) {
+    if (NULL == node || index <= 0) {
+        *left  = NULL;
+        *right = node;
+
+        return;
+    } else if (node->length <= index) {
+        *left  = node;
+        *right = NULL;
+
+        return;
+    }
+
+    if (NULL != node->chunk) {
+        *left  = __rope_leaf(node->chunk, node->offset, index, ok);
+        *right = __rope_leaf(node->chunk, node->offset + index, node->length - index, ok);
+
+        __rope_release(node);
+
+        return;
+    }
+
+    RopeNode* l = __rope_retain(node->left);
+    RopeNode* r = __rope_retain(node->right);
+    RopeNode* a = NULL;
+    RopeNode* b = NULL;
+
+    __rope_release(node);
+
+    if (index < l->length) {
+        __rope_split(l, index, &a, &b, ok);
+
+        *left  = a;
+        *right = __rope_join(b, r, ok);
+    } else {
+        __rope_split(r, index - l->length, &a, &b, ok);
+
+        *left  = __rope_join(l, a, ok);
+        *right = b;
+    }
+}
+
+/**
+ * Build a tree holding a copy of data, split into chunks.
+ */
+static RopeNode* __rope_build (unsigned char* data, int64_t length, bool* ok) {
+    RopeNode* tree = NULL;
+
+    for (int64_t offset = 0; *ok && offset < length; offset += __ROPE_CHUNK_SIZE) {
+        int64_t    size  = length - offset < __ROPE_CHUNK_SIZE ? length - offset
+                                                               : __ROPE_CHUNK_SIZE;
+        RopeChunk* chunk = (RopeChunk*) malloc(sizeof(RopeChunk) + size);
+
+        if (NULL == chunk) {
+            *ok = false;
+
+            break;
+        }
+
+        memcpy(chunk->data, data + offset, size);
+
+        chunk->length = size;
+        chunk->refs   = 0;
+        chunk->size   = size;
+
+        RopeNode* leaf = __rope_leaf(chunk, 0, size, ok);
+
+        if (NULL == leaf) {
+            free(chunk);
+
+            break;
+        }
+
+        tree = __rope_join(tree, leaf, ok);
+    }
+
+    return tree;
+}
+
+/**
+ * Find the leaf holding the byte before an index, or the first leaf when the index is 0, along
+ * with the position it starts at. The node reference is not consumed, and the leaf is borrowed.
+ */
+static RopeNode* __rope_find (RopeNode* node, int64_t index, int64_t* start) {
+    *start = 0;
+
+    while (NULL == node->chunk) {
+        if (index <= node->left->length) {
+            node = node->left;
+        } else {
+            *start += node->left->length;
+            index  -= node->left->length;
+            node    = node->right;
+        }
+    }
+
+    return node;
+}
+
+/**
+ * Create a leaf holding a copy of the data of a leaf with data inserted at an offset into it. The
+ * chunk is allocated with room to spare, so that further edits at its end are appended in place.
+ */
+static RopeNode* __rope_combine (RopeNode* leaf, int64_t offset, unsigned char* data,
+                                 int64_t length, bool* ok) {
+    unsigned char* source = leaf->chunk->data + leaf->offset;
+    int64_t        size   = leaf->length + length;
+    int64_t        room   = size + size / 4;
+    RopeChunk*     chunk  = (RopeChunk*) malloc(sizeof(RopeChunk) + room);
+
+    if (NULL == chunk) {
+        *ok = false;
+
+        return NULL;
+    }
+
+    memcpy(chunk->data, source, offset);
+    memcpy(chunk->data + offset, data, length);
+    memcpy(chunk->data + offset + length, source + offset, leaf->length - offset);
+
+    chunk->length = size;
+    chunk->refs   = 0;
+    chunk->size   = room;
+
+    RopeNode* node = __rope_leaf(chunk, 0, size, ok);
+
+    if (NULL == node) {
+        free(chunk);
+    }
+
+    return node;
+}
+
+/**
+ * Insert a copy of data into a tree at an index.
+ *
+ * Small edits are merged into the leaf next to them rather than given a leaf of their own, so
+ * that many small edits do not leave the tree split into many tiny chunks. The data is appended
+ * in place when it follows the leaf and the chunk of the leaf is unshared and has room, and it
+ * is otherwise copied along with a small leaf into a new chunk.
+ */
+static RopeNode* __rope_insert (RopeNode* root, int64_t index, unsigned char* data,
+                                int64_t length, bool* ok) {
+    RopeNode* before = NULL;
+    RopeNode* middle = NULL;
+    RopeNode* after  = NULL;
+
+    if (NULL != root && length < __ROPE_MERGE_SIZE) {
+        int64_t    start;
+        RopeNode*  leaf   = __rope_find(root, index, &start);
+        RopeChunk* chunk  = leaf->chunk;
+        int64_t    end    = leaf->offset + leaf->length;
+        int64_t    offset = index - start;
+
+        // the range past the end of the chunk is claimed atomically, as the leaf may be shared
+        // with a copy edited under a different mutex
+        if (offset == leaf->length && end + length <= chunk->size &&
+            1 == __atomic_load_n(&chunk->refs, __ATOMIC_ACQUIRE) &&
+            __atomic_compare_exchange_n(&chunk->length, &end, end + length, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            memcpy(chunk->data + end, data, length);
+
+            middle = __rope_leaf(chunk, leaf->offset, leaf->length + length, ok);
+        } else if (leaf->length <= __ROPE_MERGE_SIZE) {
+            middle = __rope_combine(leaf, offset, data, length, ok);
+        }
+
+        if (NULL != middle) {
+            int64_t size = leaf->length;
+
+            __rope_split(root, start, &before, &root, ok);
+            __rope_split(root, size, &root, &after, ok);
+            __rope_release(root);
+
+            return __rope_join(__rope_join(before, middle, ok), after, ok);
+        } else if (!*ok) {
+            __rope_release(root);
+
+            return NULL;
+        }
+    }
+
+    __rope_split(root, index, &before, &after, ok);
+
+    middle = __rope_build(data, length, ok);
+
+    return __rope_join(__rope_join(before, middle, ok), after, ok);
+}
+
+/**
+ * Replace the tree of a rope when an operation succeeded, or discard the new tree otherwise.
+ */
+static bool __rope_commit (Rope* rope, RopeNode* root, bool ok) {
+    if (!ok) {
+        __rope_release(root);
+
+        return false;
+    }
+
+    __rope_release(rope->root);
+
+    rope->root = root;
+
+    return true;
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+bool rope_append (Rope* rope, unsigned char* data, int64_t length) {
+    assert(NULL != rope);
+    assert(NULL != data);
+    assert(0 < length);
+
+    bool      ok   = true;
+    RopeNode* root = __rope_insert(__rope_retain(rope->root), __ROPE_LENGTH(rope->root), data,
+                                   length, &ok);
+
+    return __rope_commit(rope, root, ok);
+}
+
+bool rope_append_ts (Rope* rope, unsigned char* data, int64_t length) {
+    assert(NULL != rope);
+    assert(NULL != rope->mutex);
+
+    pthread_mutex_lock(rope->mutex);
+
+    bool ret = rope_append(rope, data, length);
+
+    pthread_mutex_unlock(rope->mutex);
+
+    return ret;
+}
+
+bool rope_append_buffer (Rope* rope, Buffer* buffer) {
+    assert(NULL != rope);
+    assert(NULL != buffer);
+
+    if (0 == buffer_length(buffer)) {
+        return true;
+    }
+
+    return rope_append(rope, buffer_data(buffer), buffer_length(buffer));
+}
+
+bool rope_cleanup (Rope* rope) {
+    assert(NULL != rope);
+
+    __rope_release(rope->root);
+
+    rope->root = NULL;
+
+    if (NULL != rope->mutex) {
+        pthread_mutex_destroy(rope->mutex);
+        free(rope->mutex);
+    }
+
+    return true;
+}
+
+Rope* rope_copy (Rope* rope, int64_t start, int64_t length) {
+    assert(NULL != rope);
+    assert(0 <= start);
+    assert(0 < length);
+    assert(start + length <= __ROPE_LENGTH(rope->root));
+
+    bool      ok     = true;
+    RopeNode* before = NULL;
+    RopeNode* slice  = NULL;
+    RopeNode* after  = NULL;
+    Rope*     copy   = rope_new();
+
+    if (NULL == copy) {
+        return NULL;
+    } else if (!rope_init(copy, NULL != rope->mutex)) {
+        free(copy);
+
+        return NULL;
+    }
+
+    __rope_split(__rope_retain(rope->root), start, &before, &slice, &ok);
+    __rope_release(before);
+    __rope_split(slice, length, &slice, &after, &ok);
+    __rope_release(after);
+
+    if (!__rope_commit(copy, slice, ok)) {
+        rope_cleanup(copy);
+        free(copy);
+
+        return NULL;
+    }
+
+    return copy;
+}
+
+Rope* rope_copy_ts (Rope* rope, int64_t start, int64_t length) {
+    assert(NULL != rope);
+    assert(NULL != rope->mutex);
+
+    pthread_mutex_lock(rope->mutex);
+
+    Rope* ret = rope_copy(rope, start, length);
+
+    pthread_mutex_unlock(rope->mutex);
+
+    return ret;
+}
+
+int64_t rope_indexof (Rope* rope, int64_t start, unsigned char* sequence, int32_t length) {
+    assert(NULL != rope);
+    assert(NULL != sequence);
+    assert(0 <= start);
+    assert(0 < length);
+
+    RopeIterator   iter;
+    int64_t        position = 0;
+    int32_t        carry    = 0;
+    unsigned char* window   = (unsigned char*) malloc(2 * (size_t) length);
+
+    if (NULL == window) {
+        return -1;
+    }
+
+    rope_iter_init(&iter, rope);
+
+    // matches within a chunk are found directly, while matches spanning chunks are found in a
+    // window holding the last length - 1 bytes seen followed by the start of the next chunk
+    while (rope_iter_next(&iter)) {
+        unsigned char* data = rope_iter_data(&iter);
+        int64_t        size = rope_iter_length(&iter);
+        int64_t        skip = start > position ? start - position : 0;
+
+        if (skip >= size) {
+            position += size;
+
+            continue;
+        }
+
+        data     += skip;
+        size     -= skip;
+        position += skip;
+
+        if (0 < carry) {
+            int32_t head  = size < length - 1 ? (int32_t) size : length - 1;
+            int64_t found = -1;
+
+            memcpy(window + carry, data, head);
+
+            if (length <= carry + head) {
+                found = chr_indexof(window, carry + head, 0, sequence, length);
+            }
+
+            if (-1 != found && found < carry) {
+                free(window);
+
+                return position - carry + found;
+            }
+        }
+
+        if (length <= size) {
+            int64_t found = chr_indexof(data, size, 0, sequence, length);
+
+            if (-1 != found) {
+                free(window);
+
+                return position + found;
+            }
+        }
+
+        // keep the last length - 1 bytes of the window and chunk for the next boundary
+        if (length - 1 <= size) {
+            carry = length - 1;
+
+            memcpy(window, data + size - carry, carry);
+        } else {
+            int32_t keep = carry + (int32_t) size < length - 1 ? carry
+                                                              : length - 1 - (int32_t) size;
+
+            memmove(window, window + carry - keep, keep);
+            memcpy(window + keep, data, size);
+
+            carry = keep + (int32_t) size;
+        }
+
+        position += size;
+    }
+
+    free(window);
+
+    return -1;
+}
+
+int64_t rope_indexof_ts (Rope* rope, int64_t start, unsigned char* sequence, int32_t length) {
+    assert(NULL != rope);
+    assert(NULL != rope->mutex);
+
+    pthread_mutex_lock(rope->mutex);
+
+    int64_t ret = rope_indexof(rope, start, sequence, length);
+
+    pthread_mutex_unlock(rope->mutex);
+
+    return ret;
+}
+
+bool rope_init (Rope* rope, bool thread_safe) {
+    assert(NULL != rope);
+    assert(NULL == rope->root);
+
+    rope->mutex = NULL;
+    rope->root  = NULL;
+
+    if (thread_safe) {
+        rope->mutex = (pthread_mutex_t*) malloc(sizeof(pthread_mutex_t));
+
+        if (NULL == rope->mutex) {
+            return false;
+        }
+
+        pthread_mutex_init(rope->mutex, NULL);
+    }
+
+    return true;
+}
+
+bool rope_insert (Rope* rope, int64_t index, unsigned char* data, int64_t length) {
+    assert(NULL != rope);
+    assert(NULL != data);
+    assert(0 < length);
+    assert(0 <= index && index <= __ROPE_LENGTH(rope->root));
+
+    bool      ok   = true;
+    RopeNode* root = __rope_insert(__rope_retain(rope->root), index, data, length, &ok);
+
+    return __rope_commit(rope, root, ok);
+}
+
+bool rope_insert_ts (Rope* rope, int64_t index, unsigned char* data, int64_t length) {
+    assert(NULL != rope);
+    assert(NULL != rope->mutex);
+
+    pthread_mutex_lock(rope->mutex);
+
+    bool ret = rope_insert(rope, index, data, length);
+
+    pthread_mutex_unlock(rope->mutex);
+
+    return ret;
+}
+
+unsigned char* rope_iter_data (RopeIterator* iter) {
+    assert(NULL != iter);
+    assert(NULL != iter->leaf);
+
+    return iter->leaf->chunk->data + iter->leaf->offset;
+}
+
+void rope_iter_init (RopeIterator* iter, Rope* rope) {
+    assert(NULL != iter);
+    assert(NULL != rope);
+
+    iter->depth = 0;
+    iter->leaf  = NULL;
+
+    if (NULL != rope->root) {
+        iter->stack[iter->depth++] = rope->root;
+    }
+}
+
+int64_t rope_iter_length (RopeIterator* iter) {
+    assert(NULL != iter);
+    assert(NULL != iter->leaf);
+
+    return iter->leaf->length;
+}
+
+bool rope_iter_next (RopeIterator* iter) {
+    assert(NULL != iter);
+
+    if (0 == iter->depth) {
+        iter->leaf = NULL;
+
+        return false;
+    }
+
+    // the stack holds subtrees still to be visited, the next of which is on top
+    RopeNode* node = iter->stack[--iter->depth];
+
+    for (; NULL == node->chunk; node = node->left) {
+        assert(iter->depth < __ROPE_MAX_DEPTH);
+
+        iter->stack[iter->depth++] = node->right;
+    }
+
+    iter->leaf = node;
+
+    return true;
+}
+
+int64_t rope_length (Rope* rope) {
+    assert(NULL != rope);
+
+    return __ROPE_LENGTH(rope->root);
+}
+
+int64_t rope_length_ts (Rope* rope) {
+    assert(NULL != rope);
+    assert(NULL != rope->mutex);
+
+    pthread_mutex_lock(rope->mutex);
+
+    int64_t ret = __ROPE_LENGTH(rope->root);
+
+    pthread_mutex_unlock(rope->mutex);
+
+    return ret;
+}
+
+void rope_lock (Rope* rope) {
+    assert(NULL != rope);
+    assert(NULL != rope->mutex);
+
+    pthread_mutex_lock(rope->mutex);
+}
+
+Rope* rope_new () {
+    Rope* rope = (Rope*) malloc(sizeof(Rope));
+
+    if (NULL == rope) {
+        return NULL;
+    }
+
+    memset(rope, 0, sizeof(Rope));
+
+    return rope;
+}
+
+bool rope_remove (Rope* rope, int64_t start, int64_t length) {
+    assert(NULL != rope);
+    assert(0 <= start);
+    assert(0 < length);
+    assert(start + length <= __ROPE_LENGTH(rope->root));
+
+    bool      ok     = true;
+    RopeNode* before = NULL;
+    RopeNode* middle = NULL;
+    RopeNode* after  = NULL;
+
+    __rope_split(__rope_retain(rope->root), start, &before, &middle, &ok);
+    __rope_split(middle, length, &middle, &after, &ok);
+    __rope_release(middle);
+
+    return __rope_commit(rope, __rope_join(before, after, &ok), ok);
+}
+
+bool rope_remove_ts (Rope* rope, int64_t start, int64_t length) {
+    assert(NULL != rope);
+    assert(NULL != rope->mutex);
+
+    pthread_mutex_lock(rope->mutex);
+
+    bool ret = rope_remove(rope, start, length);
+
+    pthread_mutex_unlock(rope->mutex);
+
+    return ret;
+}
+
+bool rope_to_buffer (Rope* rope, Buffer* buffer) {
+    assert(NULL != rope);
+    assert(NULL != buffer);
+
+    RopeIterator iter;
+
+    if (0 == __ROPE_LENGTH(rope->root)) {
+        return true;
+    } else if (!buffer_reserve(buffer, buffer_length(buffer) + __ROPE_LENGTH(rope->root))) {
+        return false;
+    }
+
+    rope_iter_init(&iter, rope);
+
+    while (rope_iter_next(&iter)) {
+        if (!buffer_append(buffer, rope_iter_data(&iter), rope_iter_length(&iter))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void rope_unlock (Rope* rope) {
+    assert(NULL != rope);
+    assert(NULL != rope->mutex);
+
+    pthread_mutex_unlock(rope->mutex);
+}
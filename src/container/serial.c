@@ -0,0 +1,421 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "codebox/container/serial.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define __SERIAL_BE16(__value) (__value)
+#define __SERIAL_BE32(__value) (__value)
+#define __SERIAL_BE64(__value) (__value)
+#define __SERIAL_LE16(__value) __builtin_bswap16(__value)
+#define __SERIAL_LE32(__value) __builtin_bswap32(__value)
+#define __SERIAL_LE64(__value) __builtin_bswap64(__value)
+#else
+#define __SERIAL_BE16(__value) __builtin_bswap16(__value)
+#define __SERIAL_BE32(__value) __builtin_bswap32(__value)
+#define __SERIAL_BE64(__value) __builtin_bswap64(__value)
+#define __SERIAL_LE16(__value) (__value)
+#define __SERIAL_LE32(__value) (__value)
+#define __SERIAL_LE64(__value) (__value)
+#endif
+
+#define __BUFFER_READER_FIXED(__reader, __type, __swap) \
+    __type value = 0; \
+    __buffer_reader_fixed(__reader, &value, sizeof(__type)); \
+    return __swap(value);
+
+#define __BUFFER_WRITER_ENSURE(__writer, __length) \
+    if ((__writer)->buffer->size - (__writer)->buffer->length < (__length) && \
+        !__buffer_writer_grow(__writer, __length)) { \
+        return false; \
+    }
+
+#define __BUFFER_WRITER_FIXED(__writer, __type, __swap, __value) \
+    __type swapped = __swap(__value); \
+    return __buffer_writer_fixed(__writer, &swapped, sizeof(__type));
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Copy a fixed-width value out of a reader, leaving it zero and setting the error flag when the
+ * reader has too few bytes left.
+ */
+static void __buffer_reader_fixed (BufferReader* reader, void* value, int64_t length) {
+    if (reader->length - reader->position < length) {
+        reader->error    = true;
+        reader->position = reader->length;
+
+        return;
+    }
+
+    memcpy(value, reader->data + reader->position, length);
+
+    reader->position += length;
+}
+
+/**
+ * Grow the buffer of a writer by its growth factor, or to fit a count of bytes if that is larger.
+ */
+static bool __buffer_writer_grow (BufferWriter* writer, int64_t length) {
+    Buffer* buffer = writer->buffer;
+    double  grown  = buffer->size * (double) buffer->growth;
+    int64_t size;
+
+    if (INT64_MAX - buffer->length < length) {
+        return false;
+    }
+
+    size = buffer->length + length;
+
+    if (size < grown && grown < (double) (INT64_MAX / 2)) {
+        size = (int64_t) grown;
+    }
+
+    return buffer_reserve(buffer, size);
+}
+
+/**
+ * Copy a fixed-width value onto the end of the buffer of a writer.
+ */
+static bool __buffer_writer_fixed (BufferWriter* writer, void* value, int64_t length) {
+    __BUFFER_WRITER_ENSURE(writer, length);
+
+    memcpy(writer->buffer->data + writer->buffer->length, value, length);
+
+    writer->buffer->length += length;
+
+    return true;
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+unsigned char* buffer_reader_blob (BufferReader* reader, int64_t* length) {
+    assert(NULL != reader);
+    assert(NULL != length);
+
+    uint64_t       _length = buffer_reader_varint(reader);
+    unsigned char* data    = reader->data + reader->position;
+
+    *length = 0;
+
+    if (reader->error) {
+        return NULL;
+    } else if ((uint64_t) (reader->length - reader->position) < _length) {
+        reader->error    = true;
+        reader->position = reader->length;
+
+        return NULL;
+    }
+
+    *length           = _length;
+    reader->position += _length;
+
+    return data;
+}
+
+bool buffer_reader_bytes (BufferReader* reader, unsigned char* data, int64_t length) {
+    assert(NULL != reader);
+    assert(NULL != data);
+    assert(0 <= length);
+
+    if (reader->length - reader->position < length) {
+        reader->error    = true;
+        reader->position = reader->length;
+
+        return false;
+    }
+
+    memcpy(data, reader->data + reader->position, length);
+
+    reader->position += length;
+
+    return true;
+}
+
+float buffer_reader_f32be (BufferReader* reader) {
+    uint32_t bits  = buffer_reader_u32be(reader);
+    float    value;
+
+    memcpy(&value, &bits, sizeof(float));
+
+    return value;
+}
+
+float buffer_reader_f32le (BufferReader* reader) {
+    uint32_t bits  = buffer_reader_u32le(reader);
+    float    value;
+
+    memcpy(&value, &bits, sizeof(float));
+
+    return value;
+}
+
+double buffer_reader_f64be (BufferReader* reader) {
+    uint64_t bits  = buffer_reader_u64be(reader);
+    double   value;
+
+    memcpy(&value, &bits, sizeof(double));
+
+    return value;
+}
+
+double buffer_reader_f64le (BufferReader* reader) {
+    uint64_t bits  = buffer_reader_u64le(reader);
+    double   value;
+
+    memcpy(&value, &bits, sizeof(double));
+
+    return value;
+}
+
+void buffer_reader_init (BufferReader* reader, Buffer* buffer) {
+    assert(NULL != reader);
+    assert(NULL != buffer);
+
+    reader->data     = buffer_data(buffer);
+    reader->error    = false;
+    reader->length   = buffer->length;
+    reader->position = 0;
+}
+
+int64_t buffer_reader_remaining (BufferReader* reader) {
+    assert(NULL != reader);
+
+    return reader->length - reader->position;
+}
+
+bool buffer_reader_require (BufferReader* reader, int64_t length) {
+    assert(NULL != reader);
+    assert(0 <= length);
+
+    if (reader->length - reader->position < length) {
+        reader->error = true;
+
+        return false;
+    }
+
+    return true;
+}
+
+int64_t buffer_reader_svarint (BufferReader* reader) {
+    uint64_t value = buffer_reader_varint(reader);
+
+    return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+}
+
+uint16_t buffer_reader_u16be (BufferReader* reader) {
+    __BUFFER_READER_FIXED(reader, uint16_t, __SERIAL_BE16);
+}
+
+uint16_t buffer_reader_u16le (BufferReader* reader) {
+    __BUFFER_READER_FIXED(reader, uint16_t, __SERIAL_LE16);
+}
+
+uint32_t buffer_reader_u32be (BufferReader* reader) {
+    __BUFFER_READER_FIXED(reader, uint32_t, __SERIAL_BE32);
+}
+
+uint32_t buffer_reader_u32le (BufferReader* reader) {
+    __BUFFER_READER_FIXED(reader, uint32_t, __SERIAL_LE32);
+}
+
+uint64_t buffer_reader_u64be (BufferReader* reader) {
+    __BUFFER_READER_FIXED(reader, uint64_t, __SERIAL_BE64);
+}
+
+uint64_t buffer_reader_u64le (BufferReader* reader) {
+    __BUFFER_READER_FIXED(reader, uint64_t, __SERIAL_LE64);
+}
+
+uint8_t buffer_reader_u8 (BufferReader* reader) {
+    assert(NULL != reader);
+
+    if (reader->position == reader->length) {
+        reader->error = true;
+
+        return 0;
+    }
+
+    return reader->data[reader->position++];
+}
+
+uint64_t buffer_reader_varint (BufferReader* reader) {
+    assert(NULL != reader);
+
+    unsigned char* data  = reader->data + reader->position;
+    int64_t        limit = reader->length - reader->position;
+    uint64_t       value = 0;
+
+    // a single bound covers both the bytes left to read and the most a varint may use
+    limit = BUFFER_VARINT_MAX < limit ? BUFFER_VARINT_MAX : limit;
+
+    for (int64_t i = 0; i < limit; i++) {
+        value |= (uint64_t) (data[i] & 0x7F) << (7 * i);
+
+        if (0 == (data[i] & 0x80)) {
+            // the tenth byte may only hold the top bit of the value
+            if (BUFFER_VARINT_MAX - 1 == i && 1 < data[i]) {
+                break;
+            }
+
+            reader->position += i + 1;
+
+            return value;
+        }
+    }
+
+    reader->error    = true;
+    reader->position = reader->length;
+
+    return 0;
+}
+
+bool buffer_writer_blob (BufferWriter* writer, unsigned char* data, int64_t length) {
+    assert(NULL != writer);
+    assert(0 <= length);
+
+    if (INT64_MAX - BUFFER_VARINT_MAX < length) {
+        return false;
+    }
+
+    __BUFFER_WRITER_ENSURE(writer, BUFFER_VARINT_MAX + length);
+
+    return buffer_writer_varint(writer, length) && buffer_writer_bytes(writer, data, length);
+}
+
+bool buffer_writer_bytes (BufferWriter* writer, unsigned char* data, int64_t length) {
+    assert(NULL != writer);
+    assert(0 <= length);
+
+    if (0 == length) {
+        return true;
+    }
+
+    assert(NULL != data);
+
+    return __buffer_writer_fixed(writer, data, length);
+}
+
+bool buffer_writer_f32be (BufferWriter* writer, float value) {
+    uint32_t bits;
+
+    memcpy(&bits, &value, sizeof(float));
+
+    return buffer_writer_u32be(writer, bits);
+}
+
+bool buffer_writer_f32le (BufferWriter* writer, float value) {
+    uint32_t bits;
+
+    memcpy(&bits, &value, sizeof(float));
+
+    return buffer_writer_u32le(writer, bits);
+}
+
+bool buffer_writer_f64be (BufferWriter* writer, double value) {
+    uint64_t bits;
+
+    memcpy(&bits, &value, sizeof(double));
+
+    return buffer_writer_u64be(writer, bits);
+}
+
+bool buffer_writer_f64le (BufferWriter* writer, double value) {
+    uint64_t bits;
+
+    memcpy(&bits, &value, sizeof(double));
+
+    return buffer_writer_u64le(writer, bits);
+}
+
+void buffer_writer_init (BufferWriter* writer, Buffer* buffer) {
+    assert(NULL != writer);
+    assert(NULL != buffer);
+
+    // writes go directly onto the end of the data, so a gap must be closed first
+    buffer_data(buffer);
+
+    writer->buffer = buffer;
+}
+
+bool buffer_writer_reserve (BufferWriter* writer, int64_t length) {
+    assert(NULL != writer);
+    assert(0 <= length);
+
+    __BUFFER_WRITER_ENSURE(writer, length);
+
+    return true;
+}
+
+bool buffer_writer_svarint (BufferWriter* writer, int64_t value) {
+    return buffer_writer_varint(writer, ((uint64_t) value << 1) ^ (uint64_t) (value >> 63));
+}
+
+bool buffer_writer_u16be (BufferWriter* writer, uint16_t value) {
+    __BUFFER_WRITER_FIXED(writer, uint16_t, __SERIAL_BE16, value);
+}
+
+bool buffer_writer_u16le (BufferWriter* writer, uint16_t value) {
+    __BUFFER_WRITER_FIXED(writer, uint16_t, __SERIAL_LE16, value);
+}
+
+bool buffer_writer_u32be (BufferWriter* writer, uint32_t value) {
+    __BUFFER_WRITER_FIXED(writer, uint32_t, __SERIAL_BE32, value);
+}
+
+bool buffer_writer_u32le (BufferWriter* writer, uint32_t value) {
+    __BUFFER_WRITER_FIXED(writer, uint32_t, __SERIAL_LE32, value);
+}
+
+bool buffer_writer_u64be (BufferWriter* writer, uint64_t value) {
+    __BUFFER_WRITER_FIXED(writer, uint64_t, __SERIAL_BE64, value);
+}
+
+bool buffer_writer_u64le (BufferWriter* writer, uint64_t value) {
+    __BUFFER_WRITER_FIXED(writer, uint64_t, __SERIAL_LE64, value);
+}
+
+bool buffer_writer_u8 (BufferWriter* writer, uint8_t value) {
+    assert(NULL != writer);
+
+    __BUFFER_WRITER_ENSURE(writer, 1);
+
+    writer->buffer->data[writer->buffer->length++] = value;
+
+    return true;
+}
+
+bool buffer_writer_varint (BufferWriter* writer, uint64_t value) {
+    assert(NULL != writer);
+
+    __BUFFER_WRITER_ENSURE(writer, BUFFER_VARINT_MAX);
+
+    unsigned char* data = writer->buffer->data + writer->buffer->length;
+    unsigned char* ptr  = data;
+
+    for (; 0x80 <= value; value >>= 7) {
+        *ptr++ = (unsigned char) value | 0x80;
+    }
+
+    *ptr++ = (unsigned char) value;
+
+    writer->buffer->length += ptr - data;
+
+    return true;
+}
@@ -10,15 +10,34 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#define __CODEBOX_X86
+#include <immintrin.h>
+#endif
+
 #include "codebox/container/table.h"
+#include "codebox/cpu.h"
 
 // -------------------------------------------------------------------------------------------------
 // MACROS
 // -------------------------------------------------------------------------------------------------
 
+#define __TABLE_HASH(__table, __key, __length) \
+    (NULL != __table->hash64_func \
+     ? __table->hash64_func(__key, __length) \
+     : (uint64_t) __table->hash_func(__key, __length))
+
+// 32-bit tables stop growing at primes[25], 64-bit tables continue through the full list
+#define __TABLE_PRIME_COUNT_32 26
+
+#define __TABLE_PRIME_COUNT(__table) \
+    (NULL != __table->hash64_func \
+     ? sizeof(primes) / sizeof(primes[0]) \
+     : __TABLE_PRIME_COUNT_32)
+
 #define __TABLE_GET(__bucket, __table, __key, __length) \
     { \
-        uint32_t __hash = __table->hash_func(__key, __length); \
+        uint64_t __hash = __TABLE_HASH(__table, __key, __length); \
         __bucket = *(__table->buckets + (__hash % __table->bucket_count)); \
         for (; NULL != __bucket; __bucket = __bucket->next) { \
             if (__bucket->hashcode == __hash && \
@@ -32,10 +51,275 @@
 // STATIC VARIABLES
 // -------------------------------------------------------------------------------------------------
 
-static int32_t primes[26] = { 53, 97, 193, 389, 769, 1543, 3079, 6151, 12289, 24593, 49157, 98317,
+// the widest key comparison the processor supports, selected on first use
+static bool (*__compare_func) (unsigned char* key1, unsigned char* key2, int32_t length) = NULL;
+
+static int64_t primes[36] = { 53, 97, 193, 389, 769, 1543, 3079, 6151, 12289, 24593, 49157, 98317,
                               196613, 393241, 786433, 1572869, 3145739, 6291469, 12582917,
                               25165843, 50331653, 100663319, 201326611, 402653189, 805306457,
-                              1610612741 };
+                              1610612741, 3221225473, 6442450967, 12884901893, 25769803799,
+                              51539607599, 103079215111, 206158430209, 412316860441,
+                              824633720837, 1649267441681 };
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Compare two keys of the same length shorter than 16 bytes.
+ */
+static bool __compare_short (unsigned char* key1, unsigned char* key2, int32_t length) {
+    if (8 <= length) {
+        uint64_t a1, a2, b1, b2;
+
+        // the second pair of words overlaps the first when the length is under 16
+        memcpy(&a1, key1, 8);
+        memcpy(&b1, key2, 8);
+        memcpy(&a2, key1 + length - 8, 8);
+        memcpy(&b2, key2 + length - 8, 8);
+
+        return a1 == b1 && a2 == b2;
+    } else if (4 <= length) {
+        uint32_t a1, a2, b1, b2;
+
+        memcpy(&a1, key1, 4);
+        memcpy(&b1, key2, 4);
+        memcpy(&a2, key1 + length - 4, 4);
+        memcpy(&b2, key2 + length - 4, 4);
+
+        return a1 == b1 && a2 == b2;
+    }
+
+    for (int32_t i = 0; i < length; i++) {
+        if (key1[i] != key2[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Compare two keys of the same length of at least 16 bytes, 16 bytes at a time.
+ */
+static bool __compare_vector (unsigned char* key1, unsigned char* key2, int32_t length) {
+#ifdef __SSE2__
+    int32_t i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        __m128i a = _mm_loadu_si128((__m128i*) (key1 + i));
+        __m128i b = _mm_loadu_si128((__m128i*) (key2 + i));
+
+        if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi8(a, b))) {
+            return false;
+        }
+    }
+
+    if (i < length) {
+        // compare the tail with one overlapping load ending on the last byte
+        __m128i a = _mm_loadu_si128((__m128i*) (key1 + length - 16));
+        __m128i b = _mm_loadu_si128((__m128i*) (key2 + length - 16));
+
+        return 0xFFFF == _mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+    }
+
+    return true;
+#else
+    return 0 == memcmp(key1, key2, length);
+#endif
+}
+
+#ifdef __CODEBOX_X86
+/**
+ * Compare two keys of the same length of at least 16 bytes, 32 bytes at a time.
+ */
+__attribute__((target("avx2")))
+static bool __compare_avx2 (unsigned char* key1, unsigned char* key2, int32_t length) {
+    if (length < 32) {
+        return __compare_vector(key1, key2, length);
+    }
+
+    int32_t i = 0;
+
+    for (; i + 32 <= length; i += 32) {
+        __m256i a = _mm256_loadu_si256((__m256i*) (key1 + i));
+        __m256i b = _mm256_loadu_si256((__m256i*) (key2 + i));
+
+        if (-1 != _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b))) {
+            return false;
+        }
+    }
+
+    if (i < length) {
+        __m256i a = _mm256_loadu_si256((__m256i*) (key1 + length - 32));
+        __m256i b = _mm256_loadu_si256((__m256i*) (key2 + length - 32));
+
+        return -1 == _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+    }
+
+    return true;
+}
+#endif
+
+/**
+ * Copy a key/value pair into a thread-safe iterator.
+ */
+static bool __table_iter_push (TableIterator* iter, unsigned char* key, void* value) {
+    if (iter->count == iter->size) {
+        int32_t         size = 0 == iter->size ? __TABLE_SMALL_COUNT : iter->size * 2;
+        unsigned char** keys = (unsigned char**) realloc(iter->keys,
+                                                         size * sizeof(unsigned char*));
+
+        if (NULL == keys) {
+            return false;
+        }
+
+        iter->keys = keys;
+
+        void** values = (void**) realloc(iter->values, size * sizeof(void*));
+
+        if (NULL == values) {
+            return false;
+        }
+
+        iter->values = values;
+        iter->size   = size;
+    }
+
+    iter->keys[iter->count]   = key;
+    iter->values[iter->count] = value;
+    iter->count++;
+
+    return true;
+}
+
+/**
+ * Find the inline slot holding a key, or -1 if the key is not present.
+ */
+static int32_t __table_small_find (Table* table, uint64_t hash, unsigned char* key,
+                                   int32_t length) {
+    uint32_t mask = 0;
+
+#ifdef __SSE2__
+    __m128i needle = _mm_set1_epi64x((long long) hash);
+
+    for (int32_t i = 0; i < __TABLE_SMALL_COUNT; i += 2) {
+        __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((__m128i*) (table->small_hashcodes + i)),
+                                     needle);
+
+        // both 32-bit halves must match for the 64-bit lane to match
+        eq    = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+        mask |= (uint32_t) _mm_movemask_pd(_mm_castsi128_pd(eq)) << i;
+    }
+#else
+    for (int32_t i = 0; i < __TABLE_SMALL_COUNT; i++) {
+        mask |= (uint32_t) (table->small_hashcodes[i] == hash) << i;
+    }
+#endif
+
+    mask &= (1U << table->key_count) - 1;
+
+    for (; 0 != mask; mask &= mask - 1) {
+        int32_t i = __builtin_ctz(mask);
+
+        if (table->comp_func(table->small_keys[i], table->small_lengths[i], key, length)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Move the inline entries of a small table into a newly allocated bucket array.
+ */
+static bool __table_small_spill (Table* table) {
+    Bucket*  nodes[__TABLE_SMALL_COUNT];
+    Bucket** buckets = (Bucket**) malloc(table->bucket_count * sizeof(Bucket*));
+
+    if (NULL == buckets) {
+        return false;
+    }
+
+    memset(buckets, 0, table->bucket_count * sizeof(Bucket*));
+
+    for (int32_t i = 0; i < table->key_count; i++) {
+        nodes[i] = (Bucket*) malloc(sizeof(Bucket));
+
+        if (NULL == nodes[i]) {
+            for (; 0 < i; i--) {
+                free(nodes[i - 1]);
+            }
+
+            free(buckets);
+
+            return false;
+        }
+    }
+
+    for (int32_t i = 0; i < table->key_count; i++) {
+        Bucket** bucket = buckets + (table->small_hashcodes[i] % table->bucket_count);
+
+        for (; NULL != *bucket; bucket = &((*bucket)->next));
+
+        *bucket             = nodes[i];
+        (*bucket)->key      = table->small_keys[i];
+        (*bucket)->length   = table->small_lengths[i];
+        (*bucket)->hashcode = table->small_hashcodes[i];
+        (*bucket)->next     = NULL;
+        (*bucket)->value    = table->small_values[i];
+    }
+
+    table->buckets = buckets;
+
+    return true;
+}
+
+/**
+ * Initialize a table with whichever of the 32-bit and 64-bit hash functions is not NULL.
+ */
+static bool __table_init (Table* table, int64_t bucket_count, float load_factor,
+                          bool (*comp_func) (unsigned char* key1, int32_t length1,
+                                             unsigned char* key2, int32_t length2),
+                          uint32_t (*hash_func) (unsigned char* key, int32_t length),
+                          uint64_t (*hash64_func) (unsigned char* key, int32_t length),
+                          bool thread_safe) {
+    table->hash_func   = hash_func;
+    table->hash64_func = hash64_func;
+
+    for (int8_t i = 0, length = __TABLE_PRIME_COUNT(table); i < length; i++) {
+        if (bucket_count <= primes[i] || i + 1 == length) {
+            table->bucket_count = primes[i];
+            break;
+        }
+    }
+
+    // tables starting at the default size hold their first keys inline
+    if (__TABLE_DEFAULT_BUCKET_COUNT < table->bucket_count) {
+        table->buckets = (Bucket**) malloc(table->bucket_count * sizeof(Bucket*));
+
+        if (NULL == table->buckets) {
+            return false;
+        }
+
+        memset(table->buckets, 0, table->bucket_count * sizeof(Bucket*));
+    }
+
+    table->comp_func    = comp_func;
+    table->iter_count   = 0;
+    table->key_count    = 0;
+    table->load_factor  = load_factor;
+    table->mutex        = NULL;
+    table->resize_count = (int64_t) (table->bucket_count * table->load_factor);
+
+    if (thread_safe) {
+        table->mutex = (pthread_mutex_t*) malloc(sizeof(pthread_mutex_t));
+
+        pthread_mutex_init(table->mutex, NULL);
+    }
+
+    return true;
+}
 
 // -------------------------------------------------------------------------------------------------
 // FUNCTIONS
@@ -46,13 +330,30 @@ bool compare_binary (unsigned char* key1, int32_t length1,
     assert(0 < length1);
     assert(0 < length2);
 
-    for (int i = 0; i < length1 && i < length2; i++, key1++, key2++) {
-        if (*key1 != *key2) {
-            return false;
+    if (length1 != length2) {
+        return false;
+    } else if (key1 == key2) {
+        return true;
+    } else if (length1 < 16) {
+        return __compare_short(key1, key2, length1);
+    }
+
+    bool (*func) (unsigned char*, unsigned char*, int32_t) = __atomic_load_n(&__compare_func,
+                                                                             __ATOMIC_RELAXED);
+
+    if (NULL == func) {
+        func = __compare_vector;
+
+#ifdef __CODEBOX_X86
+        if (cpu_has_avx2()) {
+            func = __compare_avx2;
         }
+#endif
+
+        __atomic_store_n(&__compare_func, func, __ATOMIC_RELAXED);
     }
 
-    return true;
+    return func(key1, key2, length1);
 }
 
 uint32_t hash_djb2 (unsigned char* bytes, int32_t length) {
@@ -67,11 +368,25 @@ uint32_t hash_djb2 (unsigned char* bytes, int32_t length) {
     return hash;
 }
 
+uint64_t hash_fnv1a_64 (unsigned char* bytes, int32_t length) {
+    assert(0 < length);
+
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (int i = 0; i < length; i++, bytes++) {
+        hash ^= *bytes;
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
 bool table_cleanup (Table* table) {
     assert(NULL != table);
-    assert(NULL != table->buckets);
 
-    free(table->buckets);
+    if (NULL != table->buckets) {
+        free(table->buckets);
+    }
 
     if (NULL != table->mutex) {
         pthread_mutex_destroy(table->mutex);
@@ -86,6 +401,12 @@ void* table_get (Table* table, unsigned char* key, int32_t length) {
     assert(NULL != key);
     assert(0 < length);
 
+    if (NULL == table->buckets) {
+        int32_t i = __table_small_find(table, __TABLE_HASH(table, key, length), key, length);
+
+        return -1 != i ? table->small_values[i] : NULL;
+    }
+
     Bucket* bucket = NULL;
 
     __TABLE_GET(bucket, table, key, length);
@@ -111,6 +432,10 @@ bool table_has_key (Table* table, unsigned char* key, int32_t length) {
     assert(NULL != key);
     assert(0 < length);
 
+    if (NULL == table->buckets) {
+        return -1 != __table_small_find(table, __TABLE_HASH(table, key, length), key, length);
+    }
+
     Bucket* bucket = NULL;
 
     __TABLE_GET(bucket, table, key, length);
@@ -131,7 +456,7 @@ bool table_has_key_ts (Table* table, unsigned char* key, int32_t length) {
     return ret;
 }
 
-bool table_init (Table* table, int32_t bucket_count, float load_factor,
+bool table_init (Table* table, int64_t bucket_count, float load_factor,
                  bool (*comp_func) (unsigned char* key1, int32_t length1,
                                     unsigned char* key2, int32_t length2),
                  uint32_t (*hash_func) (unsigned char* key, int32_t length),
@@ -141,35 +466,21 @@ bool table_init (Table* table, int32_t bucket_count, float load_factor,
     assert(NULL != comp_func);
     assert(NULL != hash_func);
 
-    for (int8_t i = 0, length = sizeof(primes) / sizeof(primes[0]); i < length; i++) {
-        if (bucket_count <= primes[i] || i + 1 == length) {
-            table->bucket_count = primes[i];
-            break;
-        }
-    }
-
-    table->buckets = (Bucket**) malloc(table->bucket_count * sizeof(Bucket*));
-
-    if (NULL == table->buckets) {
-        return false;
-    }
-
-    memset(table->buckets, 0, table->bucket_count * sizeof(Bucket*));
-
-    table->comp_func    = comp_func;
-    table->hash_func    = hash_func;
-    table->key_count    = 0;
-    table->load_factor  = load_factor;
-    table->mutex        = NULL;
-    table->resize_count = (int32_t) (table->bucket_count * table->load_factor);
-
-    if (thread_safe) {
-        table->mutex = (pthread_mutex_t*) malloc(sizeof(pthread_mutex_t));
+    return __table_init(table, bucket_count, load_factor, comp_func, hash_func, NULL, thread_safe);
+}
 
-        pthread_mutex_init(table->mutex, NULL);
-    }
+bool table_init_64 (Table* table, int64_t bucket_count, float load_factor,
+                    bool (*comp_func) (unsigned char* key1, int32_t length1,
+                                       unsigned char* key2, int32_t length2),
+                    uint64_t (*hash64_func) (unsigned char* key, int32_t length),
+                    bool thread_safe) {
+    assert(NULL != table);
+    assert(NULL == table->buckets);
+    assert(NULL != comp_func);
+    assert(NULL != hash64_func);
 
-    return true;
+    return __table_init(table, bucket_count, load_factor, comp_func, NULL, hash64_func,
+                        thread_safe);
 }
 
 bool table_init_defaults (Table* table) {
@@ -190,18 +501,95 @@ bool table_init_defaults_ts (Table* table) {
                       true);
 }
 
+bool table_init_defaults_64 (Table* table) {
+    return table_init_64(table,
+                         __TABLE_DEFAULT_BUCKET_COUNT,
+                         __TABLE_DEFAULT_LOAD_FACTOR,
+                         __TABLE_DEFAULT_COMP_FUNC,
+                         __TABLE_DEFAULT_HASH64_FUNC,
+                         false);
+}
+
+bool table_init_defaults_64_ts (Table* table) {
+    return table_init_64(table,
+                         __TABLE_DEFAULT_BUCKET_COUNT,
+                         __TABLE_DEFAULT_LOAD_FACTOR,
+                         __TABLE_DEFAULT_COMP_FUNC,
+                         __TABLE_DEFAULT_HASH64_FUNC,
+                         true);
+}
+
+void table_iter_cleanup_ts (TableIterator* iter) {
+    assert(NULL != iter);
+    assert(iter->thread_safe);
+    assert(NULL != iter->table->mutex);
+
+    Table* table = iter->table;
+
+    pthread_mutex_lock(table->mutex);
+
+    if (0 == --table->iter_count && NULL != table->buckets &&
+        table->key_count >= table->resize_count) {
+        table_resize(table, table->bucket_count + 1);
+    }
+
+    pthread_mutex_unlock(table->mutex);
+
+    free(iter->keys);
+    free(iter->values);
+
+    iter->keys   = NULL;
+    iter->values = NULL;
+    iter->count  = 0;
+    iter->size   = 0;
+}
+
 void table_iter_init (TableIterator* iter, Table* table) {
     assert(NULL != iter);
     assert(NULL != table);
-    assert(NULL != table->buckets);
 
     iter->bucket       = NULL;
     iter->bucket_index = -1;
+    iter->count        = 0;
+    iter->index        = 0;
+    iter->keys         = NULL;
+    iter->size         = 0;
     iter->table        = table;
+    iter->thread_safe  = false;
+    iter->values       = NULL;
+}
+
+void table_iter_init_ts (TableIterator* iter, Table* table) {
+    assert(NULL != iter);
+    assert(NULL != table);
+    assert(NULL != table->mutex);
+
+    table_iter_init(iter, table);
+
+    iter->thread_safe = true;
+
+    pthread_mutex_lock(table->mutex);
+
+    table->iter_count++;
+
+    pthread_mutex_unlock(table->mutex);
 }
 
 void* table_iter_key (TableIterator* iter) {
     assert(NULL != iter);
+
+    if (iter->thread_safe) {
+        assert(iter->index < iter->count);
+
+        return iter->keys[iter->index];
+    }
+
+    if (NULL == iter->table->buckets) {
+        assert(0 <= iter->bucket_index && iter->bucket_index < iter->table->key_count);
+
+        return iter->table->small_keys[iter->bucket_index];
+    }
+
     assert(NULL != iter->bucket);
 
     return iter->bucket->key;
@@ -210,6 +598,10 @@ void* table_iter_key (TableIterator* iter) {
 bool table_iter_next (TableIterator* iter) {
     assert(NULL != iter);
 
+    if (NULL == iter->table->buckets) {
+        return ++iter->bucket_index < iter->table->key_count;
+    }
+
     if (-1 == iter->bucket_index) {
         iter->bucket       = *iter->table->buckets;
         iter->bucket_index = 0;
@@ -235,26 +627,79 @@ bool table_iter_next (TableIterator* iter) {
     return true;
 }
 
+bool table_iter_next_ts (TableIterator* iter) {
+    assert(NULL != iter);
+    assert(iter->thread_safe);
+
+    if (++iter->index < iter->count) {
+        return true;
+    }
+
+    Table* table = iter->table;
+    bool   ret   = true;
+
+    iter->count = 0;
+    iter->index = 0;
+
+    pthread_mutex_lock(table->mutex);
+
+    if (NULL == table->buckets) {
+        // a small table is copied whole, since it reorders pairs on removal
+        if (-1 == iter->bucket_index) {
+            for (int32_t i = 0; ret && i < table->key_count; i++) {
+                ret = __table_iter_push(iter, table->small_keys[i], table->small_values[i]);
+            }
+        }
+
+        iter->bucket_index = table->bucket_count;
+    } else {
+        while (ret && 0 == iter->count && ++iter->bucket_index < table->bucket_count) {
+            Bucket* bucket = *(table->buckets + iter->bucket_index);
+
+            for (; ret && NULL != bucket; bucket = bucket->next) {
+                ret = __table_iter_push(iter, bucket->key, bucket->value);
+            }
+        }
+    }
+
+    pthread_mutex_unlock(table->mutex);
+
+    return ret && 0 < iter->count;
+}
+
 void* table_iter_value (TableIterator* iter) {
     assert(NULL != iter);
+
+    if (iter->thread_safe) {
+        assert(iter->index < iter->count);
+
+        return iter->values[iter->index];
+    }
+
+    if (NULL == iter->table->buckets) {
+        assert(0 <= iter->bucket_index && iter->bucket_index < iter->table->key_count);
+
+        return iter->table->small_values[iter->bucket_index];
+    }
+
     assert(NULL != iter->bucket);
 
     return iter->bucket->value;
 }
 
-int32_t table_key_count (Table* table) {
+int64_t table_key_count (Table* table) {
     assert(NULL != table);
 
     return table->key_count;
 }
 
-int32_t table_key_count_ts (Table* table) {
+int64_t table_key_count_ts (Table* table) {
     assert(NULL != table);
     assert(NULL != table->mutex);
 
     pthread_mutex_lock(table->mutex);
 
-    int32_t ret = table->key_count;
+    int64_t ret = table->key_count;
 
     pthread_mutex_unlock(table->mutex);
 
@@ -285,11 +730,28 @@ bool table_put (Table* table, unsigned char* key, int32_t length, void* value) {
     assert(NULL != key);
     assert(0 < length);
 
-    if (table->key_count == table->resize_count) {
+    uint64_t hash = __TABLE_HASH(table, key, length);
+
+    if (NULL == table->buckets) {
+        if (table->key_count < __TABLE_SMALL_COUNT) {
+            table->small_hashcodes[table->key_count] = hash;
+            table->small_keys[table->key_count]      = key;
+            table->small_lengths[table->key_count]   = length;
+            table->small_values[table->key_count]    = value;
+            table->key_count++;
+
+            return true;
+        }
+
+        if (!__table_small_spill(table)) {
+            return false;
+        }
+    }
+
+    if (table->key_count >= table->resize_count && 0 == table->iter_count) {
         table_resize(table, table->bucket_count + 1);
     }
 
-    uint32_t hash   = table->hash_func(key, length);
     Bucket** bucket = table->buckets + (hash % table->bucket_count);
 
     for (; NULL != *bucket; bucket = &((*bucket)->next));
@@ -328,7 +790,26 @@ void* table_remove (Table* table, unsigned char* key, int32_t length) {
     assert(NULL != table);
     assert(0 < length);
 
-    uint32_t hash   = table->hash_func(key, length);
+    uint64_t hash = __TABLE_HASH(table, key, length);
+
+    if (NULL == table->buckets) {
+        int32_t i = __table_small_find(table, hash, key, length);
+
+        if (-1 == i) {
+            return NULL;
+        }
+
+        void*   value = table->small_values[i];
+        int32_t last  = --table->key_count;
+
+        table->small_hashcodes[i] = table->small_hashcodes[last];
+        table->small_keys[i]      = table->small_keys[last];
+        table->small_lengths[i]   = table->small_lengths[last];
+        table->small_values[i]    = table->small_values[last];
+
+        return value;
+    }
+
     Bucket** bucket = table->buckets + (hash % table->bucket_count);
 
     for (; NULL != *bucket; bucket = &((*bucket)->next)) {
@@ -361,21 +842,41 @@ void* table_remove_ts (Table* table, unsigned char* key, int32_t length) {
     return ret;
 }
 
-bool table_resize (Table* table, int32_t bucket_count) {
+bool table_resize (Table* table, int64_t bucket_count) {
     assert(NULL != table);
     assert(0 < bucket_count);
 
-    for (int8_t i = 0, length = sizeof(primes) / sizeof(primes[0]); i < length; i++) {
+    if (0 < table->iter_count) {
+        return false;
+    }
+
+    for (int8_t i = 0, length = __TABLE_PRIME_COUNT(table); i < length; i++) {
         if (bucket_count <= primes[i] || i + 1 == length) {
             bucket_count = primes[i];
             break;
         }
     }
 
-    if (bucket_count == primes[(sizeof(primes) / sizeof(primes[0])) - 1]) {
+    if (bucket_count == primes[__TABLE_PRIME_COUNT(table) - 1]) {
         return false;
     }
 
+    if (NULL == table->buckets) {
+        int64_t old_count = table->bucket_count;
+
+        table->bucket_count = bucket_count;
+
+        if (!__table_small_spill(table)) {
+            table->bucket_count = old_count;
+
+            return false;
+        }
+
+        table->resize_count = (int64_t) (table->bucket_count * table->load_factor);
+
+        return true;
+    }
+
     Bucket** buckets = (Bucket**) malloc(bucket_count * sizeof(Bucket*));
 
     if (NULL == buckets) {
@@ -387,7 +888,7 @@ bool table_resize (Table* table, int32_t bucket_count) {
     Bucket*  old_bucket  = *(table->buckets);
     Bucket** new_bucket  = NULL;
 
-    for (int32_t i = 0; i < table->bucket_count; i++) {
+    for (int64_t i = 0; i < table->bucket_count; i++) {
         old_bucket = *(table->buckets + i);
 
         while (NULL != old_bucket) {
@@ -405,12 +906,12 @@ bool table_resize (Table* table, int32_t bucket_count) {
 
     table->buckets      = buckets;
     table->bucket_count = bucket_count;
-    table->resize_count = (int32_t) (table->bucket_count * table->load_factor);
+    table->resize_count = (int64_t) (table->bucket_count * table->load_factor);
 
     return true;
 }
 
-bool table_resize_ts (Table* table, int32_t bucket_count) {
+bool table_resize_ts (Table* table, int64_t bucket_count) {
     assert(NULL != table);
     assert(NULL != table->mutex);
 
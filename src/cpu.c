@@ -0,0 +1,43 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#include "codebox/cpu.h"
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+bool cpu_has_avx2 () {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+bool cpu_has_sse42 () {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+
+    return __builtin_cpu_supports("sse4.2");
+#else
+    return false;
+#endif
+}
+
+bool cpu_has_ssse3 () {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+
+    return __builtin_cpu_supports("ssse3");
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,736 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define __CODEBOX_X86
+#include <immintrin.h>
+#endif
+
+#include "codebox/cpu.h"
+#include "codebox/encoding.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+// the instruction sets the kernels are selected from
+#define __ENCODING_UNKNOWN -1
+#define __ENCODING_SCALAR  0
+#define __ENCODING_SSSE3   1
+#define __ENCODING_AVX2    2
+
+// the bytes the vector decoders may store past the end of their output
+#define __ENCODING_SLACK 8
+
+// -------------------------------------------------------------------------------------------------
+// STATIC VARIABLES
+// -------------------------------------------------------------------------------------------------
+
+static const char* __BASE64_STANDARD =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static const char* __BASE64_URL =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+static const char* __HEX_DIGITS = "0123456789abcdef";
+
+#ifdef __CODEBOX_X86
+static int32_t __encoding_isa = __ENCODING_UNKNOWN;
+#endif
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Decode complete quartets of base64 data, and a final pair or triple, returning the count of
+ * bytes written or -1 when the data is not valid.
+ */
+static int64_t __base64_decode_scalar (unsigned char* dest, unsigned char* data, int64_t length,
+                                       const char* chars) {
+    unsigned char* ptr = dest;
+    int8_t         values[256];
+    int32_t        a, b, c, d;
+    int64_t        i   = 0;
+
+    memset(values, -1, sizeof(values));
+
+    for (int32_t j = 0; j < 64; j++) {
+        values[(unsigned char) chars[j]] = j;
+    }
+
+    if (0 < length && 0 == length % 4 && '=' == data[length - 1]) {
+        length -= '=' == data[length - 2] ? 2 : 1;
+    }
+
+    if (1 == length % 4) {
+        return -1;
+    }
+
+    for (; i + 4 <= length; i += 4) {
+        a = values[data[i]];
+        b = values[data[i + 1]];
+        c = values[data[i + 2]];
+        d = values[data[i + 3]];
+
+        if (0 > (a | b | c | d)) {
+            return -1;
+        }
+
+        *ptr++ = (unsigned char) (a << 2 | b >> 4);
+        *ptr++ = (unsigned char) (b << 4 | c >> 2);
+        *ptr++ = (unsigned char) (c << 6 | d);
+    }
+
+    if (i < length) {
+        a = values[data[i]];
+        b = values[data[i + 1]];
+        c = i + 2 < length ? values[data[i + 2]] : 0;
+
+        if (0 > (a | b | c)) {
+            return -1;
+        }
+
+        *ptr++ = (unsigned char) (a << 2 | b >> 4);
+
+        if (i + 2 < length) {
+            *ptr++ = (unsigned char) (b << 4 | c >> 2);
+        }
+    }
+
+    return ptr - dest;
+}
+
+/**
+ * Encode byte triples as base64, then the final pair or byte, returning the count of bytes
+ * written.
+ */
+static int64_t __base64_encode_scalar (unsigned char* dest, unsigned char* data, int64_t length,
+                                       const char* chars, bool pad) {
+    unsigned char* ptr = dest;
+    uint32_t       value;
+    int64_t        i   = 0;
+
+    for (; i + 3 <= length; i += 3) {
+        value  = (uint32_t) data[i] << 16 | (uint32_t) data[i + 1] << 8 | data[i + 2];
+        ptr[0] = chars[value >> 18];
+        ptr[1] = chars[value >> 12 & 0x3F];
+        ptr[2] = chars[value >> 6 & 0x3F];
+        ptr[3] = chars[value & 0x3F];
+        ptr   += 4;
+    }
+
+    if (i < length) {
+        value  = (uint32_t) data[i] << 16 | (i + 1 < length ? (uint32_t) data[i + 1] << 8 : 0);
+        *ptr++ = chars[value >> 18];
+        *ptr++ = chars[value >> 12 & 0x3F];
+
+        if (i + 1 < length) {
+            *ptr++ = chars[value >> 6 & 0x3F];
+        } else if (pad) {
+            *ptr++ = '=';
+        }
+
+        if (pad) {
+            *ptr++ = '=';
+        }
+    }
+
+    return ptr - dest;
+}
+
+#ifdef __CODEBOX_X86
+/**
+ * Decode blocks of 16 base64 characters into 12 bytes until a block holds padding or a character
+ * outside the alphabet, returning the count of characters decoded.
+ *
+ * Each character is classified by its range in the alphabet, which also gives the offset that
+ * translates it to its 6-bit value, and the values are packed together by two multiply-adds.
+ */
+__attribute__((target("ssse3")))
+static int64_t __base64_decode_ssse3 (unsigned char* dest, unsigned char* data, int64_t length,
+                                      const char* chars) {
+    __m128i char62 = _mm_set1_epi8(chars[62]);
+    __m128i char63 = _mm_set1_epi8(chars[63]);
+    __m128i pack   = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    int64_t i      = 0;
+
+    for (; i + 16 <= length; i += 16, dest += 12) {
+        __m128i in    = _mm_loadu_si128((__m128i*) (data + i));
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('A' - 1)),
+                                      _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), in));
+        __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('a' - 1)),
+                                      _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), in));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)),
+                                      _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), in));
+        __m128i is62  = _mm_cmpeq_epi8(in, char62);
+        __m128i is63  = _mm_cmpeq_epi8(in, char63);
+        __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                                     _mm_or_si128(digit, _mm_or_si128(is62, is63)));
+
+        if (0xFFFF != _mm_movemask_epi8(valid)) {
+            break;
+        }
+
+        __m128i shift = _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                         _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+            _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+                         _mm_or_si128(_mm_and_si128(is62, _mm_set1_epi8(62 - chars[62])),
+                                      _mm_and_si128(is63, _mm_set1_epi8(63 - chars[63])))));
+
+        // 00aaaaaa 00bbbbbb 00cccccc 00dddddd -> aaaaaabb bbbbcccc ccdddddd
+        __m128i merged = _mm_madd_epi16(_mm_maddubs_epi16(_mm_add_epi8(in, shift),
+                                                          _mm_set1_epi32(0x01400140)),
+                                        _mm_set1_epi32(0x00011000));
+
+        _mm_storeu_si128((__m128i*) dest, _mm_shuffle_epi8(merged, pack));
+    }
+
+    return i;
+}
+
+/**
+ * Decode blocks of 32 base64 characters into 24 bytes, leaving the rest to the SSSE3 decoder.
+ */
+__attribute__((target("avx2")))
+static int64_t __base64_decode_avx2 (unsigned char* dest, unsigned char* data, int64_t length,
+                                     const char* chars) {
+    __m256i char62 = _mm256_set1_epi8(chars[62]);
+    __m256i char63 = _mm256_set1_epi8(chars[63]);
+    __m256i pack   = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    __m256i join   = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+    int64_t i      = 0;
+
+    for (; i + 32 <= length; i += 32, dest += 24) {
+        __m256i in    = _mm256_loadu_si256((__m256i*) (data + i));
+        __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('A' - 1)),
+                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), in));
+        __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('a' - 1)),
+                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), in));
+        __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('0' - 1)),
+                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), in));
+        __m256i is62  = _mm256_cmpeq_epi8(in, char62);
+        __m256i is63  = _mm256_cmpeq_epi8(in, char63);
+        __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower),
+                                        _mm256_or_si256(digit, _mm256_or_si256(is62, is63)));
+
+        if (-1 != _mm256_movemask_epi8(valid)) {
+            break;
+        }
+
+        __m256i shift = _mm256_or_si256(
+            _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+                            _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a'))),
+            _mm256_or_si256(_mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')),
+                            _mm256_or_si256(_mm256_and_si256(is62, _mm256_set1_epi8(62 - chars[62])),
+                                            _mm256_and_si256(is63, _mm256_set1_epi8(63 - chars[63])))));
+
+        __m256i merged = _mm256_madd_epi16(_mm256_maddubs_epi16(_mm256_add_epi8(in, shift),
+                                                                _mm256_set1_epi32(0x01400140)),
+                                           _mm256_set1_epi32(0x00011000));
+
+        // each lane packs 12 bytes, which are joined into the first 24
+        _mm256_storeu_si256((__m256i*) dest,
+                            _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(merged, pack), join));
+    }
+
+    return i + __base64_decode_ssse3(dest, data + i, length - i, chars);
+}
+
+/**
+ * Encode blocks of 12 bytes into 16 base64 characters while 16 bytes can be loaded, returning the
+ * count of bytes encoded.
+ *
+ * Each byte triple is spread over a 32-bit lane, its four 6-bit indices are moved into place by two
+ * multiplies, and each index is translated by an offset looked up by its range in the alphabet.
+ */
+__attribute__((target("ssse3")))
+static int64_t __base64_encode_ssse3 (unsigned char* dest, unsigned char* data, int64_t length,
+                                      const char* chars) {
+    __m128i spread  = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                    '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                    chars[62] - 62, chars[63] - 63, 'A', 0, 0);
+    int64_t i       = 0;
+
+    for (; i + 16 <= length; i += 12, dest += 16) {
+        __m128i in      = _mm_shuffle_epi8(_mm_loadu_si128((__m128i*) (data + i)), spread);
+        __m128i indices = _mm_or_si128(
+            _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)),
+                            _mm_set1_epi32(0x04000040)),
+            _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)),
+                            _mm_set1_epi32(0x01000010)));
+
+        // 0-25 -> 13, 26-51 -> 0, 52-61 -> 1-10, 62 -> 11, 63 -> 12
+        __m128i range   = _mm_or_si128(_mm_subs_epu8(indices, _mm_set1_epi8(51)),
+                                       _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices),
+                                                     _mm_set1_epi8(13)));
+
+        _mm_storeu_si128((__m128i*) dest,
+                         _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, range)));
+    }
+
+    return i;
+}
+
+/**
+ * Encode blocks of 24 bytes into 32 base64 characters, leaving the rest to the SSSE3 encoder.
+ */
+__attribute__((target("avx2")))
+static int64_t __base64_encode_avx2 (unsigned char* dest, unsigned char* data, int64_t length,
+                                     const char* chars) {
+    __m256i spread  = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    __m256i offsets = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                      '0' - 52, '0' - 52, '0' - 52, '0' - 52, chars[62] - 62, chars[63] - 63,
+                      'A', 0, 0));
+    int64_t i       = 0;
+
+    for (; i + 28 <= length; i += 24, dest += 32) {
+        // each lane takes 12 of the 24 bytes
+        __m256i in      = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((__m128i*) (data + i))),
+            _mm_loadu_si128((__m128i*) (data + i + 12)), 1);
+        __m256i indices;
+        __m256i range;
+
+        in      = _mm256_shuffle_epi8(in, spread);
+        indices = _mm256_or_si256(
+            _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)),
+                               _mm256_set1_epi32(0x04000040)),
+            _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)),
+                               _mm256_set1_epi32(0x01000010)));
+        range   = _mm256_or_si256(_mm256_subs_epu8(indices, _mm256_set1_epi8(51)),
+                                  _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices),
+                                                   _mm256_set1_epi8(13)));
+
+        _mm256_storeu_si256((__m256i*) dest,
+                            _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, range)));
+    }
+
+    return i + __base64_encode_ssse3(dest, data + i, length - i, chars);
+}
+
+/**
+ * Select the kernels for the processor once.
+ */
+static int32_t __encoding_level () {
+    int32_t level = __atomic_load_n(&__encoding_isa, __ATOMIC_RELAXED);
+
+    if (__ENCODING_UNKNOWN == level) {
+        level = __ENCODING_SCALAR;
+
+        if (cpu_has_avx2()) {
+            level = __ENCODING_AVX2;
+        } else if (cpu_has_ssse3()) {
+            level = __ENCODING_SSSE3;
+        }
+
+        __atomic_store_n(&__encoding_isa, level, __ATOMIC_RELAXED);
+    }
+
+    return level;
+}
+#endif
+
+/**
+ * Make room for a count of bytes after the data of a buffer, growing it by its growth factor,
+ * and return where they start.
+ */
+static unsigned char* __encoding_reserve (Buffer* buffer, int64_t length) {
+    double  grown = buffer->size * (double) buffer->growth;
+    int64_t size;
+
+    // the data is written directly after the end, so a gap must be closed first
+    buffer_data(buffer);
+
+    if (INT64_MAX - buffer->length < length) {
+        return NULL;
+    }
+
+    size = buffer->length + length;
+
+    if (buffer->size < size) {
+        if (size < grown && grown < (double) (INT64_MAX / 2)) {
+            size = (int64_t) grown;
+        }
+
+        if (!buffer_reserve(buffer, size)) {
+            return NULL;
+        }
+    }
+
+    return buffer->data + buffer->length;
+}
+
+/**
+ * Retrieve the value of a hex digit of either case, or -1.
+ */
+static int32_t __hex_value (unsigned char digit) {
+    if ('0' <= digit && '9' >= digit) {
+        return digit - '0';
+    }
+
+    // only A-F fold onto a-f
+    digit |= 0x20;
+
+    return 'a' <= digit && 'f' >= digit ? digit - 'a' + 10 : -1;
+}
+
+/**
+ * Decode hex digit pairs, returning the count of bytes written or -1 when the data is not valid.
+ */
+static int64_t __hex_decode_scalar (unsigned char* dest, unsigned char* data, int64_t length) {
+    int32_t high;
+    int32_t low;
+
+    for (int64_t i = 0; i < length; i += 2) {
+        high = __hex_value(data[i]);
+        low  = __hex_value(data[i + 1]);
+
+        if (0 > (high | low)) {
+            return -1;
+        }
+
+        *dest++ = (unsigned char) (high << 4 | low);
+    }
+
+    return length / 2;
+}
+
+/**
+ * Encode bytes as hex digit pairs.
+ */
+static void __hex_encode_scalar (unsigned char* dest, unsigned char* data, int64_t length) {
+    for (int64_t i = 0; i < length; i++) {
+        *dest++ = __HEX_DIGITS[data[i] >> 4];
+        *dest++ = __HEX_DIGITS[data[i] & 0x0F];
+    }
+}
+
+#ifdef __CODEBOX_X86
+/**
+ * Translate 16 hex digits of either case to their values, clearing a mask when any is not a digit.
+ */
+__attribute__((target("ssse3")))
+static __m128i __hex_values_ssse3 (__m128i in, int32_t* valid) {
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)),
+                                  _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), in));
+    __m128i folded = _mm_or_si128(in, _mm_set1_epi8(0x20));
+    __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(folded, _mm_set1_epi8('a' - 1)),
+                                   _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), folded));
+
+    *valid &= _mm_movemask_epi8(_mm_or_si128(digit, letter));
+
+    return _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(in, _mm_set1_epi8('0'))),
+                        _mm_and_si128(letter, _mm_sub_epi8(folded, _mm_set1_epi8('a' - 10))));
+}
+
+/**
+ * Decode blocks of 32 hex digits into 16 bytes until a block holds a character that is not a
+ * digit, returning the count of digits decoded.
+ */
+__attribute__((target("ssse3")))
+static int64_t __hex_decode_ssse3 (unsigned char* dest, unsigned char* data, int64_t length) {
+    int64_t i = 0;
+    int32_t valid;
+
+    for (; i + 32 <= length; i += 32, dest += 16) {
+        valid = 0xFFFF;
+
+        __m128i first  = __hex_values_ssse3(_mm_loadu_si128((__m128i*) (data + i)), &valid);
+        __m128i second = __hex_values_ssse3(_mm_loadu_si128((__m128i*) (data + i + 16)), &valid);
+
+        if (0xFFFF != valid) {
+            break;
+        }
+
+        // each digit pair becomes high * 16 + low in a 16-bit lane, then the lanes are narrowed
+        _mm_storeu_si128((__m128i*) dest,
+                         _mm_packus_epi16(_mm_maddubs_epi16(first, _mm_set1_epi16(0x0110)),
+                                          _mm_maddubs_epi16(second, _mm_set1_epi16(0x0110))));
+    }
+
+    return i;
+}
+
+/**
+ * Translate 32 hex digits of either case to their values, clearing a mask when any is not a digit.
+ */
+__attribute__((target("avx2")))
+static __m256i __hex_values_avx2 (__m256i in, int32_t* valid) {
+    __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('0' - 1)),
+                                     _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), in));
+    __m256i folded = _mm256_or_si256(in, _mm256_set1_epi8(0x20));
+    __m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(folded, _mm256_set1_epi8('a' - 1)),
+                                      _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), folded));
+
+    *valid &= _mm256_movemask_epi8(_mm256_or_si256(digit, letter));
+
+    return _mm256_or_si256(_mm256_and_si256(digit, _mm256_sub_epi8(in, _mm256_set1_epi8('0'))),
+                           _mm256_and_si256(letter,
+                                            _mm256_sub_epi8(folded, _mm256_set1_epi8('a' - 10))));
+}
+
+/**
+ * Decode blocks of 64 hex digits into 32 bytes, leaving the rest to the SSSE3 decoder.
+ */
+__attribute__((target("avx2")))
+static int64_t __hex_decode_avx2 (unsigned char* dest, unsigned char* data, int64_t length) {
+    int64_t i = 0;
+    int32_t valid;
+
+    for (; i + 64 <= length; i += 64, dest += 32) {
+        valid = -1;
+
+        __m256i first  = __hex_values_avx2(_mm256_loadu_si256((__m256i*) (data + i)), &valid);
+        __m256i second = __hex_values_avx2(_mm256_loadu_si256((__m256i*) (data + i + 32)), &valid);
+
+        if (-1 != valid) {
+            break;
+        }
+
+        // narrowing interleaves the lanes of both halves, which the permute puts back in order
+        _mm256_storeu_si256((__m256i*) dest, _mm256_permute4x64_epi64(
+            _mm256_packus_epi16(_mm256_maddubs_epi16(first, _mm256_set1_epi16(0x0110)),
+                                _mm256_maddubs_epi16(second, _mm256_set1_epi16(0x0110))),
+            0xD8));
+    }
+
+    return i + __hex_decode_ssse3(dest, data + i, length - i);
+}
+
+/**
+ * Encode blocks of 16 bytes into 32 hex digits, returning the count of bytes encoded.
+ */
+__attribute__((target("ssse3")))
+static int64_t __hex_encode_ssse3 (unsigned char* dest, unsigned char* data, int64_t length) {
+    __m128i digits = _mm_loadu_si128((__m128i*) __HEX_DIGITS);
+    __m128i mask   = _mm_set1_epi8(0x0F);
+    int64_t i      = 0;
+
+    for (; i + 16 <= length; i += 16, dest += 32) {
+        __m128i in   = _mm_loadu_si128((__m128i*) (data + i));
+        __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(in, 4), mask));
+        __m128i low  = _mm_shuffle_epi8(digits, _mm_and_si128(in, mask));
+
+        _mm_storeu_si128((__m128i*) dest, _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128((__m128i*) (dest + 16), _mm_unpackhi_epi8(high, low));
+    }
+
+    return i;
+}
+
+/**
+ * Encode blocks of 32 bytes into 64 hex digits, leaving the rest to the SSSE3 encoder.
+ */
+__attribute__((target("avx2")))
+static int64_t __hex_encode_avx2 (unsigned char* dest, unsigned char* data, int64_t length) {
+    __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i*) __HEX_DIGITS));
+    __m256i mask   = _mm256_set1_epi8(0x0F);
+    int64_t i      = 0;
+
+    for (; i + 32 <= length; i += 32, dest += 64) {
+        // interleaving works within lanes, so the middle quarters are swapped first
+        __m256i in   = _mm256_permute4x64_epi64(_mm256_loadu_si256((__m256i*) (data + i)), 0xD8);
+        __m256i high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(in, 4), mask));
+        __m256i low  = _mm256_shuffle_epi8(digits, _mm256_and_si256(in, mask));
+
+        _mm256_storeu_si256((__m256i*) dest, _mm256_unpacklo_epi8(high, low));
+        _mm256_storeu_si256((__m256i*) (dest + 32), _mm256_unpackhi_epi8(high, low));
+    }
+
+    return i + __hex_encode_ssse3(dest, data + i, length - i);
+}
+#endif
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+bool base64_decode (Buffer* dest, unsigned char* data, int64_t length, Base64Alphabet alphabet) {
+    assert(NULL != dest);
+    assert(NULL != dest->data);
+    assert(0 <= length);
+
+    const char*    chars    = BASE64_URL == alphabet ? __BASE64_URL : __BASE64_STANDARD;
+    int64_t        consumed = 0;
+    unsigned char* ptr;
+    int64_t        written;
+
+    if (0 == length) {
+        return true;
+    }
+
+    assert(NULL != data);
+
+    if (NULL == (ptr = __encoding_reserve(dest, length / 4 * 3 + 2 + __ENCODING_SLACK))) {
+        return false;
+    }
+
+#ifdef __CODEBOX_X86
+    if (__ENCODING_AVX2 == __encoding_level()) {
+        consumed = __base64_decode_avx2(ptr, data, length, chars);
+    } else if (__ENCODING_SSSE3 == __encoding_level()) {
+        consumed = __base64_decode_ssse3(ptr, data, length, chars);
+    }
+#endif
+
+    written = __base64_decode_scalar(ptr + consumed / 4 * 3, data + consumed, length - consumed,
+                                     chars);
+
+    if (-1 == written) {
+        return false;
+    }
+
+    dest->length += consumed / 4 * 3 + written;
+
+    return true;
+}
+
+bool base64_decode_buffer (Buffer* dest, Buffer* source, Base64Alphabet alphabet) {
+    assert(NULL != source);
+    assert(dest != source);
+
+    return base64_decode(dest, buffer_data(source), source->length, alphabet);
+}
+
+bool base64_encode (Buffer* dest, unsigned char* data, int64_t length, Base64Alphabet alphabet) {
+    assert(NULL != dest);
+    assert(NULL != dest->data);
+    assert(0 <= length);
+
+    const char*    chars    = BASE64_URL == alphabet ? __BASE64_URL : __BASE64_STANDARD;
+    int64_t        consumed = 0;
+    unsigned char* ptr;
+
+    if (0 == length) {
+        return true;
+    } else if (INT64_MAX / 4 * 3 - 2 < length) {
+        return false;
+    }
+
+    assert(NULL != data);
+
+    if (NULL == (ptr = __encoding_reserve(dest, (length + 2) / 3 * 4))) {
+        return false;
+    }
+
+#ifdef __CODEBOX_X86
+    if (__ENCODING_AVX2 == __encoding_level()) {
+        consumed = __base64_encode_avx2(ptr, data, length, chars);
+    } else if (__ENCODING_SSSE3 == __encoding_level()) {
+        consumed = __base64_encode_ssse3(ptr, data, length, chars);
+    }
+#endif
+
+    dest->length += consumed / 3 * 4 +
+                    __base64_encode_scalar(ptr + consumed / 3 * 4, data + consumed,
+                                           length - consumed, chars, BASE64_STANDARD == alphabet);
+
+    return true;
+}
+
+bool base64_encode_buffer (Buffer* dest, Buffer* source, Base64Alphabet alphabet) {
+    assert(NULL != source);
+    assert(dest != source);
+
+    return base64_encode(dest, buffer_data(source), source->length, alphabet);
+}
+
+bool hex_decode (Buffer* dest, unsigned char* data, int64_t length) {
+    assert(NULL != dest);
+    assert(NULL != dest->data);
+    assert(0 <= length);
+
+    int64_t        consumed = 0;
+    unsigned char* ptr;
+
+    if (0 == length) {
+        return true;
+    } else if (1 == length % 2) {
+        return false;
+    }
+
+    assert(NULL != data);
+
+    if (NULL == (ptr = __encoding_reserve(dest, length / 2))) {
+        return false;
+    }
+
+#ifdef __CODEBOX_X86
+    if (__ENCODING_AVX2 == __encoding_level()) {
+        consumed = __hex_decode_avx2(ptr, data, length);
+    } else if (__ENCODING_SSSE3 == __encoding_level()) {
+        consumed = __hex_decode_ssse3(ptr, data, length);
+    }
+#endif
+
+    if (-1 == __hex_decode_scalar(ptr + consumed / 2, data + consumed, length - consumed)) {
+        return false;
+    }
+
+    dest->length += length / 2;
+
+    return true;
+}
+
+bool hex_decode_buffer (Buffer* dest, Buffer* source) {
+    assert(NULL != source);
+    assert(dest != source);
+
+    return hex_decode(dest, buffer_data(source), source->length);
+}
+
+bool hex_encode (Buffer* dest, unsigned char* data, int64_t length) {
+    assert(NULL != dest);
+    assert(NULL != dest->data);
+    assert(0 <= length);
+
+    int64_t        consumed = 0;
+    unsigned char* ptr;
+
+    if (0 == length) {
+        return true;
+    } else if (INT64_MAX / 2 < length) {
+        return false;
+    }
+
+    assert(NULL != data);
+
+    if (NULL == (ptr = __encoding_reserve(dest, 2 * length))) {
+        return false;
+    }
+
+#ifdef __CODEBOX_X86
+    if (__ENCODING_AVX2 == __encoding_level()) {
+        consumed = __hex_encode_avx2(ptr, data, length);
+    } else if (__ENCODING_SSSE3 == __encoding_level()) {
+        consumed = __hex_encode_ssse3(ptr, data, length);
+    }
+#endif
+
+    __hex_encode_scalar(ptr + 2 * consumed, data + consumed, length - consumed);
+
+    dest->length += 2 * length;
+
+    return true;
+}
+
+bool hex_encode_buffer (Buffer* dest, Buffer* source) {
+    assert(NULL != source);
+    assert(dest != source);
+
+    return hex_encode(dest, buffer_data(source), source->length);
+}
@@ -6,126 +6,309 @@
  * @author Sean Kerr: sean@code-box.org
  */
 
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
 
 #include "codebox/container/buffer.h"
+#include "codebox/container/pool.h"
+#include "codebox/container/serial.h"
 #include "codebox/io.h"
 
 // -------------------------------------------------------------------------------------------------
-// FUNCTIONS
+// STATIC FUNCTIONS
 // -------------------------------------------------------------------------------------------------
 
-bool io_dir_list (char* path, void (*callback) (char*, struct dirent*)) {
-    Buffer         buffer;
-    DIR*           dir   = opendir(path);
-    struct dirent* entry = NULL;
-    char*          file  = NULL;
+/**
+ * Read a file into an allocation one byte longer than it, so that strings can be terminated.
+ */
+static unsigned char* __io_file_read (char* path, char* mode, int64_t* length) {
+    unsigned char* data = NULL;
+    FILE*          file = fopen(path, mode);
+    off_t          size = -1;
 
-    if (NULL == dir) {
-        return false;
+    *length = 0;
+
+    if (NULL == file) {
+        return NULL;
+    } else if (0 == fseeko(file, 0, SEEK_END)) {
+        size = ftello(file);
     }
 
-    buffer_init(&buffer, 0, false);
+    if (size < 0 || (uint64_t) SIZE_MAX - 1 < (uint64_t) size || 0 != fseeko(file, 0, SEEK_SET) ||
+        NULL == (data = (unsigned char*) malloc((size_t) size + 1))) {
+        fclose(file);
 
-    while (NULL != (entry = readdir(dir))) {
-        buffer_truncate(&buffer);
-        buffer_append_str(&buffer, path);
-        buffer_append_str(&buffer, "/");
-        buffer_append_str(&buffer, entry->d_name);
+        return NULL;
+    }
 
-        file = strndup((char*) buffer.data, buffer.length);
+    if (fread(data, 1, size, file) < (size_t) size) {
+        fclose(file);
+        free(data);
 
-        callback(file, entry);
-        free(file);
+        return NULL;
     }
 
-    buffer_cleanup(&buffer);
-    closedir(dir);
+    fclose(file);
 
-    return true;
+    *length = size;
+
+    return data;
 }
 
-unsigned char* io_file_read (char* path, uint32_t* length) {
-    unsigned char* data    = NULL;
-    FILE*          file    = fopen(path, "rb");
-    uint32_t       rlength = 0;
+/**
+ * Parse the next delimited record of the data that has been read.
+ */
+static bool __io_reader_delimited (IoReader* reader, unsigned char** record, int64_t* length) {
+    unsigned char* data      = reader->buffer.data + reader->position;
+    int64_t        available = reader->buffer.length - reader->position;
+    int64_t        index     = -1;
 
-    if (NULL == file) {
-        *length = 0;
+    if (reader->scanned < available) {
+        index = chr_indexof_pattern(data, available, reader->scanned, &reader->delimiter);
+    }
 
-        return NULL;
+    if (-1 == index) {
+        // a delimiter that is cut short by the end of the data is searched for again once it has
+        // been read in full
+        reader->scanned = available - reader->delimiter.length + 1;
+        reader->scanned = reader->scanned < 0 ? 0 : reader->scanned;
+        reader->error   = reader->max_length + reader->delimiter.length <= available;
+
+        return false;
+    } else if (reader->max_length < index) {
+        reader->error = true;
+
+        return false;
     }
 
-    fseek(file, 0, SEEK_END);
+    *record           = data;
+    *length           = index;
+    reader->position += index + reader->delimiter.length;
+    reader->scanned   = 0;
+
+    return true;
+}
 
-    *length = ftell(file);
+/**
+ * Read more data into the buffer of a reader, making room for a full read first.
+ */
+static bool __io_reader_fill (IoReader* reader) {
+    Buffer* buffer    = &reader->buffer;
+    int64_t remaining = buffer->length - reader->position;
+    ssize_t count;
+
+    // the partial record that remains is the only data ever moved, and only once the buffer is full
+    if (0 < reader->position &&
+        (0 == remaining || buffer->size - buffer->length < IO_READER_READ)) {
+        memmove(buffer->data, buffer->data + reader->position, remaining);
+
+        buffer->length   = remaining;
+        reader->position = 0;
+    }
 
-    fseek(file, 0, SEEK_SET);
+    if (buffer->size - buffer->length < IO_READER_READ &&
+        !buffer_reserve(buffer, buffer->size * 2)) {
+        reader->error = true;
 
-    data = (unsigned char*) malloc(sizeof(unsigned char) * (*length));
+        return false;
+    }
 
-    if (NULL == data) {
-        *length = 0;
+    do {
+        count = read(reader->fd, buffer->data + buffer->length, buffer->size - buffer->length);
+    } while (-1 == count && EINTR == errno);
 
-        fclose(file);
+    if (0 < count) {
+        buffer->length += count;
 
-        return NULL;
+        return true;
+    } else if (0 == count) {
+        reader->eof = true;
+
+        return true;
     }
 
-    rlength = fread(data, 1, *length, file);
+    reader->error = EAGAIN != errno && EWOULDBLOCK != errno;
 
-    if (rlength < *length) {
-        *length = 0;
+    return false;
+}
 
-        fclose(file);
-        free(data);
+/**
+ * Parse the next length-prefixed record of the data that has been read.
+ */
+static bool __io_reader_prefixed (IoReader* reader, unsigned char** record, int64_t* length) {
+    BufferReader source;
+    uint64_t     _length;
 
-        return NULL;
+    source.data     = reader->buffer.data + reader->position;
+    source.error    = false;
+    source.length   = reader->buffer.length - reader->position;
+    source.position = 0;
+
+    _length = buffer_reader_varint(&source);
+
+    if (source.error) {
+        // a prefix is only malformed once all the bytes it could take have been read
+        reader->error = BUFFER_VARINT_MAX <= source.length;
+
+        return false;
+    } else if ((uint64_t) reader->max_length < _length) {
+        reader->error = true;
+
+        return false;
+    } else if ((uint64_t) (source.length - source.position) < _length) {
+        return false;
     }
 
-    fclose(file);
+    *record           = source.data + source.position;
+    *length           = (int64_t) _length;
+    reader->position += source.position + (int64_t) _length;
 
-    return data;
+    return true;
 }
 
-char* io_file_read_str (char* path) {
-    char*    data    = NULL;
-    FILE*    file    = fopen(path, "r");
-    uint32_t length  = 0;
-    uint32_t rlength = 0;
+/**
+ * Retrieve the data that remains at the end of the file as the final record.
+ */
+static bool __io_reader_rest (IoReader* reader, unsigned char** record, int64_t* length) {
+    int64_t remaining = reader->buffer.length - reader->position;
 
-    if (NULL == file) {
-        return NULL;
+    if (0 == remaining) {
+        return false;
+    } else if (IO_RECORD_PREFIXED == reader->format || reader->max_length < remaining) {
+        reader->error = true;
+
+        return false;
     }
 
-    fseek(file, 0, SEEK_END);
+    *record          = reader->buffer.data + reader->position;
+    *length          = remaining;
+    reader->position = reader->buffer.length;
 
-    length = ftell(file);
+    return true;
+}
 
-    fseek(file, 0, SEEK_SET);
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
 
-    data = (char*) malloc(sizeof(char) * length + 1);
+bool io_dir_list (char* path, void (*callback) (char*, struct dirent*)) {
+    Buffer*        buffer = NULL;
+    DIR*           dir    = opendir(path);
+    struct dirent* entry  = NULL;
 
-    if (NULL == data) {
-        fclose(file);
+    if (NULL == dir) {
+        return false;
+    }
 
-        return NULL;
+    if (NULL == (buffer = buffer_pool_acquire(buffer_pool_default(), 256))) {
+        closedir(dir);
+
+        return false;
     }
 
-    rlength = fread(data, 1, length, file);
+    while (NULL != (entry = readdir(dir))) {
+        buffer_truncate(buffer);
 
-    if (rlength < length) {
-        fclose(file);
-        free(data);
+        // the path is terminated within the buffer, so it needs no copy of its own
+        if (!buffer_append_str(buffer, path) || !buffer_append_str(buffer, "/") ||
+            !buffer_append_str(buffer, entry->d_name) ||
+            !buffer_append(buffer, (unsigned char*) "", 1)) {
+            break;
+        }
 
-        return NULL;
+        callback((char*) buffer->data, entry);
     }
 
-    fclose(file);
+    buffer_pool_release(buffer_pool_default(), buffer);
+    closedir(dir);
+
+    return NULL == entry;
+}
+
+unsigned char* io_file_read (char* path, int64_t* length) {
+    assert(NULL != path);
+    assert(NULL != length);
+
+    return __io_file_read(path, "rb", length);
+}
+
+char* io_file_read_str (char* path) {
+    assert(NULL != path);
+
+    int64_t length = 0;
+    char*   data   = (char*) __io_file_read(path, "r", &length);
+
+    if (NULL == data) {
+        return NULL;
+    }
 
     data[length] = '\0';
 
     return data;
 }
+
+bool io_reader_cleanup (IoReader* reader) {
+    assert(NULL != reader);
+
+    return buffer_cleanup(&reader->buffer);
+}
+
+bool io_reader_init (IoReader* reader, int fd, IoRecordFormat format, unsigned char* delimiter,
+                     int64_t delimiter_length, int64_t max_length) {
+    assert(NULL != reader);
+    assert(0 <= fd);
+    assert(IO_RECORD_PREFIXED == format || (NULL != delimiter && 0 < delimiter_length));
+    assert(0 < max_length);
+
+    memset(&reader->buffer, 0, sizeof(Buffer));
+
+    if (!buffer_init(&reader->buffer, 4 * IO_READER_READ, false)) {
+        return false;
+    }
+
+    if (IO_RECORD_DELIMITED == format) {
+        search_pattern_init(&reader->delimiter, delimiter, delimiter_length);
+    }
+
+    reader->eof        = false;
+    reader->error      = false;
+    reader->fd         = fd;
+    reader->format     = format;
+    reader->max_length = max_length;
+    reader->position   = 0;
+    reader->scanned    = 0;
+
+    return true;
+}
+
+bool io_reader_next (IoReader* reader, unsigned char** record, int64_t* length) {
+    assert(NULL != reader);
+    assert(NULL != record);
+    assert(NULL != length);
+
+    bool (*parse) (IoReader*, unsigned char**, int64_t*) =
+        IO_RECORD_DELIMITED == reader->format ? __io_reader_delimited : __io_reader_prefixed;
+
+    *record = NULL;
+    *length = 0;
+
+    if (reader->error) {
+        return false;
+    }
+
+    while (!parse(reader, record, length)) {
+        if (reader->error || (!reader->eof && !__io_reader_fill(reader))) {
+            return false;
+        } else if (reader->eof) {
+            return __io_reader_rest(reader, record, length);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,814 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "codebox/checksum.h"
+#include "codebox/lz.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+// the count of bits of the hash table of recent positions
+#define __LZ_HASH_LOG 12
+
+#define __LZ_HASH(__value) (((__value) * 2654435761U) >> (32 - __LZ_HASH_LOG))
+
+// the bytes at the end of a block that are always literals, and the distance from the end within
+// which no match may start, as the LZ4 block format requires
+#define __LZ_LAST_LITERALS 5
+#define __LZ_MATCH_LIMIT   12
+
+#define __LZ_MIN_MATCH 4
+
+// the count of failed searches after which the search step grows, as a power of two
+#define __LZ_SKIP_TRIGGER 6
+
+// the bytes the decompressor may store past the end of its output while copying matches
+#define __LZ_SLACK 16
+
+// the farthest a match may refer back
+#define __LZ_WINDOW 65535
+
+// the parts of a frame a decoder expects next
+#define __LZ_HEADER       0
+#define __LZ_BLOCK_LENGTH 1
+#define __LZ_BLOCK        2
+#define __LZ_CHECKSUM     3
+#define __LZ_DONE         4
+#define __LZ_FAILED       5
+
+#define __LZ_FRAME_HEADER_LENGTH 8
+#define __LZ_FRAME_MAGIC         "CBLZ"
+#define __LZ_FRAME_STORED        0x80000000U
+#define __LZ_FRAME_VERSION       1
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define __LZ_LE32(__value) __builtin_bswap32(__value)
+#define __LZ_LE64(__value) __builtin_bswap64(__value)
+#else
+#define __LZ_LE32(__value) (__value)
+#define __LZ_LE64(__value) (__value)
+#endif
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Read a little-endian 32-bit integer.
+ */
+static uint32_t __lz_read32 (unsigned char* data) {
+    uint32_t value;
+
+    memcpy(&value, data, sizeof(uint32_t));
+
+    return __LZ_LE32(value);
+}
+
+/**
+ * Read a little-endian 64-bit integer.
+ */
+static uint64_t __lz_read64 (unsigned char* data) {
+    uint64_t value;
+
+    memcpy(&value, data, sizeof(uint64_t));
+
+    return __LZ_LE64(value);
+}
+
+/**
+ * Retrieve the count of equal bytes at the start of two strings, comparing no further than the end
+ * of the first.
+ */
+static int64_t __lz_match_length (unsigned char* data, unsigned char* ref, unsigned char* end) {
+    unsigned char* start = data;
+    uint64_t       diff;
+
+    while (data + sizeof(uint64_t) <= end) {
+        if (0 != (diff = __lz_read64(data) ^ __lz_read64(ref))) {
+            return data - start + (__builtin_ctzll(diff) >> 3);
+        }
+
+        data += sizeof(uint64_t);
+        ref  += sizeof(uint64_t);
+    }
+
+    while (data < end && *data == *ref) {
+        data++;
+        ref++;
+    }
+
+    return data - start;
+}
+
+/**
+ * Write the part of a literal or match length that does not fit in a token.
+ */
+static unsigned char* __lz_write_length (unsigned char* ptr, int64_t length) {
+    for (; 255 <= length; length -= 255) {
+        *ptr++ = 255;
+    }
+
+    *ptr++ = (unsigned char) length;
+
+    return ptr;
+}
+
+/**
+ * Write a sequence of literals, followed by a match unless it is the last sequence of a block.
+ */
+static unsigned char* __lz_write_sequence (unsigned char* ptr, unsigned char* literals,
+                                           int64_t literal_length, int64_t offset,
+                                           int64_t match_length) {
+    unsigned char* token = ptr++;
+
+    if (15 <= literal_length) {
+        *token = 15 << 4;
+        ptr    = __lz_write_length(ptr, literal_length - 15);
+    } else {
+        *token = (unsigned char) (literal_length << 4);
+    }
+
+    memcpy(ptr, literals, literal_length);
+
+    ptr += literal_length;
+
+    if (0 == match_length) {
+        return ptr;
+    }
+
+    *ptr++        = (unsigned char) offset;
+    *ptr++        = (unsigned char) (offset >> 8);
+    match_length -= __LZ_MIN_MATCH;
+
+    if (15 <= match_length) {
+        *token |= 15;
+        ptr     = __lz_write_length(ptr, match_length - 15);
+    } else {
+        *token |= (unsigned char) match_length;
+    }
+
+    return ptr;
+}
+
+/**
+ * Compress data as a block, returning the count of bytes written, which is at most LZ_BOUND() of
+ * the length.
+ */
+static int64_t __lz_compress_block (unsigned char* dest, unsigned char* data, int64_t length) {
+    int64_t        anchor = 0;
+    int64_t        end    = length - __LZ_LAST_LITERALS;
+    int64_t        limit  = length - __LZ_MATCH_LIMIT;
+    int64_t        match;
+    int64_t        pos    = 0;
+    unsigned char* ptr    = dest;
+    int64_t        ref;
+    uint32_t       step;
+    uint32_t       table[1 << __LZ_HASH_LOG];
+    uint32_t       value;
+
+    memset(table, 0, sizeof(table));
+
+    while (pos < limit) {
+        // search for a match, stepping further the longer there has been none
+        ref  = -1;
+        step = 1 << __LZ_SKIP_TRIGGER;
+
+        while (-1 == ref && pos < limit) {
+            value = __lz_read32(data + pos);
+            ref   = table[__LZ_HASH(value)];
+
+            table[__LZ_HASH(value)] = (uint32_t) pos;
+
+            if (pos <= ref || __LZ_WINDOW < pos - ref || value != __lz_read32(data + ref)) {
+                pos += step++ >> __LZ_SKIP_TRIGGER;
+                ref  = -1;
+            }
+        }
+
+        if (-1 == ref) {
+            break;
+        }
+
+        // extend the match backward over the literals and forward up to the last literals
+        while (anchor < pos && 0 < ref && data[pos - 1] == data[ref - 1]) {
+            pos--;
+            ref--;
+        }
+
+        match = __LZ_MIN_MATCH + __lz_match_length(data + pos + __LZ_MIN_MATCH,
+                                                   data + ref + __LZ_MIN_MATCH, data + end);
+        ptr   = __lz_write_sequence(ptr, data + anchor, pos - anchor, pos - ref, match);
+
+        pos    += match;
+        anchor  = pos;
+
+        if (pos < limit) {
+            table[__LZ_HASH(__lz_read32(data + pos - 2))] = (uint32_t) (pos - 2);
+        }
+    }
+
+    ptr = __lz_write_sequence(ptr, data + anchor, length - anchor, 0, 0);
+
+    return ptr - dest;
+}
+
+/**
+ * Read the part of a literal or match length that does not fit in a token.
+ */
+static bool __lz_read_length (unsigned char** ptr, unsigned char* end, int64_t* length) {
+    unsigned char byte = 255;
+
+    while (255 == byte) {
+        if (*ptr == end || LZ_BLOCK_MAX < *length) {
+            return false;
+        }
+
+        byte     = *(*ptr)++;
+        *length += byte;
+    }
+
+    return true;
+}
+
+/**
+ * Decompress a block into space of a capacity, followed by __LZ_SLACK more bytes, returning the
+ * count of bytes written or -1 when the block is not valid or does not fit.
+ */
+static int64_t __lz_decompress_block (unsigned char* dest, int64_t capacity, unsigned char* data,
+                                      int64_t length) {
+    unsigned char* end       = data + length;
+    unsigned char* dest_end  = dest + capacity;
+    int64_t        literals;
+    int64_t        match;
+    unsigned char* match_end;
+    int64_t        offset;
+    unsigned char* ptr       = dest;
+    unsigned char* ref;
+    unsigned char  token;
+
+    while (data < end) {
+        token    = *data++;
+        literals = token >> 4;
+
+        if (15 == literals && !__lz_read_length(&data, end, &literals)) {
+            return -1;
+        } else if (end - data < literals || dest_end - ptr < literals) {
+            return -1;
+        }
+
+        memcpy(ptr, data, literals);
+
+        data += literals;
+        ptr  += literals;
+
+        if (data == end) {
+            // the last sequence has no match
+            return ptr - dest;
+        } else if (end - data < 2) {
+            return -1;
+        }
+
+        offset  = data[0] | data[1] << 8;
+        match   = token & 15;
+        data   += 2;
+
+        if (0 == offset || ptr - dest < offset) {
+            return -1;
+        } else if (15 == match && !__lz_read_length(&data, end, &match)) {
+            return -1;
+        } else if (dest_end - ptr < match + __LZ_MIN_MATCH) {
+            return -1;
+        }
+
+        match_end = ptr + match + __LZ_MIN_MATCH;
+        ref       = ptr - offset;
+
+        // distant matches are copied in chunks that may run into the slack, and near ones by byte
+        if (16 <= offset) {
+            for (; ptr < match_end; ptr += 16, ref += 16) {
+                memcpy(ptr, ref, 16);
+            }
+        } else if (8 <= offset) {
+            for (; ptr < match_end; ptr += 8, ref += 8) {
+                memcpy(ptr, ref, 8);
+            }
+        } else {
+            while (ptr < match_end) {
+                *ptr++ = *ref++;
+            }
+        }
+
+        ptr = match_end;
+    }
+
+    // a block ends with literals, even when there are none
+    return -1;
+}
+
+/**
+ * Reserve space at the end of a buffer, growing it by its growth factor when it does not fit.
+ */
+static unsigned char* __lz_reserve (Buffer* buffer, int64_t length) {
+    double  grown = buffer->size * (double) buffer->growth;
+    int64_t size;
+
+    // the data is written directly after the end, so a gap must be closed first
+    buffer_data(buffer);
+
+    if (INT64_MAX - buffer->length < length) {
+        return NULL;
+    }
+
+    size = buffer->length + length;
+
+    if (buffer->size < size) {
+        if (size < grown && grown < (double) (INT64_MAX / 2)) {
+            size = (int64_t) grown;
+        }
+
+        if (!buffer_reserve(buffer, size)) {
+            return NULL;
+        }
+    }
+
+    return buffer->data + buffer->length;
+}
+
+/**
+ * Write a little-endian 32-bit integer.
+ */
+static void __lz_write32 (unsigned char* data, uint32_t value) {
+    value = __LZ_LE32(value);
+
+    memcpy(data, &value, sizeof(uint32_t));
+}
+
+/**
+ * Retrieve the count of bytes of the part of a frame a decoder expects next.
+ */
+static int64_t __lz_decoder_need (LzDecoder* decoder) {
+    if (__LZ_HEADER == decoder->state) {
+        return __LZ_FRAME_HEADER_LENGTH;
+    } else if (__LZ_BLOCK == decoder->state) {
+        return (decoder->block_length & ~__LZ_FRAME_STORED) +
+               (decoder->flags & LZ_FRAME_BLOCK_CHECKSUM ? sizeof(uint32_t) : 0);
+    }
+
+    return sizeof(uint32_t);
+}
+
+/**
+ * Read a block of a frame.
+ */
+static bool __lz_decoder_block (LzDecoder* decoder, Buffer* dest, unsigned char* data) {
+    int64_t        length = decoder->block_length & ~__LZ_FRAME_STORED;
+    unsigned char* ptr;
+    int64_t        written;
+
+    if (decoder->flags & LZ_FRAME_BLOCK_CHECKSUM &&
+        crc32c(0, data, length) != __lz_read32(data + length)) {
+        return false;
+    }
+
+    if (decoder->block_length & __LZ_FRAME_STORED) {
+        if (NULL == (ptr = __lz_reserve(dest, length))) {
+            return false;
+        }
+
+        memcpy(ptr, data, length);
+
+        written = length;
+    } else {
+        if (NULL == (ptr = __lz_reserve(dest, decoder->block_max + __LZ_SLACK))) {
+            return false;
+        } else if (-1 == (written = __lz_decompress_block(ptr, decoder->block_max, data, length))) {
+            return false;
+        }
+    }
+
+    if (decoder->flags & LZ_FRAME_CONTENT_CHECKSUM) {
+        decoder->content_crc = crc32c(decoder->content_crc, ptr, written);
+    }
+
+    dest->length   += written;
+    decoder->state  = __LZ_BLOCK_LENGTH;
+
+    return true;
+}
+
+/**
+ * Read the length of the next block of a frame, or the end of the frame.
+ */
+static bool __lz_decoder_block_length (LzDecoder* decoder, unsigned char* data) {
+    uint32_t length = __lz_read32(data);
+    uint32_t size   = length & ~__LZ_FRAME_STORED;
+
+    if (0 == length) {
+        decoder->state = decoder->flags & LZ_FRAME_CONTENT_CHECKSUM ? __LZ_CHECKSUM : __LZ_DONE;
+
+        return true;
+    } else if (length & __LZ_FRAME_STORED) {
+        if (0 == size || decoder->block_max < size) {
+            return false;
+        }
+    } else if (LZ_BOUND(decoder->block_max) < size) {
+        return false;
+    }
+
+    decoder->block_length = length;
+    decoder->state        = __LZ_BLOCK;
+
+    return true;
+}
+
+/**
+ * Read the header of a frame.
+ */
+static bool __lz_decoder_header (LzDecoder* decoder, unsigned char* data) {
+    if (0 != memcmp(data, __LZ_FRAME_MAGIC, 4) || __LZ_FRAME_VERSION != data[4]) {
+        return false;
+    } else if (0 != (data[5] & ~(LZ_FRAME_BLOCK_CHECKSUM | LZ_FRAME_CONTENT_CHECKSUM))) {
+        return false;
+    } else if (16 > data[6] || 24 < data[6]) {
+        return false;
+    } else if ((unsigned char) (crc32c(0, data, 7) >> 8) != data[7]) {
+        return false;
+    }
+
+    decoder->block_max = (int64_t) 1 << data[6];
+    decoder->flags     = data[5];
+    decoder->state     = __LZ_BLOCK_LENGTH;
+
+    return true;
+}
+
+/**
+ * Compress a block of a frame onto the end of a buffer, storing it when it does not compress.
+ */
+static bool __lz_encoder_block (LzEncoder* encoder, Buffer* dest, unsigned char* data,
+                                int64_t length) {
+    unsigned char* ptr;
+    uint32_t       word;
+    int64_t        written;
+
+    if (NULL == (ptr = __lz_reserve(dest, 2 * sizeof(uint32_t) + LZ_BOUND(length)))) {
+        return false;
+    }
+
+    written = __lz_compress_block(ptr + sizeof(uint32_t), data, length);
+    word    = (uint32_t) written;
+
+    if (length <= written) {
+        memcpy(ptr + sizeof(uint32_t), data, length);
+
+        written = length;
+        word    = (uint32_t) length | __LZ_FRAME_STORED;
+    }
+
+    __lz_write32(ptr, word);
+
+    written += sizeof(uint32_t);
+
+    if (encoder->flags & LZ_FRAME_BLOCK_CHECKSUM) {
+        __lz_write32(ptr + written, crc32c(0, ptr + sizeof(uint32_t), written - sizeof(uint32_t)));
+
+        written += sizeof(uint32_t);
+    }
+
+    dest->length += written;
+
+    return true;
+}
+
+/**
+ * Write the header of a frame onto the end of a buffer, unless it has been written.
+ */
+static bool __lz_encoder_start (LzEncoder* encoder, Buffer* dest) {
+    unsigned char* ptr;
+
+    if (encoder->started) {
+        return true;
+    } else if (NULL == (ptr = __lz_reserve(dest, __LZ_FRAME_HEADER_LENGTH))) {
+        return false;
+    }
+
+    memcpy(ptr, __LZ_FRAME_MAGIC, 4);
+
+    ptr[4] = __LZ_FRAME_VERSION;
+    ptr[5] = (unsigned char) encoder->flags;
+    ptr[6] = (unsigned char) __builtin_ctz(LZ_FRAME_BLOCK_SIZE);
+    ptr[7] = (unsigned char) (crc32c(0, ptr, 7) >> 8);
+
+    dest->length     += __LZ_FRAME_HEADER_LENGTH;
+    encoder->started  = true;
+
+    return true;
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+bool lz_compress (Buffer* dest, unsigned char* data, int64_t length) {
+    assert(NULL != dest);
+    assert(NULL != dest->data);
+    assert(0 <= length);
+    assert(NULL != data || 0 == length);
+
+    unsigned char* ptr;
+
+    if (LZ_BLOCK_MAX < length) {
+        return false;
+    } else if (NULL == (ptr = __lz_reserve(dest, LZ_BOUND(length)))) {
+        return false;
+    }
+
+    dest->length += __lz_compress_block(ptr, data, length);
+
+    return true;
+}
+
+bool lz_compress_buffer (Buffer* dest, Buffer* source) {
+    assert(NULL != source);
+    assert(dest != source);
+
+    return lz_compress(dest, buffer_data(source), source->length);
+}
+
+bool lz_decompress (Buffer* dest, unsigned char* data, int64_t length, int64_t max_length) {
+    assert(NULL != dest);
+    assert(NULL != dest->data);
+    assert(0 <= length);
+    assert(0 <= max_length);
+    assert(NULL != data || 0 == length);
+
+    unsigned char* ptr;
+    int64_t        written;
+
+    if (INT64_MAX - __LZ_SLACK < max_length) {
+        return false;
+    } else if (NULL == (ptr = __lz_reserve(dest, max_length + __LZ_SLACK))) {
+        return false;
+    } else if (-1 == (written = __lz_decompress_block(ptr, max_length, data, length))) {
+        return false;
+    }
+
+    dest->length += written;
+
+    return true;
+}
+
+bool lz_decompress_buffer (Buffer* dest, Buffer* source, int64_t max_length) {
+    assert(NULL != source);
+    assert(dest != source);
+
+    return lz_decompress(dest, buffer_data(source), source->length, max_length);
+}
+
+bool lz_decoder_cleanup (LzDecoder* decoder) {
+    assert(NULL != decoder);
+
+    return buffer_cleanup(&decoder->pending);
+}
+
+bool lz_decoder_done (LzDecoder* decoder) {
+    assert(NULL != decoder);
+
+    return __LZ_DONE == decoder->state;
+}
+
+bool lz_decoder_init (LzDecoder* decoder) {
+    assert(NULL != decoder);
+
+    memset(decoder, 0, sizeof(LzDecoder));
+
+    decoder->state = __LZ_HEADER;
+
+    return buffer_init(&decoder->pending, __LZ_FRAME_HEADER_LENGTH, false);
+}
+
+bool lz_decoder_write (LzDecoder* decoder, Buffer* dest, unsigned char* data, int64_t length) {
+    assert(NULL != decoder);
+    assert(NULL != dest);
+    assert(0 <= length);
+    assert(NULL != data || 0 == length);
+
+    int64_t        need;
+    bool           ret = true;
+    int64_t        take;
+    unsigned char* unit;
+
+    while (ret && 0 < length) {
+        if (__LZ_DONE <= decoder->state) {
+            ret = false;
+
+            break;
+        }
+
+        need = __lz_decoder_need(decoder);
+
+        if (0 == decoder->pending.length && need <= length) {
+            // the part is whole, so it is read in place
+            unit    = data;
+            data   += need;
+            length -= need;
+        } else {
+            take = need - decoder->pending.length < length ? need - decoder->pending.length
+                                                           : length;
+
+            if (!buffer_append(&decoder->pending, data, take)) {
+                ret = false;
+
+                break;
+            }
+
+            data   += take;
+            length -= take;
+
+            if (decoder->pending.length < need) {
+                break;
+            }
+
+            unit = buffer_data(&decoder->pending);
+        }
+
+        if (__LZ_HEADER == decoder->state) {
+            ret = __lz_decoder_header(decoder, unit);
+        } else if (__LZ_BLOCK_LENGTH == decoder->state) {
+            ret = __lz_decoder_block_length(decoder, unit);
+        } else if (__LZ_BLOCK == decoder->state) {
+            ret = __lz_decoder_block(decoder, dest, unit);
+        } else if (decoder->content_crc == __lz_read32(unit)) {
+            decoder->state = __LZ_DONE;
+        } else {
+            ret = false;
+        }
+
+        buffer_truncate(&decoder->pending);
+    }
+
+    if (!ret) {
+        decoder->state = __LZ_FAILED;
+    }
+
+    return ret;
+}
+
+bool lz_encoder_cleanup (LzEncoder* encoder) {
+    assert(NULL != encoder);
+
+    return buffer_cleanup(&encoder->pending);
+}
+
+bool lz_encoder_finish (LzEncoder* encoder, Buffer* dest) {
+    assert(NULL != encoder);
+    assert(NULL != dest);
+
+    unsigned char* ptr;
+
+    if (!__lz_encoder_start(encoder, dest)) {
+        return false;
+    } else if (0 < encoder->pending.length &&
+               !__lz_encoder_block(encoder, dest, buffer_data(&encoder->pending),
+                                   encoder->pending.length)) {
+        return false;
+    } else if (NULL == (ptr = __lz_reserve(dest, 2 * sizeof(uint32_t)))) {
+        return false;
+    }
+
+    buffer_truncate(&encoder->pending);
+
+    __lz_write32(ptr, 0);
+
+    dest->length += sizeof(uint32_t);
+
+    if (encoder->flags & LZ_FRAME_CONTENT_CHECKSUM) {
+        __lz_write32(ptr + sizeof(uint32_t), encoder->content_crc);
+
+        dest->length += sizeof(uint32_t);
+    }
+
+    return true;
+}
+
+bool lz_encoder_init (LzEncoder* encoder, int32_t flags) {
+    assert(NULL != encoder);
+    assert(0 == (flags & ~(LZ_FRAME_BLOCK_CHECKSUM | LZ_FRAME_CONTENT_CHECKSUM)));
+
+    memset(encoder, 0, sizeof(LzEncoder));
+
+    encoder->flags = flags;
+
+    return buffer_init(&encoder->pending, LZ_FRAME_BLOCK_SIZE, false);
+}
+
+bool lz_encoder_write (LzEncoder* encoder, Buffer* dest, unsigned char* data, int64_t length) {
+    assert(NULL != encoder);
+    assert(NULL != dest);
+    assert(0 <= length);
+    assert(NULL != data || 0 == length);
+
+    int64_t take;
+
+    if (!__lz_encoder_start(encoder, dest)) {
+        return false;
+    }
+
+    if (encoder->flags & LZ_FRAME_CONTENT_CHECKSUM) {
+        encoder->content_crc = crc32c(encoder->content_crc, data, length);
+    }
+
+    while (0 < length) {
+        if (0 == encoder->pending.length && LZ_FRAME_BLOCK_SIZE <= length) {
+            // whole blocks are compressed in place
+            take = LZ_FRAME_BLOCK_SIZE;
+
+            if (!__lz_encoder_block(encoder, dest, data, take)) {
+                return false;
+            }
+        } else {
+            take = LZ_FRAME_BLOCK_SIZE - encoder->pending.length < length
+                   ? LZ_FRAME_BLOCK_SIZE - encoder->pending.length : length;
+
+            if (!buffer_append(&encoder->pending, data, take)) {
+                return false;
+            } else if (LZ_FRAME_BLOCK_SIZE == encoder->pending.length) {
+                if (!__lz_encoder_block(encoder, dest, buffer_data(&encoder->pending),
+                                        LZ_FRAME_BLOCK_SIZE)) {
+                    return false;
+                }
+
+                buffer_truncate(&encoder->pending);
+            }
+        }
+
+        data   += take;
+        length -= take;
+    }
+
+    return true;
+}
+
+bool lz_frame_compress (Buffer* dest, unsigned char* data, int64_t length, int32_t flags) {
+    assert(NULL != dest);
+
+    LzEncoder encoder;
+    bool      ret;
+
+    if (!lz_encoder_init(&encoder, flags)) {
+        return false;
+    }
+
+    ret = lz_encoder_write(&encoder, dest, data, length) && lz_encoder_finish(&encoder, dest);
+
+    return lz_encoder_cleanup(&encoder) && ret;
+}
+
+bool lz_frame_compress_buffer (Buffer* dest, Buffer* source, int32_t flags) {
+    assert(NULL != source);
+    assert(dest != source);
+
+    return lz_frame_compress(dest, buffer_data(source), source->length, flags);
+}
+
+bool lz_frame_decompress (Buffer* dest, unsigned char* data, int64_t length) {
+    assert(NULL != dest);
+    assert(NULL != dest->data);
+
+    LzDecoder decoder;
+    int64_t   dest_length = dest->length;
+    bool      ret;
+
+    if (!lz_decoder_init(&decoder)) {
+        return false;
+    }
+
+    ret = lz_decoder_write(&decoder, dest, data, length) && lz_decoder_done(&decoder);
+
+    if (!lz_decoder_cleanup(&decoder) || !ret) {
+        // the data of the blocks read before the failure is dropped
+        buffer_data(dest);
+
+        dest->length = dest_length;
+
+        return false;
+    }
+
+    return true;
+}
+
+bool lz_frame_decompress_buffer (Buffer* dest, Buffer* source) {
+    assert(NULL != source);
+    assert(dest != source);
+
+    return lz_frame_decompress(dest, buffer_data(source), source->length);
+}
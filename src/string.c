@@ -10,126 +10,540 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#define __CODEBOX_X86
+#include <immintrin.h>
+#endif
+
+#include "codebox/cpu.h"
 #include "codebox/string.h"
 
 // -------------------------------------------------------------------------------------------------
-// FUNCTIONS
+// MACROS
 // -------------------------------------------------------------------------------------------------
 
-int32_t chr_indexof (unsigned char* data, int32_t data_length, int32_t start,
-                     unsigned char* sequence, int32_t sequence_length) {
-    assert(NULL != data);
-    assert(NULL != sequence);
-    assert(0 <= start);
-    assert(0 < data_length);
-    assert(0 < sequence_length);
+// the bytes the vector searches may spend comparing candidates that pass their filter, after
+// scanning a length of data, before they switch to the two-way search, which runs in linear time
+#define __STRING_SEARCH_BUDGET(__length) (4 * (int64_t) (__length) + 4096)
+
+#define __STRING_BITOP(__set, __byte, __op) \
+    ((__set)[(__byte) / (8 * sizeof(size_t))] __op \
+     ((size_t) 1 << ((__byte) % (8 * sizeof(size_t)))))
+
+// -------------------------------------------------------------------------------------------------
+// STATIC VARIABLES
+// -------------------------------------------------------------------------------------------------
+
+// bytes in roughly descending order of frequency in text and protocol data
+static const char* __SEARCH_COMMON = " etaoinsrhldcumfpgwybvkxjqz\r\n";
+
+static int64_t (*__search_func) (SearchPattern* pattern, unsigned char* data, int64_t data_length,
+                                 int64_t* resume) = NULL;
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Compute the two-way critical factorization and shift table of a pattern.
+ */
+static void __search_compile (SearchPattern* pattern) {
+    unsigned char* sequence = pattern->sequence;
+    size_t         length   = pattern->length;
+    size_t         i, ip, jp, k, p, ms, p0;
+
+    memset(pattern->byteset, 0, sizeof(pattern->byteset));
+
+    for (i = 0; i < length; i++) {
+        __STRING_BITOP(pattern->byteset, sequence[i], |=);
+
+        pattern->shift[sequence[i]] = length - 1 - i < INT32_MAX ? length - 1 - i : INT32_MAX;
+    }
 
-    for (int32_t i = start, s = 0; i < data_length; i++) {
-        if (*(data + i) == *(sequence + s)) {
-            if (++s == sequence_length) {
-                return i - (sequence_length - 1);
+    // compute the maximal suffix
+    ip = -1;
+    jp = 0;
+    k  = p = 1;
+
+    while (jp + k < length) {
+        if (sequence[ip + k] == sequence[jp + k]) {
+            if (k == p) {
+                jp += p;
+                k   = 1;
+            } else {
+                k++;
             }
+        } else if (sequence[ip + k] > sequence[jp + k]) {
+            jp += k;
+            k   = 1;
+            p   = jp - ip;
         } else {
-            s = 0;
+            ip = jp++;
+            k  = p = 1;
+        }
+    }
+
+    ms = ip;
+    p0 = p;
+
+    // and again with the opposite comparison
+    ip = -1;
+    jp = 0;
+    k  = p = 1;
+
+    while (jp + k < length) {
+        if (sequence[ip + k] == sequence[jp + k]) {
+            if (k == p) {
+                jp += p;
+                k   = 1;
+            } else {
+                k++;
+            }
+        } else if (sequence[ip + k] < sequence[jp + k]) {
+            jp += k;
+            k   = 1;
+            p   = jp - ip;
+        } else {
+            ip = jp++;
+            k  = p = 1;
+        }
+    }
+
+    if (ip + 1 > ms + 1) {
+        ms = ip;
+    } else {
+        p = p0;
+    }
+
+    // a periodic sequence remembers how much of the previous match it can skip
+    if (0 != memcmp(sequence, sequence + p, ms + 1)) {
+        pattern->memory = 0;
+        pattern->period = (ms > length - ms - 1 ? ms : length - ms - 1) + 1;
+    } else {
+        pattern->memory = length - p;
+        pattern->period = p;
+    }
+
+    pattern->suffix = ms;
+    pattern->twoway = true;
+}
+
+/**
+ * Rank how common a byte is expected to be, where higher ranks are more common.
+ */
+static int32_t __search_rank (unsigned char byte) {
+    char* common = 0 == byte ? NULL : strchr(__SEARCH_COMMON, byte);
+
+    if (NULL != common) {
+        return 255 - (common - __SEARCH_COMMON);
+    } else if (0 == byte || 0xFF == byte) {
+        return 200;
+    } else if ('0' <= byte && byte <= '9') {
+        return 160;
+    } else if ('A' <= byte && byte <= 'Z') {
+        return 150;
+    } else if (0x20 < byte && byte < 0x7F) {
+        return 120;
+    }
+
+    return 50;
+}
+
+/**
+ * Find a pattern of at least two bytes by scanning for its first rare byte with memchr().
+ */
+static int64_t __search_scalar (SearchPattern* pattern, unsigned char* data, int64_t data_length) {
+    int64_t        first  = pattern->rare[0];
+    int64_t        second = pattern->rare[1];
+    unsigned char* end    = data + data_length - pattern->length + 1 + first;
+    unsigned char* ptr    = data + first;
+
+    for (; ptr < end && NULL != (ptr = memchr(ptr, pattern->sequence[first], end - ptr)); ptr++) {
+        if (ptr[second - first] == pattern->sequence[second] &&
+            0 == memcmp(ptr - first, pattern->sequence, pattern->length)) {
+            return ptr - first - data;
         }
     }
 
     return -1;
 }
 
-Token* chr_split (unsigned char* data, int32_t data_length, unsigned char* delimiter,
-                  int32_t delimiter_length) {
-    assert(NULL != data);
-    assert(NULL != delimiter);
-    assert(0 < delimiter_length);
+/**
+ * Find a pattern of at least two bytes by comparing 16 candidate positions at a time against its
+ * two rare bytes, and comparing the rest only where both match. When too many candidates fail,
+ * the position from which the search should resume is set instead.
+ */
+static int64_t __search_vector (SearchPattern* pattern, unsigned char* data, int64_t data_length,
+                                int64_t* resume) {
+    *resume = -1;
+
+#ifdef __SSE2__
+    int64_t first  = pattern->rare[0];
+    int64_t second = pattern->rare[1];
+    __m128i byte1  = _mm_set1_epi8((char) pattern->sequence[first]);
+    __m128i byte2  = _mm_set1_epi8((char) pattern->sequence[second]);
+    int64_t i      = 0;
+    int64_t work   = 0;
+    int64_t found;
+
+    for (; i + pattern->length + 15 <= data_length; i += 16) {
+        __m128i  block1 = _mm_loadu_si128((__m128i*) (data + i + first));
+        __m128i  block2 = _mm_loadu_si128((__m128i*) (data + i + second));
+        uint32_t mask   = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(byte1, block1),
+                                                          _mm_cmpeq_epi8(byte2, block2)));
+
+        for (; 0 != mask; mask &= mask - 1) {
+            int32_t bit = __builtin_ctz(mask);
+
+            if (0 == memcmp(data + i + bit, pattern->sequence, pattern->length)) {
+                return i + bit;
+            }
 
-    Token* token = (Token*) malloc(sizeof(Token));
+            work += pattern->length;
+        }
 
-    if (NULL == token) {
-        return NULL;
+        if (__STRING_SEARCH_BUDGET(i) < work) {
+            *resume = i + 16;
+
+            return -1;
+        }
     }
 
-    for (int32_t i = 0, s = 0; i < data_length; i++) {
-        if (*(data + i) == *(delimiter + s)) {
-            if (++s == delimiter_length) {
-                token->data.cval = data;
-                token->length    = ++i - delimiter_length;
-                token->next      = chr_split(data + i, data_length - i, delimiter, delimiter_length);
+    found = __search_scalar(pattern, data + i, data_length - i);
+
+    return -1 == found ? -1 : i + found;
+#else
+    return __search_scalar(pattern, data, data_length);
+#endif
+}
 
-                return token;
+#ifdef __CODEBOX_X86
+/**
+ * Find a pattern of at least two bytes, comparing 32 candidate positions at a time.
+ */
+__attribute__((target("avx2")))
+static int64_t __search_avx2 (SearchPattern* pattern, unsigned char* data, int64_t data_length,
+                              int64_t* resume) {
+    int64_t first  = pattern->rare[0];
+    int64_t second = pattern->rare[1];
+    __m256i byte1  = _mm256_set1_epi8((char) pattern->sequence[first]);
+    __m256i byte2  = _mm256_set1_epi8((char) pattern->sequence[second]);
+    int64_t i      = 0;
+    int64_t work   = 0;
+    int64_t found;
+
+    for (; i + pattern->length + 31 <= data_length; i += 32) {
+        __m256i  block1 = _mm256_loadu_si256((__m256i*) (data + i + first));
+        __m256i  block2 = _mm256_loadu_si256((__m256i*) (data + i + second));
+        uint32_t mask   = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(byte1, block1),
+                                                                _mm256_cmpeq_epi8(byte2, block2)));
+
+        for (; 0 != mask; mask &= mask - 1) {
+            int32_t bit = __builtin_ctz(mask);
+
+            if (0 == memcmp(data + i + bit, pattern->sequence, pattern->length)) {
+                return i + bit;
             }
-        } else {
-            s = 0;
+
+            work += pattern->length;
+        }
+
+        if (__STRING_SEARCH_BUDGET(i) < work) {
+            *resume = i + 32;
+
+            return -1;
         }
     }
 
-    // didn't find the delimiter
-    token->data.cval = data;
-    token->length    = data_length;
-    token->next      = NULL;
+    found = __search_vector(pattern, data + i, data_length - i, resume);
+
+    if (-1 != *resume) {
+        *resume += i;
+    }
 
-    return token;
+    return -1 == found ? -1 : i + found;
 }
+#endif
 
-int32_t str_indexof (char* data, int32_t start, char* sequence) {
-    assert(NULL != data);
-    assert(NULL != sequence);
-    assert(0 <= start);
+/**
+ * Find a pattern using the two-way algorithm, skipping ahead with the shift table while the last
+ * byte of the window does not line up.
+ */
+static int64_t __search_twoway (SearchPattern* pattern, unsigned char* data, int64_t data_length) {
+    unsigned char* sequence = pattern->sequence;
+    size_t         length   = pattern->length;
+    size_t         ms       = pattern->suffix;
+    size_t         mem      = 0;
+    size_t         k;
+
+    unsigned char* ptr = data;
+    unsigned char* end = data + data_length;
+
+    for (;;) {
+        if ((size_t) (end - ptr) < length) {
+            return -1;
+        }
 
-    uint32_t data_length     = strlen(data);
-    uint32_t sequence_length = strlen(sequence);
+        // check the last byte first, advancing by its shift on a mismatch
+        if (__STRING_BITOP(pattern->byteset, ptr[length - 1], &)) {
+            k = pattern->shift[ptr[length - 1]];
 
-    assert(0 < data_length);
-    assert(0 < sequence_length);
+            if (0 != k) {
+                ptr += k < mem ? mem : k;
+                mem  = 0;
 
-    for (int32_t i = start, s = 0; i < data_length; i++) {
-        if (*(data + i) == *(sequence + s)) {
-            if (++s == sequence_length) {
-                return i - (sequence_length - 1);
+                continue;
             }
         } else {
-            s = 0;
+            ptr += length;
+            mem  = 0;
+
+            continue;
+        }
+
+        // compare the right half
+        for (k = ms + 1 > mem ? ms + 1 : mem; k < length && sequence[k] == ptr[k]; k++);
+
+        if (k < length) {
+            ptr += k - ms;
+            mem  = 0;
+
+            continue;
         }
+
+        // compare the left half
+        for (k = ms + 1; k > mem && sequence[k - 1] == ptr[k - 1]; k--);
+
+        if (k <= mem) {
+            return ptr - data;
+        }
+
+        ptr += pattern->period;
+        mem  = pattern->memory;
     }
+}
 
-    return -1;
+/**
+ * Find a pattern in data from a start position.
+ */
+static int64_t __search (SearchPattern* pattern, unsigned char* data, int64_t data_length,
+                         int64_t start) {
+    int64_t found;
+    int64_t resume;
+
+    if (data_length - start < pattern->length) {
+        return -1;
+    } else if (1 == pattern->length) {
+        unsigned char* ptr = memchr(data + start, *pattern->sequence, data_length - start);
+
+        return NULL == ptr ? -1 : ptr - data;
+    }
+
+    int64_t (*func) (SearchPattern*, unsigned char*, int64_t, int64_t*) =
+        __atomic_load_n(&__search_func, __ATOMIC_RELAXED);
+
+    if (NULL == func) {
+        func = __search_vector;
+
+#ifdef __CODEBOX_X86
+        if (cpu_has_avx2()) {
+            func = __search_avx2;
+        }
+#endif
+
+        __atomic_store_n(&__search_func, func, __ATOMIC_RELAXED);
+    }
+
+    found = func(pattern, data + start, data_length - start, &resume);
+
+    if (-1 != found) {
+        return start + found;
+    } else if (-1 == resume) {
+        return -1;
+    } else if (!pattern->twoway) {
+        __search_compile(pattern);
+    }
+
+    start += resume;
+    found  = __search_twoway(pattern, data + start, data_length - start);
+
+    return -1 == found ? -1 : start + found;
 }
 
-Token* str_split (char* data, char* delimiter) {
+/**
+ * Split data into tokens, returning NULL when a token cannot be allocated.
+ */
+static Token* __split (SearchPattern* pattern, unsigned char* data, int64_t data_length) {
+    Token*  first = NULL;
+    Token*  last  = NULL;
+    Token*  token = NULL;
+    int64_t start = 0;
+    int64_t found = 0;
+
+    for (; -1 != found; start = found + pattern->length) {
+        found = __search(pattern, data, data_length, start);
+        token = (Token*) malloc(sizeof(Token));
+
+        if (NULL == token) {
+            token_cleanup(first);
+
+            return NULL;
+        }
+
+        token->data.cval = data + start;
+        token->length    = (-1 == found ? data_length : found) - start;
+        token->next      = NULL;
+
+        if (NULL == last) {
+            first = token;
+        } else {
+            last->next = token;
+        }
+
+        last = token;
+    }
+
+    return first;
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+int64_t chr_indexof (unsigned char* data, int64_t data_length, int64_t start,
+                     unsigned char* sequence, int64_t sequence_length) {
     assert(NULL != data);
-    assert(NULL != delimiter);
+    assert(NULL != sequence);
+    assert(0 <= start);
+    assert(0 < data_length);
+    assert(0 < sequence_length);
+
+    // filter on the first and last bytes, leaving the two-way fields until they are needed
+    SearchPattern pattern;
+
+    pattern.length   = sequence_length;
+    pattern.rare[0]  = 0;
+    pattern.rare[1]  = sequence_length - 1;
+    pattern.sequence = sequence;
+    pattern.twoway   = false;
+
+    return __search(&pattern, data, data_length, start);
+}
 
-    uint32_t data_length      = strlen(data);
-    uint32_t delimiter_length = strlen(delimiter);
+int64_t chr_indexof_pattern (unsigned char* data, int64_t data_length, int64_t start,
+                             SearchPattern* pattern) {
+    assert(NULL != data);
+    assert(NULL != pattern);
+    assert(0 <= start);
+    assert(0 < data_length);
+
+    return __search(pattern, data, data_length, start);
+}
 
+Token* chr_split (unsigned char* data, int64_t data_length, unsigned char* delimiter,
+                  int64_t delimiter_length) {
+    assert(NULL != data);
+    assert(NULL != delimiter);
     assert(0 < delimiter_length);
 
-    Token* token = (Token*) malloc(sizeof(Token));
+    SearchPattern pattern;
 
-    if (NULL == token) {
-        return NULL;
-    }
+    search_pattern_init(&pattern, delimiter, delimiter_length);
 
-    for (int32_t i = 0, s = 0; i < data_length; i++) {
-        if (*(data + i) == *(delimiter + s)) {
-            if (++s == delimiter_length) {
-                token->data.sval = data;
-                token->length    = ++i - delimiter_length;
-                token->next      = str_split(data + i, delimiter);
+    return __split(&pattern, data, data_length);
+}
 
-                return token;
-            }
-        } else {
-            s = 0;
+Token* chr_split_pattern (unsigned char* data, int64_t data_length, SearchPattern* pattern) {
+    assert(NULL != data);
+    assert(NULL != pattern);
+
+    return __split(pattern, data, data_length);
+}
+
+void search_pattern_init (SearchPattern* pattern, unsigned char* sequence, int64_t length) {
+    assert(NULL != pattern);
+    assert(NULL != sequence);
+    assert(0 < length);
+
+    int32_t best = INT32_MAX;
+    int32_t next = INT32_MAX;
+    int32_t rank;
+    int64_t rare;
+
+    pattern->length   = length;
+    pattern->rare[0]  = length - 1;
+    pattern->rare[1]  = 0;
+    pattern->sequence = sequence;
+
+    // filter on the rarest byte and the rarest byte differing from it, preferring later positions
+    for (int64_t i = length - 1; 0 <= i; i--) {
+        if ((rank = __search_rank(sequence[i])) < best) {
+            best             = rank;
+            pattern->rare[0] = i;
         }
     }
 
-    // didn't find the delimiter
-    token->data.sval = data;
-    token->length    = data_length;
-    token->next      = NULL;
+    for (int64_t i = length - 1; 0 <= i; i--) {
+        if (sequence[i] != sequence[pattern->rare[0]] &&
+            (rank = __search_rank(sequence[i])) < next) {
+            next             = rank;
+            pattern->rare[1] = i;
+        }
+    }
+
+    if (INT32_MAX == next) {
+        pattern->rare[1] = length - 1 == pattern->rare[0] ? 0 : length - 1;
+    }
+
+    if (pattern->rare[1] < pattern->rare[0]) {
+        rare             = pattern->rare[0];
+        pattern->rare[0] = pattern->rare[1];
+        pattern->rare[1] = rare;
+    }
+
+    __search_compile(pattern);
+}
+
+void search_pattern_init_str (SearchPattern* pattern, char* sequence) {
+    assert(NULL != sequence);
+
+    search_pattern_init(pattern, (unsigned char*) sequence, strlen(sequence));
+}
+
+int64_t str_indexof (char* data, int64_t start, char* sequence) {
+    assert(NULL != data);
+    assert(NULL != sequence);
+    assert(0 <= start);
+
+    return chr_indexof((unsigned char*) data, strlen(data), start, (unsigned char*) sequence,
+                       strlen(sequence));
+}
+
+int64_t str_indexof_pattern (char* data, int64_t start, SearchPattern* pattern) {
+    assert(NULL != data);
+    assert(NULL != pattern);
+    assert(0 <= start);
+
+    return __search(pattern, (unsigned char*) data, strlen(data), start);
+}
+
+Token* str_split (char* data, char* delimiter) {
+    assert(NULL != data);
+    assert(NULL != delimiter);
+    assert(0 < strlen(delimiter));
+
+    SearchPattern pattern;
+
+    search_pattern_init_str(&pattern, delimiter);
+
+    return __split(&pattern, (unsigned char*) data, strlen(data));
+}
+
+Token* str_split_pattern (char* data, SearchPattern* pattern) {
+    assert(NULL != data);
+    assert(NULL != pattern);
 
-    return token;
+    return __split(pattern, (unsigned char*) data, strlen(data));
 }
 
 void token_cleanup (Token* token) {
@@ -11,6 +11,7 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 #include "codebox/container/buffer.h"
 
@@ -46,6 +47,8 @@ void test_buffer () {
     assert(buffer_init(b, 1, true));
 
     assert(__BUFFER_CHUNK_SIZE == b->size);
+    assert(b->inline_data == b->data);
+    assert(&b->inline_mutex == b->mutex);
     assert(buffer_append_str(b, "Buffer"));
     assert(6 == b->length);
     assert(0 == b->size % __BUFFER_CHUNK_SIZE);
@@ -102,6 +105,284 @@ void test_buffer () {
     assert(6 == b->length);
     assert(0 == strncmp("Bopper", buffer_get_str(b), b->length));
 
+    assert(buffer_shrink_to_fit(b));
+    assert(__BUFFER_CHUNK_SIZE == b->size);
+    assert(buffer_reserve(b, 100));
+    assert(100 <= b->size);
+    assert(6 == b->length);
+    assert(buffer_reserve(b, 10));
+    assert(100 <= b->size);
+    assert(buffer_shrink_to_fit(b));
+    assert(__BUFFER_CHUNK_SIZE == b->size);
+    assert(0 == strncmp("Bopper", buffer_get_str(b), b->length));
+
+    // appends grow the size geometrically
+    for (int32_t i = 0; i < 1000; i++) {
+        assert(buffer_append_str(b, "x"));
+    }
+
+    assert(1006 == b->length);
+    assert(1006 * 1.5 >= b->size);
+
+    // lengths that would overflow are refused rather than wrapping
+    assert(!buffer_append(b, (unsigned char*) "x", INT64_MAX));
+    assert(!buffer_insert(b, 0, (unsigned char*) "x", INT64_MAX - 1));
+    assert(!buffer_reserve(b, INT64_MAX));
+    assert(1006 == b->length);
+
+    buffer_truncate(b);
+    buffer_set_growth(b, 1.0);
+    assert(buffer_shrink_to_fit(b));
+    assert(buffer_append_str(b, "123456789"));
+    assert(2 * __BUFFER_CHUNK_SIZE == b->size);
+
+    // gapped buffer edits
+    buffer_truncate(b);
+    buffer_set_growth(b, 1.5);
+    buffer_set_gapped(b, true);
+    assert(buffer_append_str(b, "Fancy Fluffer"));
+    assert(buffer_insert_str(b, 6, "B"));
+    assert(7 == b->gap);
+    assert(buffer_insert_str(b, 7, "uffer "));
+    assert(13 == b->gap);
+    assert(buffer_insert_str(b, 0, "A "));
+    assert(2 == b->gap);
+    assert(buffer_remove(b, 0, 2));
+    assert(0 == b->gap);
+    assert(buffer_remove(b, 13, 7));
+    assert(-1 == b->gap);
+    assert(buffer_insert_str(b, 5, "!"));
+    assert(14 == b->length);
+    assert(0 == strncmp("Fancy! Buffer ", (char*) buffer_data(b), b->length));
+    assert(-1 == b->gap);
+    assert(buffer_insert_str(b, 6, " Bopper"));
+    assert(7 == buffer_indexof(b, 0, (unsigned char*) "Bopper", 6));
+    assert(-1 == b->gap);
+
+    SearchPattern pattern;
+
+    search_pattern_init_str(&pattern, "Buffer");
+    assert(buffer_insert_str(b, 0, "Buffer"));
+    assert(0 == buffer_indexof_pattern(b, 0, &pattern));
+    assert(20 == buffer_indexof_pattern(b, 1, &pattern));
+    assert(buffer_remove(b, 0, 6));
+
+    // slices share data until either side writes over it
+    Buffer  slice;
+    Buffer* s = buffer_slice(b, 7, 6);
+
+    memset(&slice, 0, sizeof(Buffer));
+
+    assert(NULL != s);
+    assert(-1 == b->gap);
+    assert(buffer_data(s) == (unsigned char*) buffer_data(b) + 7);
+    assert(0 == buffer_indexof(s, 0, (unsigned char*) "Bopper", 6));
+    assert(buffer_slice_init(&slice, s, 1, 3));
+    assert(3 == slice.storage->refs);
+    assert(0 == strncmp("opp", (char*) buffer_data(&slice), slice.length));
+
+    assert(buffer_append_str(b, "!"));
+    assert(buffer_data(s) == (unsigned char*) buffer_data(b) + 7);
+    assert(buffer_remove(b, 0, 7));
+    assert(NULL == b->storage);
+    assert(2 == slice.storage->refs);
+    assert(0 == strncmp("Bopper Buffer !", (char*) buffer_data(b), b->length));
+    assert(0 == strncmp("Bopper", (char*) buffer_data(s), s->length));
+
+    assert(buffer_append_str(s, "s"));
+    assert(NULL == s->storage);
+    assert(0 == strncmp("Boppers", (char*) buffer_data(s), s->length));
+    assert(1 == slice.storage->refs);
+    assert(0 == strncmp("opp", (char*) buffer_data(&slice), slice.length));
+
+    buffer_truncate(&slice);
+    assert(buffer_append_str(&slice, "Bopper"));
+    assert(NULL == slice.storage);
+    assert(0 == strncmp("Bopper", (char*) buffer_data(&slice), slice.length));
+
+    assert(buffer_cleanup(&slice));
+    assert(buffer_cleanup(s));
+    free(s);
+
+    // small buffers hold their data inline until they outgrow it or are sliced
+    memset(&slice, 0, sizeof(Buffer));
+    assert(buffer_init(&slice, 16, false));
+    assert(slice.inline_data == slice.data);
+    assert(buffer_append_str(&slice, "Small Buffer"));
+    assert(buffer_reserve(&slice, __BUFFER_INLINE_SIZE));
+    assert(slice.inline_data == slice.data);
+    assert(buffer_reserve(&slice, __BUFFER_INLINE_SIZE + 1));
+    assert(slice.inline_data != slice.data);
+    assert(buffer_shrink_to_fit(&slice));
+    assert(slice.inline_data == slice.data);
+    assert(16 == slice.size);
+    assert(NULL != (s = buffer_slice(&slice, 6, 6)));
+    assert(slice.inline_data != slice.data);
+    assert(0 == strncmp("Buffer", (char*) buffer_data(s), s->length));
+    assert(buffer_cleanup(s));
+    free(s);
+    assert(buffer_cleanup(&slice));
+
+    // numbers and printf() formats are written into the free space, growing it when needed
+    memset(&slice, 0, sizeof(Buffer));
+    assert(buffer_init(&slice, 1, true));
+    assert(buffer_append_i64(&slice, INT64_MIN));
+    assert(buffer_append_str(&slice, " "));
+    assert(buffer_append_u64_ts(&slice, UINT64_MAX));
+    assert(buffer_append_str(&slice, " "));
+    assert(buffer_append_f64(&slice, 0.1));
+    assert(buffer_append_str(&slice, " "));
+    assert(buffer_append_f64_ts(&slice, -2.5e-300));
+    assert(buffer_append_fmt(&slice, " %s=%d", "count", 42));
+    assert(buffer_append_fmt(&slice, "%s", ""));
+    assert(0 == strncmp("-9223372036854775808 18446744073709551615 0.1 -2.5e-300 count=42",
+                        (char*) buffer_data(&slice), slice.length));
+    assert(64 == slice.length);
+
+    buffer_truncate(&slice);
+    buffer_set_gapped(&slice, true);
+    assert(buffer_append_fmt_ts(&slice, "%0200d", 7));
+    assert(200 == slice.length);
+    assert('7' == slice.data[199]);
+    assert(buffer_insert_str(&slice, 0, "-"));
+    assert(buffer_append_i64_ts(&slice, -1));
+    assert(203 == slice.length);
+    assert(0 == strncmp("-00", (char*) buffer_data(&slice), 3));
+    assert(0 == strncmp("7-1", (char*) buffer_data(&slice) + 200, 3));
+    assert(buffer_cleanup(&slice));
+
+    // read-only mappings are read in place and copied onto the heap by the first write
+    char           path[] = "/tmp/test_buffer_XXXXXX";
+    int            fd     = mkstemp(path);
+    unsigned char* data;
+
+    assert(-1 != fd);
+    assert(26 == write(fd, "Mapped Buffer Mapped Files", 26));
+    close(fd);
+
+    memset(&slice, 0, sizeof(Buffer));
+    assert(buffer_map_init(&slice, path, BUFFER_MAP_READ,
+                           BUFFER_MAP_POPULATE | BUFFER_MAP_SEQUENTIAL, false));
+    assert(26 == slice.length);
+    assert(14 == buffer_indexof(&slice, 1, (unsigned char*) "Mapped", 6));
+    assert(NULL != (c = buffer_copy(&slice, 7, 6)));
+    assert(0 == strncmp("Buffer", (char*) buffer_data(c), c->length));
+    assert(buffer_cleanup(c));
+    free(c);
+
+    assert(NULL != (s = buffer_slice(&slice, 0, 6)));
+    assert(buffer_append_str(&slice, "!"));
+    assert(NULL == slice.storage);
+    assert(0 == strncmp("Mapped Buffer Mapped Files!", (char*) buffer_data(&slice), 27));
+    assert(0 == strncmp("Mapped", (char*) buffer_data(s), s->length));
+    assert(buffer_cleanup(s));
+    free(s);
+    assert(buffer_cleanup(&slice));
+
+    // private mappings are written in place until they grow beyond their last page
+    memset(&slice, 0, sizeof(Buffer));
+    assert(buffer_map_init(&slice, path, BUFFER_MAP_PRIVATE, 0, true));
+    data = slice.data;
+    assert(buffer_remove_ts(&slice, 0, 7));
+    assert(buffer_append_str_ts(&slice, "!"));
+    assert(data == slice.data);
+    assert(NULL != slice.storage);
+    assert(buffer_reserve(&slice, slice.size + 1));
+    assert(NULL == slice.storage);
+    assert(0 == strncmp("Buffer Mapped Files!", (char*) buffer_data(&slice), slice.length));
+    assert(buffer_cleanup(&slice));
+
+    // shared mappings grow and truncate the file with the buffer
+    memset(&slice, 0, sizeof(Buffer));
+    assert(buffer_map_init(&slice, path, BUFFER_MAP_SHARED, 0, false));
+    assert(0 == strncmp("Mapped Buffer Mapped Files", (char*) buffer_data(&slice), slice.length));
+    assert(NULL == buffer_slice(&slice, 0, 6));
+    assert(buffer_remove(&slice, 0, 7));
+    assert(buffer_reserve(&slice, 8192));
+    assert(8192 == slice.size);
+    assert(NULL != slice.storage);
+    assert(buffer_append_str(&slice, "!"));
+    assert(buffer_cleanup(&slice));
+
+    memset(&slice, 0, sizeof(Buffer));
+    assert(buffer_map_init(&slice, path, BUFFER_MAP_READ, 0, false));
+    assert(20 == slice.length);
+    assert(0 == strncmp("Buffer Mapped Files!", (char*) buffer_data(&slice), slice.length));
+    assert(buffer_cleanup(&slice));
+
+    // an empty file is mapped with room to grow
+    assert(0 == unlink(path));
+    memset(&slice, 0, sizeof(Buffer));
+    assert(buffer_map_init(&slice, path, BUFFER_MAP_SHARED, 0, false));
+    assert(0 == slice.length);
+    assert(buffer_append_str(&slice, "Mapped Buffer Mapped Files"));
+    assert(buffer_cleanup(&slice));
+
+    memset(&slice, 0, sizeof(Buffer));
+    assert(buffer_map_init(&slice, path, BUFFER_MAP_READ, 0, false));
+    assert(0 == strncmp("Mapped Buffer Mapped Files", (char*) buffer_data(&slice), slice.length));
+    assert(buffer_cleanup(&slice));
+    assert(0 == unlink(path));
+
+    // aligned and mapped allocations keep their alignment and data as they grow and shrink
+    memset(&slice, 0, sizeof(Buffer));
+    assert(buffer_init(&slice, 1, false));
+    assert(buffer_append_str(&slice, "Aligned"));
+    assert(buffer_set_alloc(&slice, BUFFER_ALLOC_ALIGN64));
+    assert(slice.inline_data != slice.data);
+    assert(0 == (uintptr_t) slice.data % 64);
+
+    for (int32_t i = 0; i < 1000; i++) {
+        assert(buffer_append_str(&slice, " Buffer"));
+        assert(0 == (uintptr_t) slice.data % 64);
+    }
+
+    assert(buffer_shrink_to_fit(&slice));
+    assert(0 == (uintptr_t) slice.data % 64);
+    assert(0 == slice.size % 64);
+
+    assert(buffer_set_alloc(&slice, BUFFER_ALLOC_PAGE));
+    assert(0 == (uintptr_t) slice.data % sysconf(_SC_PAGESIZE));
+    assert(0 == slice.size % sysconf(_SC_PAGESIZE));
+    assert(buffer_set_alloc(&slice, BUFFER_ALLOC_HUGE));
+    assert(buffer_reserve(&slice, 3 * 1024 * 1024));
+    assert(0 == (uintptr_t) slice.data % (2 * 1024 * 1024));
+    assert(4 * 1024 * 1024 == slice.size);
+    memset(slice.data + slice.length, 'x', slice.size - slice.length);
+    assert(buffer_reserve(&slice, 9 * 1024 * 1024));
+    assert(0 == (uintptr_t) slice.data % sysconf(_SC_PAGESIZE));
+    assert('x' == slice.data[4 * 1024 * 1024 - 1]);
+    assert(7007 == slice.length);
+    assert(0 == strncmp("Aligned Buffer", (char*) slice.data, 14));
+
+    // a slice keeps mapped data alive and the buffer copies it before writing
+    assert(NULL != (s = buffer_slice(&slice, 8, 6)));
+    assert(!buffer_set_alloc(&slice, BUFFER_ALLOC_ALIGN64));
+    assert(buffer_insert_str(&slice, 0, "!"));
+    assert(NULL == slice.storage);
+    assert(0 == strncmp("Buffer", (char*) buffer_data(s), s->length));
+    assert(buffer_cleanup(s));
+    free(s);
+
+    assert(buffer_resize(&slice, 100));
+    assert(0 == strncmp("!Aligned Buffer", (char*) slice.data, 15));
+    assert(buffer_set_alloc(&slice, 0));
+    assert(0 == strncmp("!Aligned Buffer", (char*) slice.data, 15));
+    assert(buffer_cleanup(&slice));
+
+    // large buffers are mapped without flags and grow by moving their pages
+    memset(&slice, 0, sizeof(Buffer));
+    assert(buffer_init(&slice, 40 * 1024 * 1024, false));
+    assert(0 == (uintptr_t) slice.data % sysconf(_SC_PAGESIZE));
+    memset(slice.data, 'y', slice.size);
+    slice.length = slice.size;
+    assert(buffer_append_str(&slice, "!"));
+    assert('y' == slice.data[40 * 1024 * 1024 - 1]);
+    assert('!' == slice.data[40 * 1024 * 1024]);
+    assert(buffer_resize(&slice, 1024));
+    assert(1024 == slice.length);
+    assert(buffer_cleanup(&slice));
+
     assert(buffer_cleanup(b));
     free(b);
 }
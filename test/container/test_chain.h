@@ -0,0 +1,155 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __TEST_CHAIN_H
+#define __TEST_CHAIN_H
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "codebox/container/buffer.h"
+#include "codebox/container/chain.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define chain_append_str(__chain, __data) \
+        chain_append(__chain, (unsigned char*) __data, strlen(__data))
+
+#define chain_append_ref_str(__chain, __data, __free_func, __context) \
+        chain_append_ref(__chain, (unsigned char*) __data, strlen(__data), __free_func, __context)
+
+#define chain_prepend_str(__chain, __data) \
+        chain_prepend(__chain, (unsigned char*) __data, strlen(__data))
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+static void __test_chain_free (unsigned char* data, void* context) {
+    (*(int*) context)++;
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void test_chain () {
+    unsigned char* large = malloc(3 * __CHAIN_CHUNK_SIZE);
+    unsigned char* data  = malloc(3 * __CHAIN_CHUNK_SIZE);
+    int32_t        count;
+    int            freed = 0;
+    int            fds[2];
+    struct iovec   iov[8];
+    Buffer*        b     = buffer_new();
+    Chain*         c     = chain_new();
+    Chain*         o     = chain_new();
+
+    assert(NULL != large);
+    assert(NULL != data);
+    assert(NULL != b);
+    assert(NULL != c);
+    assert(NULL != o);
+    assert(buffer_init(b, 16, false));
+    assert(chain_init(c, true));
+    assert(chain_init(o, false));
+
+    for (int i = 0; i < 3 * __CHAIN_CHUNK_SIZE; i++) {
+        large[i] = (unsigned char) (i % 251);
+    }
+
+    // copies share chunks, references become segments of their own
+    assert(chain_append_str(c, "Hello, "));
+    assert(chain_append_str(c, "world"));
+    assert(1 == c->count);
+    assert(chain_append_ref_str(c, "! Goodbye", __test_chain_free, &freed));
+    assert(chain_prepend_str(c, ">> "));
+    assert(chain_append_ts(c, large, 3 * __CHAIN_CHUNK_SIZE));
+    assert(4 == c->count);
+    assert(24 + 3 * __CHAIN_CHUNK_SIZE == chain_length_ts(c));
+    assert(24 == chain_copyout(c, data, 24));
+    assert(0 == memcmp(data, ">> Hello, world! Goodbye", 24));
+    assert(4 == chain_iovec(c, iov, 8));
+    assert(3 == iov[0].iov_len);
+    assert(12 == iov[1].iov_len);
+    assert(9 == iov[2].iov_len);
+    assert(2 == chain_iovec(c, iov, 2));
+
+    // splitting inside a segment shares its chunk
+    assert(chain_split(c, 18, o));
+    assert(18 == chain_length(o));
+    assert(3 == o->count);
+    assert(6 + 3 * __CHAIN_CHUNK_SIZE == chain_length(c));
+    assert(18 == chain_copyout(o, data, 100));
+    assert(0 == memcmp(data, ">> Hello, world! G", 18));
+    assert(6 == chain_copyout(c, data, 6));
+    assert(0 == memcmp(data, "oodbye", 6));
+    assert(!chain_split(c, 7 + 3 * __CHAIN_CHUNK_SIZE, o));
+    assert(0 == freed);
+
+    assert(chain_drain(o, 17));
+    assert(0 == freed);
+    assert(chain_drain_ts(c, 6));
+    assert(0 == freed);
+    assert(chain_drain(o, 1));
+    assert(1 == freed);
+    assert(0 == chain_length(o));
+    assert(NULL == o->head && NULL == o->tail);
+
+    // moving a whole chain and exporting it to a buffer
+    assert(chain_prepend_ref(o, (unsigned char*) "<<", 2, __test_chain_free, &freed));
+    assert(chain_append_chain(o, c));
+    assert(0 == chain_length(c));
+    assert(2 + 3 * __CHAIN_CHUNK_SIZE == chain_length(o));
+    assert(chain_to_buffer(o, b));
+    assert(2 + 3 * __CHAIN_CHUNK_SIZE == b->length);
+    assert(0 == memcmp(buffer_data(b), "<<", 2));
+    assert(0 == memcmp((unsigned char*) buffer_data(b) + 2, large, 3 * __CHAIN_CHUNK_SIZE));
+    assert(chain_drain(o, 2 + 3 * __CHAIN_CHUNK_SIZE));
+    assert(2 == freed);
+
+    // writev and readv through a pipe
+    assert(0 == pipe(fds));
+    assert(chain_append_str(c, "abc"));
+    assert(chain_append_ref_str(c, "def", NULL, NULL));
+    assert(chain_append_str(c, "ghi"));
+    assert(3 == chain_iovec(c, iov, 8));
+    assert(9 == writev(fds[1], iov, 3));
+    assert(chain_drain(c, 9));
+    assert(0 == chain_length(c));
+
+    assert(chain_append_str(o, "123"));
+    assert(1 == (count = chain_reserve(o, 16, iov, 8)));
+    assert(16 == iov[0].iov_len);
+    assert(9 == readv(fds[0], iov, count));
+    chain_commit(o, 9);
+    assert(12 == chain_length(o));
+    assert(1 == o->count);
+    assert(12 == chain_copyout(o, data, 12));
+    assert(0 == memcmp(data, "123abcdefghi", 12));
+
+    close(fds[0]);
+    close(fds[1]);
+
+    assert(buffer_cleanup(b));
+    assert(chain_cleanup(c));
+    assert(chain_cleanup(o));
+
+    free(b);
+    free(c);
+    free(o);
+    free(data);
+    free(large);
+}
+
+#endif
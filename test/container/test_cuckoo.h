@@ -0,0 +1,202 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __TEST_CUCKOO_H
+#define __TEST_CUCKOO_H
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "codebox/container/cuckoo.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define cuckoo_get_str(__cuckoo, __key) \
+        cuckoo_get(__cuckoo, (unsigned char*) __key, strlen(__key))
+
+#define cuckoo_get_str_ts(__cuckoo, __key) \
+        cuckoo_get_ts(__cuckoo, (unsigned char*) __key, strlen(__key))
+
+#define cuckoo_has_key_str(__cuckoo, __key) \
+        cuckoo_has_key(__cuckoo, (unsigned char*) __key, strlen(__key))
+
+#define cuckoo_put_str(__cuckoo, __key, __value) \
+        cuckoo_put(__cuckoo, (unsigned char*) __key, strlen(__key), __value)
+
+#define cuckoo_remove_str(__cuckoo, __key) \
+        cuckoo_remove(__cuckoo, (unsigned char*) __key, strlen(__key))
+
+#define __TEST_CUCKOO_CHURN   64
+#define __TEST_CUCKOO_READERS 2
+#define __TEST_CUCKOO_ROUNDS  300
+
+// -------------------------------------------------------------------------------------------------
+// STATIC VARIABLES
+// -------------------------------------------------------------------------------------------------
+
+static Cuckoo* __test_cuckoo;
+
+static bool __test_cuckoo_done;
+
+static char __test_cuckoo_stable[__TEST_CUCKOO_CHURN][12];
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+static void* __test_cuckoo_read (void* arg) {
+    char  key[24];
+    void* value;
+
+    while (!__atomic_load_n(&__test_cuckoo_done, __ATOMIC_ACQUIRE)) {
+        for (intptr_t i = 0; i < __TEST_CUCKOO_CHURN; i++) {
+            assert(__test_cuckoo_stable[i] == cuckoo_get_str_ts(__test_cuckoo,
+                                                                __test_cuckoo_stable[i]));
+
+            // the writer frees these keys as soon as it has removed them
+            snprintf(key, sizeof(key), "Churn%ld%s", (long) i, i & 1 ? "" : " of a longer key");
+            value = cuckoo_get_str_ts(__test_cuckoo, key);
+
+            assert(NULL == value || (void*) (i + 1) == value);
+        }
+    }
+
+    return NULL;
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void test_cuckoo () {
+    char      (*keys)[12] = malloc(2950 * sizeof(*keys));
+    char*     churn[__TEST_CUCKOO_CHURN];
+    Cuckoo*   c           = cuckoo_new();
+    pthread_t threads[__TEST_CUCKOO_READERS];
+
+    assert(NULL != keys);
+    assert(NULL != c);
+    assert(cuckoo_init_defaults(c));
+
+    assert(64 == sizeof(CuckooBucket));
+    assert(16 == cuckoo_bucket_count(c));
+    assert(cuckoo_put_str(c, "Key1", "Value1"));
+    assert(cuckoo_put_str(c, "Key2", "Value2"));
+    assert(cuckoo_put_str(c, "Key3", "Value3"));
+    assert(3 == cuckoo_key_count(c));
+    assert(0 == strcmp("Value1", cuckoo_get_str(c, "Key1")));
+    assert(0 == strcmp("Value2", cuckoo_get_str(c, "Key2")));
+    assert(0 == strcmp("Value3", cuckoo_get_str(c, "Key3")));
+    assert(cuckoo_put_str(c, "Key1", "Value4"));
+    assert(3 == cuckoo_key_count(c));
+    assert(0 == strcmp("Value4", cuckoo_get_str(c, "Key1")));
+    assert(0 == strcmp("Value2", (char*) cuckoo_remove_str(c, "Key2")));
+    assert(NULL == cuckoo_remove_str(c, "Key2"));
+    assert(0 == cuckoo_has_key_str(c, "Key2"));
+    assert(2 == cuckoo_key_count(c));
+    assert(cuckoo_cleanup(c));
+    free(c);
+
+    // a single bucket is rounded up to two, so that every key has two candidate buckets
+    c = cuckoo_new();
+
+    assert(NULL != c);
+    assert(cuckoo_init(c, 1, compare_binary, hash_djb2, false));
+    assert(2 == cuckoo_bucket_count(c));
+
+    for (int32_t i = 0; i < 8; i++) {
+        snprintf(keys[i], sizeof(keys[i]), "Key%d", i);
+        assert(cuckoo_put_str(c, keys[i], keys[i]));
+    }
+
+    assert(2 == cuckoo_bucket_count(c));
+    assert(cuckoo_cleanup(c));
+    free(c);
+
+    // fill 512 buckets of 6 slots past 95% load without growing
+    c = cuckoo_new();
+
+    assert(NULL != c);
+    assert(cuckoo_init(c, 512, compare_binary, hash_djb2, true));
+
+    for (int32_t i = 0; i < 2950; i++) {
+        snprintf(keys[i], sizeof(keys[i]), "Key%d", i);
+        assert(cuckoo_put_ts(c, (unsigned char*) keys[i], strlen(keys[i]), keys[i]));
+    }
+
+    assert(512 == cuckoo_bucket_count(c));
+    assert(2950 == cuckoo_key_count_ts(c));
+
+    for (int32_t i = 0; i < 2950; i++) {
+        assert(keys[i] == cuckoo_get_str_ts(c, keys[i]));
+    }
+
+    assert(cuckoo_resize_ts(c, 2048));
+    assert(2048 == cuckoo_bucket_count(c));
+
+    for (int32_t i = 0; i < 2950; i++) {
+        assert(keys[i] == cuckoo_get_str(c, keys[i]));
+    }
+
+    assert(cuckoo_cleanup(c));
+    free(c);
+    free(keys);
+
+    // readers racing a writer that frees each key once it has removed it
+    __test_cuckoo      = cuckoo_new();
+    __test_cuckoo_done = false;
+
+    assert(NULL != __test_cuckoo);
+    assert(cuckoo_init(__test_cuckoo, 16, compare_binary, hash_djb2, true));
+
+    for (int32_t i = 0; i < __TEST_CUCKOO_CHURN; i++) {
+        snprintf(__test_cuckoo_stable[i], sizeof(__test_cuckoo_stable[i]), "Stable%d", i);
+        assert(cuckoo_put_ts(__test_cuckoo, (unsigned char*) __test_cuckoo_stable[i],
+                             strlen(__test_cuckoo_stable[i]), __test_cuckoo_stable[i]));
+    }
+
+    for (int32_t i = 0; i < __TEST_CUCKOO_READERS; i++) {
+        assert(0 == pthread_create(&threads[i], NULL, __test_cuckoo_read, NULL));
+    }
+
+    for (int32_t round = 0; round < __TEST_CUCKOO_ROUNDS; round++) {
+        for (intptr_t i = 0; i < __TEST_CUCKOO_CHURN; i++) {
+            churn[i] = malloc(24);
+
+            assert(NULL != churn[i]);
+            snprintf(churn[i], 24, "Churn%ld%s", (long) i, i & 1 ? "" : " of a longer key");
+            assert(cuckoo_put_ts(__test_cuckoo, (unsigned char*) churn[i], strlen(churn[i]),
+                                 (void*) (i + 1)));
+        }
+
+        for (intptr_t i = 0; i < __TEST_CUCKOO_CHURN; i++) {
+            assert((void*) (i + 1) == cuckoo_remove_ts(__test_cuckoo, (unsigned char*) churn[i],
+                                                       strlen(churn[i])));
+            memset(churn[i], 0, 24);
+            free(churn[i]);
+        }
+    }
+
+    __atomic_store_n(&__test_cuckoo_done, true, __ATOMIC_RELEASE);
+
+    for (int32_t i = 0; i < __TEST_CUCKOO_READERS; i++) {
+        assert(0 == pthread_join(threads[i], NULL));
+    }
+
+    assert(__TEST_CUCKOO_CHURN == cuckoo_key_count_ts(__test_cuckoo));
+    assert(cuckoo_cleanup(__test_cuckoo));
+    free(__test_cuckoo);
+}
+
+#endif
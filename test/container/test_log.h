@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __TEST_LOG_H
+#define __TEST_LOG_H
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "codebox/container/log.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __TEST_LOG_THREADS 4
+#define __TEST_LOG_WRITES  20000
+
+#define append_log_write_str(__log, __data) \
+        append_log_write(__log, (unsigned char*) __data, strlen(__data))
+
+// -------------------------------------------------------------------------------------------------
+// STATIC VARIABLES
+// -------------------------------------------------------------------------------------------------
+
+static AppendLog* __test_log;
+
+static int32_t __test_log_ids[__TEST_LOG_THREADS];
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+static void* __test_log_produce (void* id) {
+    int32_t record[3] = { *(int32_t*) id, 0, 0 };
+
+    // records of 8 and 12 bytes, so that some are padded
+    for (int32_t i = 0; i < __TEST_LOG_WRITES; i++) {
+        record[1] = i;
+        record[2] = i;
+
+        assert(append_log_write(__test_log, (unsigned char*) record, i & 1 ? 12 : 8));
+    }
+
+    return NULL;
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void test_log () {
+    Buffer          dest;
+    int32_t         next[__TEST_LOG_THREADS];
+    int32_t         record[3];
+    AppendLogRegion region;
+    AppendLogRegion reserved;
+    int32_t         remaining = __TEST_LOG_THREADS * __TEST_LOG_WRITES;
+    pthread_t       threads[__TEST_LOG_THREADS];
+
+    __test_log = append_log_new();
+
+    assert(NULL != __test_log);
+    assert(append_log_init(__test_log, 100));
+    assert(128 == append_log_size(__test_log));
+    assert(!append_log_read(__test_log, &region));
+    assert(!append_log_write(__test_log, (unsigned char*) "x", 121));
+
+    // a later record committed first waits behind the earlier one
+    assert(append_log_reserve(__test_log, 5, &reserved));
+    assert(append_log_write_str(__test_log, "second"));
+    assert(!append_log_read(__test_log, &region));
+    memcpy(reserved.data[0], "first", 5);
+    append_log_commit(__test_log, &reserved);
+
+    memset(&dest, 0, sizeof(Buffer));
+    assert(buffer_init(&dest, 1, false));
+    assert(append_log_drain(__test_log, &dest));
+    assert(0 == strncmp("firstsecond", (char*) dest.data, dest.length));
+    assert(!append_log_read(__test_log, &region));
+
+    // a record that wraps is split into two parts
+    assert(append_log_write(__test_log, (unsigned char*) "0123456789abcdef0123456789abcdef", 32));
+    assert(append_log_write(__test_log, (unsigned char*) "0123456789abcdef0123456789abcdef", 32));
+    assert(append_log_read(__test_log, &region));
+    append_log_consume(__test_log, &region);
+    assert(append_log_read(__test_log, &region));
+    assert(region.length[0] == 32);
+    append_log_consume(__test_log, &region);
+    assert(append_log_write_str(__test_log, "wrapped record of 40 bytes, in two parts"));
+    assert(append_log_read(__test_log, &region));
+    assert(0 < region.length[1]);
+    assert(40 == region.length[0] + region.length[1]);
+    assert(0 == memcmp("wrapped record of 40 bytes, in two parts", region.data[0],
+                       region.length[0]));
+    assert(0 == memcmp("wrapped record of 40 bytes, in two parts" + region.length[0],
+                       region.data[1], region.length[1]));
+    append_log_consume(__test_log, &region);
+    assert(!append_log_read(__test_log, &region));
+
+    assert(append_log_cleanup(__test_log));
+    free(__test_log);
+
+    // multiple producers, each of whose records arrive in order
+    __test_log = append_log_new();
+
+    assert(NULL != __test_log);
+    assert(append_log_init(__test_log, 256));
+
+    for (int32_t i = 0; i < __TEST_LOG_THREADS; i++) {
+        __test_log_ids[i] = i;
+        next[i]           = 0;
+
+        assert(0 == pthread_create(&threads[i], NULL, __test_log_produce, &__test_log_ids[i]));
+    }
+
+    while (0 < remaining) {
+        if (!append_log_read(__test_log, &region)) {
+            sched_yield();
+
+            continue;
+        }
+
+        memcpy(record, region.data[0], region.length[0]);
+        memcpy((unsigned char*) record + region.length[0], region.data[1], region.length[1]);
+
+        assert(0 <= record[0] && __TEST_LOG_THREADS > record[0]);
+        assert(next[record[0]] == record[1]);
+        assert((record[1] & 1 ? 12 : 8) == region.length[0] + region.length[1]);
+        assert(!(record[1] & 1) || record[1] == record[2]);
+
+        next[record[0]]++;
+        remaining--;
+
+        append_log_consume(__test_log, &region);
+    }
+
+    for (int32_t i = 0; i < __TEST_LOG_THREADS; i++) {
+        assert(0 == pthread_join(threads[i], NULL));
+        assert(__TEST_LOG_WRITES == next[i]);
+    }
+
+    assert(!append_log_read(__test_log, &region));
+    assert(append_log_cleanup(__test_log));
+    free(__test_log);
+    assert(buffer_cleanup(&dest));
+}
+
+#endif
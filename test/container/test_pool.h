@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __TEST_POOL_H
+#define __TEST_POOL_H
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "codebox/container/buffer.h"
+#include "codebox/container/pool.h"
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+static void* __test_pool_thread (void* data) {
+    BufferPool* pool = (BufferPool*) data;
+    Buffer*     b;
+
+    for (int i = 0; i < 1000; i++) {
+        assert(NULL != (b = buffer_pool_acquire(pool, 1000)));
+        assert(0 == b->length);
+        assert(buffer_append_str(b, "thread"));
+        buffer_pool_release(pool, b);
+    }
+
+    return NULL;
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void test_pool () {
+    BufferPool*     pool = buffer_pool_new();
+    BufferPoolStats stats;
+    Buffer*         a;
+    Buffer*         b;
+    Buffer*         c;
+    pthread_t       threads[4];
+
+    assert(NULL != pool);
+    assert(buffer_pool_init(pool, 4096));
+
+    // buffers are rounded up to their size class and reused with their capacity
+    assert(NULL != (a = buffer_pool_acquire(pool, 100)));
+    assert(256 == a->size);
+    assert(NULL != (b = buffer_pool_acquire(pool, 1000)));
+    assert(1024 == b->size);
+    assert(buffer_append_str(a, "Hello, world!"));
+
+    buffer_pool_release(pool, a);
+    buffer_pool_release(pool, b);
+
+    assert(a == buffer_pool_acquire(pool, 256));
+    assert(0 == a->length);
+    assert(b == buffer_pool_acquire(pool, 513));
+
+    buffer_pool_stats(pool, &stats);
+    assert(4 == stats.acquired);
+    assert(2 == stats.allocated);
+    assert(0 == stats.retained);
+
+    // grown buffers go back into the class of their new size
+    assert(buffer_resize(a, 3000));
+
+    buffer_pool_release(pool, a);
+
+    assert(a == buffer_pool_acquire(pool, 2048));
+
+    // buffers beyond the retained memory, shared or thread-safe are freed
+    assert(NULL != (c = buffer_pool_acquire(pool, 4096)));
+
+    buffer_pool_release(pool, a);
+    buffer_pool_release(pool, c);
+    buffer_pool_stats(pool, &stats);
+    assert(1 == stats.discarded);
+    assert(3000 == stats.retained);
+
+    assert(NULL != (c = buffer_new()));
+    assert(buffer_init(c, 256, true));
+
+    buffer_pool_release(pool, c);
+    buffer_pool_stats(pool, &stats);
+    assert(2 == stats.discarded);
+
+    // buffers with an allocation mode are freed, so a plain acquire never returns one
+    assert(NULL != (c = buffer_pool_acquire(pool, 256)));
+    assert(buffer_set_alloc(c, BUFFER_ALLOC_PAGE));
+
+    buffer_pool_release(pool, c);
+    buffer_pool_stats(pool, &stats);
+    assert(3 == stats.discarded);
+
+    // thread caches return their buffers to the pool when threads exit
+    for (int i = 0; i < 4; i++) {
+        assert(0 == pthread_create(&threads[i], NULL, __test_pool_thread, pool));
+    }
+
+    for (int i = 0; i < 4; i++) {
+        assert(0 == pthread_join(threads[i], NULL));
+    }
+
+    buffer_pool_stats(pool, &stats);
+    assert(4007 == stats.acquired);
+    assert(4007 == stats.released);
+    assert(stats.retained <= 4096);
+    assert(NULL == pool->caches->next);
+    assert(0 < pool->counts[2]);
+
+    buffer_pool_release(pool, b);
+
+    assert(buffer_pool_cleanup(pool));
+
+    free(pool);
+}
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __TEST_RING_H
+#define __TEST_RING_H
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "codebox/container/ring.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define __TEST_RING_WRITES 20000
+
+#define ring_write_str(__ring, __data) \
+        ring_write(__ring, (unsigned char*) __data, strlen(__data))
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+static void* __test_ring_produce (void* ring) {
+    uint32_t value = 1;
+
+    for (int i = 0; i < __TEST_RING_WRITES; i++) {
+        while (!ring_write((Ring*) ring, (unsigned char*) &value, sizeof(value))) {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void __test_ring_wrap (bool mapped) {
+    unsigned char data[16];
+    Ring*         r = ring_new();
+    RingRegion    region;
+
+    assert(NULL != r);
+    assert(ring_init(r, 10, RING_SPSC, mapped));
+    assert(16 <= ring_size(r));
+    assert(0 == ring_length(r));
+    assert(!ring_peek(r, &region));
+
+    // move the positions to 4 bytes before the end of the data
+    for (int i = 0; i < ring_size(r) - 4; i += 4) {
+        assert(ring_write_str(r, "abcd"));
+        assert(4 == ring_read(r, data, sizeof(data)));
+    }
+
+    assert(ring_reserve(r, 10, &region));
+    assert(10 == region.length[0] + region.length[1]);
+    assert(mapped ? 0 == region.length[1] : 6 == region.length[1]);
+    assert(0 == ring_length(r));
+
+    memcpy(region.data[0], "0123456789", region.length[0]);
+    memcpy(region.data[1], "0123456789" + region.length[0], region.length[1]);
+    ring_commit(r, &region);
+
+    assert(10 == ring_length(r));
+    assert(ring_peek(r, &region));
+    assert(10 == region.length[0] + region.length[1]);
+    assert(0 == memcmp(region.data[0], "0123456789", region.length[0]));
+    assert(0 == memcmp(region.data[1], "0123456789" + region.length[0], region.length[1]));
+
+    ring_consume(r, 3);
+
+    assert(7 == ring_length(r));
+    assert(!ring_write(r, data, ring_size(r) - 6));
+    assert(ring_write_str(r, "abc"));
+    assert(10 == ring_read(r, data, sizeof(data)));
+    assert(0 == memcmp(data, "3456789abc", 10));
+    assert(0 == ring_length(r));
+
+    assert(ring_cleanup(r));
+    free(r);
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void test_ring () {
+    pthread_t threads[4];
+    uint32_t  values[64];
+    uint64_t  total = 0;
+    int64_t   length;
+    Ring*     r;
+
+    __test_ring_wrap(false);
+    __test_ring_wrap(true);
+
+    // multiple producers, reading in chunks that are not aligned to the writes
+    r = ring_new();
+
+    assert(NULL != r);
+    assert(ring_init(r, 256, RING_MPSC, false));
+
+    for (int i = 0; i < 4; i++) {
+        assert(0 == pthread_create(&threads[i], NULL, __test_ring_produce, r));
+    }
+
+    while (total < 4 * __TEST_RING_WRITES * sizeof(uint32_t)) {
+        length = ring_read(r, (unsigned char*) values, sizeof(values) - (total & 3));
+
+        if (0 == length) {
+            sched_yield();
+        }
+
+        for (int i = 0; i < length; i++) {
+            assert(((total + i) & 3 ? 0 : 1) == ((unsigned char*) values)[i]);
+        }
+
+        total += length;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        assert(0 == pthread_join(threads[i], NULL));
+    }
+
+    assert(0 == ring_length(r));
+    assert(ring_cleanup(r));
+    free(r);
+}
+
+#endif
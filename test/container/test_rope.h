@@ -0,0 +1,210 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __TEST_ROPE_H
+#define __TEST_ROPE_H
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "codebox/container/buffer.h"
+#include "codebox/container/rope.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define rope_append_str(__rope, __data) \
+    rope_append(__rope, (unsigned char*) __data, strlen(__data))
+
+#define rope_indexof_str(__rope, __start, __data) \
+    rope_indexof(__rope, __start, (unsigned char*) __data, strlen(__data))
+
+#define rope_insert_str(__rope, __index, __data) \
+    rope_insert(__rope, __index, (unsigned char*) __data, strlen(__data))
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+static void test_rope_equals (Rope* rope, char* expected) {
+    Buffer b;
+
+    memset(&b, 0, sizeof(Buffer));
+
+    assert(buffer_init(&b, 1, false));
+    assert(rope_to_buffer(rope, &b));
+    assert((int32_t) strlen(expected) == b.length);
+    assert(0 == strncmp(expected, (char*) buffer_data(&b), b.length));
+    assert(buffer_cleanup(&b));
+}
+
+static int32_t test_rope_leaves (Rope* rope) {
+    RopeIterator iter;
+    int32_t      count = 0;
+
+    rope_iter_init(&iter, rope);
+
+    for (; rope_iter_next(&iter); count++);
+
+    return count;
+}
+
+static void test_rope_small_edits () {
+    Buffer        b;
+    Buffer        expected;
+    unsigned char byte;
+    Rope*         c    = NULL;
+    Rope*         r    = rope_new();
+    uint32_t      seed = 1;
+
+    memset(&b, 0, sizeof(Buffer));
+    memset(&expected, 0, sizeof(Buffer));
+
+    assert(NULL != r);
+    assert(rope_init(r, false));
+    assert(buffer_init(&expected, 1, false));
+
+    for (int32_t i = 0; i < 2 * __ROPE_CHUNK_SIZE; i++) {
+        byte = 'a' + i % 26;
+
+        assert(buffer_append(&expected, &byte, 1));
+    }
+
+    assert(rope_append(r, expected.data, expected.length));
+    assert(2 == test_rope_leaves(r));
+
+    // typing one byte at a time in the middle of a chunk fills leaves in place
+    for (int32_t i = 0; i < 20000; i++) {
+        byte = '0' + i % 10;
+
+        assert(rope_insert(r, 1000 + i, &byte, 1));
+        assert(buffer_insert(&expected, 1000 + i, &byte, 1));
+    }
+
+    assert(4 + 20000 / __ROPE_MERGE_SIZE >= test_rope_leaves(r));
+
+    // a copy sharing the leaf being appended to is unaffected by the edits
+    for (int32_t i = 0; i < 100; i++) {
+        assert(rope_append(r, (unsigned char*) "#", 1));
+        assert(buffer_append(&expected, (unsigned char*) "#", 1));
+    }
+
+    c = rope_copy(r, 0, expected.length);
+
+    assert(NULL != c);
+
+    for (int32_t i = 0; i < 100; i++) {
+        assert(rope_append(r, (unsigned char*) "#", 1));
+        assert(buffer_append(&expected, (unsigned char*) "#", 1));
+        assert(rope_append(c, (unsigned char*) "$", 1));
+    }
+
+    assert(buffer_init(&b, 1, false));
+    assert(rope_to_buffer(c, &b));
+    assert(expected.length == b.length);
+    assert(0 == memcmp(expected.data, b.data, b.length - 100));
+    assert(b.length - 100 == buffer_indexof(&b, 0, (unsigned char*) "$", 1));
+    assert(-1 == buffer_indexof(&b, b.length - 100, (unsigned char*) "#", 1));
+    assert(rope_cleanup(c));
+    free(c);
+
+    // single bytes inserted at random positions are merged into the small leaves around them
+    for (int32_t i = 0; i < 20000; i++) {
+        int64_t index;
+
+        seed  = seed * 1103515245 + 12345;
+        index = (seed >> 8) % (expected.length + 1);
+        byte  = 'A' + i % 26;
+
+        assert(rope_insert(r, index, &byte, 1));
+        assert(buffer_insert(&expected, index, &byte, 1));
+    }
+
+    assert(expected.length == rope_length(r));
+    assert(expected.length / (__ROPE_MERGE_SIZE / 8) >= test_rope_leaves(r));
+
+    buffer_truncate(&b);
+
+    assert(rope_to_buffer(r, &b));
+    assert(expected.length == b.length);
+    assert(0 == memcmp(expected.data, b.data, b.length));
+    assert(buffer_cleanup(&b));
+    assert(buffer_cleanup(&expected));
+    assert(rope_cleanup(r));
+    free(r);
+}
+
+void test_rope () {
+    Buffer        b;
+    RopeIterator  iter;
+    int32_t       count = 0;
+    Rope*         c     = NULL;
+    Rope*         r     = rope_new();
+
+    assert(NULL != r);
+    assert(rope_init(r, true));
+
+    assert(0 == rope_length(r));
+    assert(rope_append_str(r, "Buffer"));
+    assert(rope_insert_str(r, 0, "Fancy "));
+    assert(rope_insert_str(r, 12, " Fluffer"));
+    assert(rope_insert_str(r, 6, "Bopper "));
+    assert(27 == rope_length(r));
+    test_rope_equals(r, "Fancy Bopper Buffer Fluffer");
+
+    rope_iter_init(&iter, r);
+
+    for (; rope_iter_next(&iter); count++);
+
+    // small edits are merged into the leaf beside them
+    assert(1 == count);
+
+    // matches inside chunks and spanning chunk boundaries
+    assert(6 == rope_indexof_str(r, 0, "Bopper"));
+    assert(4 == rope_indexof_str(r, 0, "y Bop"));
+    assert(10 == rope_indexof_str(r, 0, "er Buffer Fl"));
+    assert(17 == rope_indexof_str(r, 11, "er"));
+    assert(-1 == rope_indexof_str(r, 0, "Duffer"));
+
+    c = rope_copy(r, 6, 13);
+
+    assert(NULL != c);
+    assert(13 == rope_length(c));
+    test_rope_equals(c, "Bopper Buffer");
+
+    // the copy shares its chunks and is unaffected by edits to the original
+    assert(rope_remove(r, 0, 13));
+    test_rope_equals(r, "Buffer Fluffer");
+    test_rope_equals(c, "Bopper Buffer");
+    assert(rope_remove(r, 6, 8));
+    test_rope_equals(r, "Buffer");
+    assert(rope_cleanup(c));
+    free(c);
+
+    memset(&b, 0, sizeof(Buffer));
+
+    assert(buffer_init(&b, 1, false));
+
+    for (int32_t i = 0; i < 10000; i++) {
+        assert(buffer_append_str(&b, "0123456789"));
+    }
+
+    assert(rope_append_buffer(r, &b));
+    assert(100006 == rope_length(r));
+    assert(2 == rope_indexof_str(r, 0, "ffer0123"));
+    assert(__ROPE_CHUNK_SIZE + 4 == rope_indexof_str(r, __ROPE_CHUNK_SIZE, "45678"));
+    assert(buffer_cleanup(&b));
+    assert(rope_cleanup(r));
+    free(r);
+
+    test_rope_small_edits();
+}
+
+#endif
@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __TEST_SERIAL_H
+#define __TEST_SERIAL_H
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "codebox/container/buffer.h"
+#include "codebox/container/serial.h"
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void test_serial () {
+    Buffer         b;
+    BufferReader   r;
+    BufferWriter   w;
+    unsigned char* blob;
+    unsigned char  bytes[4];
+    int64_t        length;
+    uint64_t       varints[] = { 0, 1, 127, 128, 300, 16383, 16384, UINT32_MAX, UINT64_MAX };
+    int64_t        svarints[] = { 0, -1, 1, -64, 64, INT64_MIN, INT64_MAX };
+
+    memset(&b, 0, sizeof(Buffer));
+    assert(buffer_init(&b, 1, false));
+    assert(buffer_append_str(&b, "hdr"));
+
+    // fixed-width values are written in the byte order asked for
+    buffer_writer_init(&w, &b);
+    assert(buffer_writer_reserve(&w, 64));
+    assert(64 <= b.size - b.length);
+    assert(buffer_writer_u8(&w, 0xAB));
+    assert(buffer_writer_u16le(&w, 0x0102));
+    assert(buffer_writer_u16be(&w, 0x0102));
+    assert(buffer_writer_u32le(&w, 0x01020304));
+    assert(buffer_writer_u32be(&w, 0x01020304));
+    assert(buffer_writer_u64le(&w, 0x0102030405060708));
+    assert(buffer_writer_u64be(&w, 0x0102030405060708));
+    assert(0 == memcmp("hdr\xAB\x02\x01\x01\x02\x04\x03\x02\x01\x01\x02\x03\x04", b.data, 16));
+    assert(0 == memcmp("\x08\x07\x06\x05\x04\x03\x02\x01\x01\x02\x03\x04\x05\x06\x07\x08",
+                       b.data + 16, 16));
+    assert(buffer_writer_f32le(&w, 1.5f));
+    assert(buffer_writer_f32be(&w, -2.25f));
+    assert(buffer_writer_f64le(&w, 3.125));
+    assert(buffer_writer_f64be(&w, -1e300));
+
+    // varints use the fewest bytes their value needs
+    length = b.length;
+    assert(buffer_writer_varint(&w, 300));
+    assert(2 == b.length - length);
+    assert(0 == memcmp("\xAC\x02", b.data + length, 2));
+    assert(buffer_writer_svarint(&w, -1));
+    assert(1 == b.data[b.length - 1]);
+
+    for (int32_t i = 0; i < sizeof(varints) / sizeof(uint64_t); i++) {
+        assert(buffer_writer_varint(&w, varints[i]));
+    }
+
+    for (int32_t i = 0; i < sizeof(svarints) / sizeof(int64_t); i++) {
+        assert(buffer_writer_svarint(&w, svarints[i]));
+    }
+
+    assert(buffer_writer_blob(&w, (unsigned char*) "blob", 4));
+    assert(buffer_writer_blob(&w, NULL, 0));
+    assert(buffer_writer_bytes(&w, (unsigned char*) "end", 3));
+
+    // everything reads back in order, and the frame is checked for errors once
+    buffer_reader_init(&r, &b);
+    assert(buffer_reader_bytes(&r, bytes, 3));
+    assert(0 == memcmp("hdr", bytes, 3));
+    assert(0xAB == buffer_reader_u8(&r));
+    assert(0x0102 == buffer_reader_u16le(&r));
+    assert(0x0102 == buffer_reader_u16be(&r));
+    assert(0x01020304 == buffer_reader_u32le(&r));
+    assert(0x01020304 == buffer_reader_u32be(&r));
+    assert(0x0102030405060708 == buffer_reader_u64le(&r));
+    assert(0x0102030405060708 == buffer_reader_u64be(&r));
+    assert(1.5f == buffer_reader_f32le(&r));
+    assert(-2.25f == buffer_reader_f32be(&r));
+    assert(3.125 == buffer_reader_f64le(&r));
+    assert(-1e300 == buffer_reader_f64be(&r));
+    assert(300 == buffer_reader_varint(&r));
+    assert(-1 == buffer_reader_svarint(&r));
+
+    for (int32_t i = 0; i < sizeof(varints) / sizeof(uint64_t); i++) {
+        assert(varints[i] == buffer_reader_varint(&r));
+    }
+
+    for (int32_t i = 0; i < sizeof(svarints) / sizeof(int64_t); i++) {
+        assert(svarints[i] == buffer_reader_svarint(&r));
+    }
+
+    assert(NULL != (blob = buffer_reader_blob(&r, &length)));
+    assert(4 == length);
+    assert(0 == memcmp("blob", blob, 4));
+    assert(NULL != buffer_reader_blob(&r, &length));
+    assert(0 == length);
+    assert(buffer_reader_require(&r, 3));
+    assert(!buffer_reader_require(&r, 4));
+    assert(r.error);
+
+    r.error = false;
+    assert(buffer_reader_bytes(&r, bytes, 3));
+    assert(0 == buffer_reader_remaining(&r));
+    assert(!r.error);
+
+    // reads past the end return 0 and set the error flag
+    assert(0 == buffer_reader_u32le(&r));
+    assert(0 == buffer_reader_u8(&r));
+    assert(0 == buffer_reader_varint(&r));
+    assert(r.error);
+
+    // truncated and overlong varints and blobs are errors
+    buffer_truncate(&b);
+    assert(buffer_append(&b, (unsigned char*) "\x80\x80", 2));
+    buffer_reader_init(&r, &b);
+    assert(0 == buffer_reader_varint(&r));
+    assert(r.error);
+
+    buffer_truncate(&b);
+    assert(buffer_append(&b, (unsigned char*) "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x02", 10));
+    buffer_reader_init(&r, &b);
+    assert(0 == buffer_reader_varint(&r));
+    assert(r.error);
+
+    buffer_truncate(&b);
+    assert(buffer_append(&b, (unsigned char*) "\x05" "abc", 4));
+    buffer_reader_init(&r, &b);
+    assert(NULL == buffer_reader_blob(&r, &length));
+    assert(0 == length);
+    assert(r.error);
+
+    assert(buffer_cleanup(&b));
+}
+
+#endif
@@ -37,7 +37,35 @@
 // -------------------------------------------------------------------------------------------------
 
 void test_table () {
-    Table* t = table_new();
+    char          keys[64][8];
+    bool          seen[64];
+    TableIterator iter;
+    unsigned char long1[100];
+    unsigned char long2[100];
+    int32_t       count = 0;
+    Table*        t     = table_new();
+
+    memset(long1, 'x', sizeof(long1));
+    memset(long2, 'x', sizeof(long2));
+
+    assert(compare_binary((unsigned char*) "Key", 3, (unsigned char*) "Key", 3));
+    assert(!compare_binary((unsigned char*) "Key", 3, (unsigned char*) "Key1", 4));
+    assert(!compare_binary((unsigned char*) "Key12345", 8, (unsigned char*) "Key12346", 8));
+
+    for (int32_t length = 1; length <= 100; length++) {
+        assert(compare_binary(long1, length, long2, length));
+
+        long2[length - 1] = 'y';
+
+        assert(!compare_binary(long1, length, long2, length));
+
+        long2[length - 1] = 'x';
+        long2[0]          = 'y';
+
+        assert(!compare_binary(long1, length, long2, length));
+
+        long2[0] = 'x';
+    }
 
     assert(NULL != t);
     assert(table_init_defaults_ts(t));
@@ -50,7 +78,10 @@ void test_table () {
     assert(table_put_str(t, "Key6", "Value6"));
     assert(table_put_str(t, "Key7", "Value7"));
     assert(table_put_str(t, "Key8", "Value8"));
+    assert(NULL == t->buckets);
+    assert(0 == strcmp("Value8", table_get_str(t, "Key8")));
     assert(table_put_str(t, "Key9", "Value9"));
+    assert(NULL != t->buckets);
     assert(9 == t->key_count);
     assert(0 == strcmp("Value1", table_get_str(t, "Key1")));
     assert(0 == strcmp("Value2", table_get_str(t, "Key2")));
@@ -111,6 +142,113 @@ void test_table () {
     assert(0 == table_has_key_str(t, "Key7"));
     assert(0 == table_has_key_str(t, "Key8"));
     assert(0 == table_has_key_str(t, "Key9"));
+    assert(0 == table_resize(t, 1610612741 + 1));
+    assert(3079 == t->bucket_count);
+    assert(table_cleanup(t));
+    free(t);
+
+    t = table_new();
+
+    assert(NULL != t);
+    assert(table_init_defaults(t));
+    assert(table_put_str(t, "Key1", "Value1"));
+    assert(table_put_str(t, "Key2", "Value2"));
+    assert(table_put_str(t, "Key3", "Value3"));
+    assert(NULL == t->buckets);
+    assert(0 == strcmp("Value1", (char*) table_remove_str(t, "Key1")));
+    assert(NULL == table_remove_str(t, "Key1"));
+    assert(2 == t->key_count);
+    assert(0 == strcmp("Value3", table_get_str(t, "Key3")));
+
+    table_iter_init(&iter, t);
+
+    for (; table_iter_next(&iter); count++) {
+        assert(0 == strncmp("Value", (char*) table_iter_value(&iter), 5));
+    }
+
+    assert(2 == count);
+    assert(1 == table_resize(t, 1));
+    assert(NULL != t->buckets);
+    assert(53 == t->bucket_count);
+    assert(0 == strcmp("Value2", table_get_str(t, "Key2")));
+    assert(0 == strcmp("Value3", table_get_str(t, "Key3")));
+    assert(0 == strcmp("Value2", (char*) table_remove_str(t, "Key2")));
+    assert(0 == strcmp("Value3", (char*) table_remove_str(t, "Key3")));
+    assert(0 == t->key_count);
+    assert(table_cleanup(t));
+    free(t);
+
+    t = table_new();
+
+    assert(NULL != t);
+    assert(table_init_defaults_ts(t));
+
+    for (int32_t i = 0; i < 39; i++) {
+        snprintf(keys[i], sizeof(keys[i]), "Key%d", i);
+        assert(table_put_str(t, keys[i], keys[i]));
+    }
+
+    assert(53 == t->bucket_count);
+
+    memset(seen, 0, sizeof(seen));
+    table_iter_init_ts(&iter, t);
+
+    // puts during iteration must not resize the table underneath the iterator, nor yield an entry
+    // twice
+    for (count = 0; table_iter_next_ts(&iter); count++) {
+        int32_t index = atoi((char*) table_iter_key(&iter) + 3);
+
+        assert(0 <= index && index < 64);
+        assert(!seen[index]);
+
+        seen[index] = true;
+
+        if (count < 25) {
+            snprintf(keys[39 + count], sizeof(keys[39 + count]), "Key%d", 39 + count);
+            assert(table_put_ts(t, (unsigned char*) keys[39 + count], strlen(keys[39 + count]),
+                                keys[39 + count]));
+        }
+
+        assert(table_iter_key(&iter) == table_iter_value(&iter));
+    }
+
+    assert(39 <= count && count <= 64);
+    assert(53 == t->bucket_count);
+    assert(0 == table_resize_ts(t, 54));
+
+    table_iter_cleanup_ts(&iter);
+
+    assert(97 == t->bucket_count);
+    assert(64 == table_key_count_ts(t));
+
+    for (int32_t i = 0; i < 64; i++) {
+        assert(keys[i] == (char*) table_remove_str(t, keys[i]));
+    }
+
+    assert(0 == table_key_count_ts(t));
+    assert(table_cleanup(t));
+    free(t);
+
+    t = table_new();
+
+    assert(NULL != t);
+    assert(table_init_defaults_64(t));
+    assert(NULL == t->hash_func);
+    assert(NULL != t->hash64_func);
+
+    assert(table_put_str(t, "Key1", "Value1"));
+    assert(table_put_str(t, "Key2", "Value2"));
+    assert(2 == table_key_count(t));
+    assert(0 == strcmp("Value1", table_get_str(t, "Key1")));
+    assert(0 == strcmp("Value2", table_get_str(t, "Key2")));
+    assert(1 == table_resize(t, t->bucket_count + 1));
+    assert(97 == t->bucket_count);
+    assert(1 == table_has_key_str(t, "Key1"));
+    assert(1 == table_has_key_str(t, "Key2"));
+    assert(0 == strcmp("Value2", (char*) table_remove_str(t, "Key2")));
+    assert(1 == table_key_count(t));
+    assert(0 == strcmp("Value1", (char*) table_remove_str(t, "Key1")));
+    assert(0 == table_key_count(t));
     assert(table_cleanup(t));
     free(t);
 }
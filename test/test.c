@@ -9,23 +9,56 @@
 #include <stdio.h>
 
 #include "container/test_buffer.h"
+#include "container/test_chain.h"
+#include "container/test_cuckoo.h"
 #include "container/test_list.h"
+#include "container/test_log.h"
+#include "container/test_pool.h"
+#include "container/test_ring.h"
+#include "container/test_rope.h"
+#include "container/test_serial.h"
 #include "container/test_stack.h"
 #include "container/test_table.h"
+#include "test_checksum.h"
+#include "test_encoding.h"
+#include "test_format.h"
 #include "test_io.h"
+#include "test_lz.h"
 #include "test_string.h"
 
 int main (int arg, char** argv) {
     printf("Testing buffer...\n");
     test_buffer();
+    printf("Testing chain...\n");
+    test_chain();
+    printf("Testing cuckoo...\n");
+    test_cuckoo();
     printf("Testing list...\n");
     test_list();
+    printf("Testing log...\n");
+    test_log();
+    printf("Testing pool...\n");
+    test_pool();
+    printf("Testing ring...\n");
+    test_ring();
+    printf("Testing rope...\n");
+    test_rope();
+    printf("Testing serial...\n");
+    test_serial();
     printf("Testing stack...\n");
     test_stack();
     printf("Testing table...\n");
     test_table();
+    printf("Testing checksum...\n");
+    test_checksum();
+    printf("Testing encoding...\n");
+    test_encoding();
+    printf("Testing format...\n");
+    test_format();
     printf("Testing io...\n");
     test_io();
+    printf("Testing lz...\n");
+    test_lz();
     printf("Testing string...\n");
     test_string();
 }
@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __TEST_CHECKSUM_H
+#define __TEST_CHECKSUM_H
+#endif
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "codebox/checksum.h"
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Checksum data a bit at a time.
+ */
+static uint32_t __test_crc32c (unsigned char* data, int64_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (int64_t i = 0; i < length; i++) {
+        crc ^= data[i];
+
+        for (int32_t j = 0; j < 8; j++) {
+            crc = crc & 1 ? (crc >> 1) ^ 0x82F63B78 : crc >> 1;
+        }
+    }
+
+    return ~crc;
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void test_checksum () {
+    int64_t        length = 100000;
+    unsigned char* data   = malloc(length);
+    Buffer         buffer;
+    Hash64         hash;
+    int64_t        split;
+
+    assert(NULL != data);
+
+    for (int64_t i = 0; i < length; i++) {
+        data[i] = (unsigned char) (i * 2654435761u >> 11);
+    }
+
+    assert(0 == crc32c(0, NULL, 0));
+    assert(0xE3069283 == crc32c(0, (unsigned char*) "123456789", 9));
+    assert(0xEF46DB3751D8E999ULL == hash64((unsigned char*) "", 0, 0));
+    assert(0xD24EC4F1A98C6E5BULL == hash64((unsigned char*) "a", 1, 0));
+    assert(0x44BC2CF5AD770999ULL == hash64((unsigned char*) "abc", 3, 0));
+    assert(0xFBCEA83C8A378BF1ULL == hash64((unsigned char*) "Nobody inspects the spammish repetition",
+                                           39, 0));
+
+    // lengths across the interleaved blocks, checksummed whole and in two parts
+    for (int64_t i = 1; i < length; i += 1 + i / 4) {
+        split = i / 3;
+
+        assert(__test_crc32c(data, i) == crc32c(0, data, i));
+        assert(crc32c(0, data, i) == crc32c(crc32c(0, data, split), data + split, i - split));
+
+        hash64_init(&hash, i);
+        hash64_update(&hash, data, split);
+        hash64_update(&hash, data + split, 1);
+        hash64_update(&hash, data + split + 1, i - split - 1);
+        assert(hash64(data, i, i) == hash64_digest(&hash));
+    }
+
+    // gapped buffers are checksummed without moving the gap
+    memset(&buffer, 0, sizeof(Buffer));
+    assert(buffer_init(&buffer, 1, false));
+    buffer_set_gapped(&buffer, true);
+    assert(buffer_append(&buffer, data, 1000));
+    assert(buffer_insert(&buffer, 500, data + 1000, 10));
+    assert(510 == buffer.gap);
+
+    memcpy(data + 2000, data, 500);
+    memcpy(data + 2500, data + 1000, 10);
+    memcpy(data + 2510, data + 500, 500);
+
+    assert(crc32c(0, data + 2000, 1010) == crc32c_buffer(0, &buffer));
+    assert(hash64(data + 2000, 1010, 7) == hash64_buffer(&buffer, 7));
+    assert(510 == buffer.gap);
+    assert(buffer_cleanup(&buffer));
+
+    free(data);
+}
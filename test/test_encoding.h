@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __TEST_ENCODING_H
+#define __TEST_ENCODING_H
+#endif
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "codebox/encoding.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define assert_encoding(__func, __data, __alphabet, __expected) \
+    buffer_truncate(&dest); \
+    assert(__func(&dest, (unsigned char*) __data, strlen(__data), __alphabet)); \
+    assert(strlen(__expected) == dest.length); \
+    assert(0 == strncmp(__expected, (char*) dest.data, dest.length));
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void test_encoding () {
+    Buffer        dest;
+    Buffer        source;
+    unsigned char data[1024];
+
+    memset(&dest, 0, sizeof(Buffer));
+    memset(&source, 0, sizeof(Buffer));
+    assert(buffer_init(&dest, 1, false));
+    assert(buffer_init(&source, 1, false));
+
+    // the test vectors of RFC 4648
+    assert_encoding(base64_encode, "", BASE64_STANDARD, "");
+    assert_encoding(base64_encode, "f", BASE64_STANDARD, "Zg==");
+    assert_encoding(base64_encode, "fo", BASE64_STANDARD, "Zm8=");
+    assert_encoding(base64_encode, "foo", BASE64_STANDARD, "Zm9v");
+    assert_encoding(base64_encode, "foob", BASE64_STANDARD, "Zm9vYg==");
+    assert_encoding(base64_encode, "fooba", BASE64_STANDARD, "Zm9vYmE=");
+    assert_encoding(base64_encode, "foobar", BASE64_STANDARD, "Zm9vYmFy");
+    assert_encoding(base64_encode, "fooba", BASE64_URL, "Zm9vYmE");
+    assert_encoding(base64_encode, "\xFB\xFF\xBF\xFB\xFF\xBF\xFB\xFF\xBF\xFB\xFF\xBF\xFB\xFF\xBF\xFB",
+                    BASE64_STANDARD, "+/+/+/+/+/+/+/+/+/+/+w==");
+    assert_encoding(base64_encode, "\xFB\xFF\xBF\xFB\xFF\xBF\xFB\xFF\xBF\xFB\xFF\xBF\xFB\xFF\xBF\xFB",
+                    BASE64_URL, "-_-_-_-_-_-_-_-_-_-_-w");
+    assert_encoding(base64_decode, "Zm9vYmE=", BASE64_STANDARD, "fooba");
+    assert_encoding(base64_decode, "Zm9vYmE", BASE64_STANDARD, "fooba");
+    assert_encoding(base64_decode, "Zm9vYg==", BASE64_URL, "foob");
+    assert_encoding(base64_decode, "-_-_-_-_-_-_-_-_-_-_-w", BASE64_URL,
+                    "\xFB\xFF\xBF\xFB\xFF\xBF\xFB\xFF\xBF\xFB\xFF\xBF\xFB\xFF\xBF\xFB");
+
+    // invalid data leaves the destination unchanged
+    buffer_truncate(&dest);
+    assert(buffer_append_str(&dest, "x"));
+    assert(!base64_decode(&dest, (unsigned char*) "Zm9vY", 5, BASE64_STANDARD));
+    assert(!base64_decode(&dest, (unsigned char*) "Zm9v=mFy", 8, BASE64_STANDARD));
+    assert(!base64_decode(&dest, (unsigned char*) "+/+/+/+/+/+/+/+/", 16, BASE64_URL));
+    assert(!base64_decode(&dest, (unsigned char*) "Zm9vYmFyZm9vYmFyZm9vYmFyZm9vYmF\x80", 32,
+                          BASE64_STANDARD));
+    assert(1 == dest.length);
+
+    buffer_truncate(&dest);
+    assert(hex_encode(&dest, (unsigned char*) "\x00\x01\xAB\xFF", 4));
+    assert(0 == strncmp("0001abff", (char*) dest.data, dest.length));
+    assert(hex_decode(&dest, (unsigned char*) "0001ABff", 8));
+    assert(12 == dest.length);
+    assert(0 == memcmp("0001abff\x00\x01\xAB\xFF", dest.data, dest.length));
+    assert(!hex_decode(&dest, (unsigned char*) "abc", 3));
+    assert(!hex_decode(&dest, (unsigned char*) "0g", 2));
+    assert(!hex_decode(&dest, (unsigned char*) "000102030405060708090a0b0c0d0e0f"
+                                               "000102030405060708090a0b0c0d0e0G", 64));
+    assert(12 == dest.length);
+
+    // lengths around the vector block sizes round trip through both encodings
+    for (int32_t i = 0; i < sizeof(data); i++) {
+        data[i] = (unsigned char) (i * 131 + 7);
+    }
+
+    for (int64_t length = 1; length <= sizeof(data); length += 1 + length / 8) {
+        for (Base64Alphabet alphabet = BASE64_STANDARD; alphabet <= BASE64_URL; alphabet++) {
+            buffer_truncate(&source);
+            buffer_truncate(&dest);
+            assert(base64_encode(&source, data, length, alphabet));
+            assert(base64_decode_buffer(&dest, &source, alphabet));
+            assert(length == dest.length);
+            assert(0 == memcmp(data, dest.data, length));
+        }
+
+        buffer_truncate(&source);
+        buffer_truncate(&dest);
+        assert(hex_encode(&source, data, length));
+        assert(2 * length == source.length);
+        assert(hex_decode_buffer(&dest, &source));
+        assert(length == dest.length);
+        assert(0 == memcmp(data, dest.data, length));
+    }
+
+    buffer_truncate(&source);
+    buffer_truncate(&dest);
+    assert(buffer_append_str(&source, "foobar"));
+    assert(base64_encode_buffer(&dest, &source, BASE64_STANDARD));
+    assert(hex_encode_buffer(&dest, &source));
+    assert(0 == strncmp("Zm9vYmFy666f6f626172", (char*) dest.data, dest.length));
+
+    assert(buffer_cleanup(&dest));
+    assert(buffer_cleanup(&source));
+}
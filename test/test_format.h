@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __TEST_FORMAT_H
+#define __TEST_FORMAT_H
+#endif
+
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "codebox/format.h"
+
+// -------------------------------------------------------------------------------------------------
+// MACROS
+// -------------------------------------------------------------------------------------------------
+
+#define assert_format(__func, __value, __expected) \
+    __length = __func(__dest, __value); \
+    assert(strlen(__expected) == __length); \
+    assert(0 == strncmp(__expected, __dest, __length));
+
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Count the significant digits of a formatted number.
+ */
+static int32_t __test_format_digits (char* data) {
+    int32_t count    = 0;
+    int32_t trailing = 0;
+
+    for (; 0 != *data && 'e' != *data; data++) {
+        if ('1' <= *data && '9' >= *data) {
+            count   += trailing + 1;
+            trailing = 0;
+        } else if ('0' == *data && 0 < count) {
+            trailing++;
+        }
+    }
+
+    return count;
+}
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void test_format () {
+    char     __dest[FORMAT_F64_MAX + 1];
+    int32_t  __length;
+    uint64_t bits;
+    char     expected[32];
+    uint64_t seed = 88172645463325252ULL;
+    double   value;
+
+    assert_format(format_i64, 0, "0");
+    assert_format(format_i64, -7, "-7");
+    assert_format(format_i64, 1234567890, "1234567890");
+    assert_format(format_i64, INT64_MAX, "9223372036854775807");
+    assert_format(format_i64, INT64_MIN, "-9223372036854775808");
+    assert_format(format_u64, 9, "9");
+    assert_format(format_u64, 10, "10");
+    assert_format(format_u64, 100, "100");
+    assert_format(format_u64, 9999999999999999999ULL, "9999999999999999999");
+    assert_format(format_u64, 10000000000000000000ULL, "10000000000000000000");
+    assert_format(format_u64, UINT64_MAX, "18446744073709551615");
+
+    // doubles are written with the fewest digits that parse back to the same value
+    assert_format(format_f64, 0.0, "0");
+    assert_format(format_f64, -0.0, "-0");
+    assert_format(format_f64, 1.0, "1");
+    assert_format(format_f64, -1.5, "-1.5");
+    assert_format(format_f64, 0.1, "0.1");
+    assert_format(format_f64, 0.3, "0.3");
+    assert_format(format_f64, 0.1 + 0.2, "0.30000000000000004");
+    assert_format(format_f64, 1500.0, "1500");
+    assert_format(format_f64, 123.456, "123.456");
+    assert_format(format_f64, 0.00001, "0.00001");
+    assert_format(format_f64, 0.000001, "1e-6");
+    assert_format(format_f64, 1e20, "100000000000000000000");
+    assert_format(format_f64, 1e21, "1e+21");
+    assert_format(format_f64, 9007199254740993.0, "9007199254740992");
+    assert_format(format_f64, 5e-324, "5e-324");
+    assert_format(format_f64, -2.2250738585072014e-308, "-2.2250738585072014e-308");
+    assert_format(format_f64, 1.7976931348623157e308, "1.7976931348623157e+308");
+    assert_format(format_f64, INFINITY, "inf");
+    assert_format(format_f64, -INFINITY, "-inf");
+    assert_format(format_f64, NAN, "nan");
+
+    for (int32_t i = 0; i < 20000; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        bits  = seed;
+
+        memcpy(&value, &bits, sizeof(double));
+
+        if (isnan(value) || isinf(value)) {
+            continue;
+        }
+
+        __length = format_f64(__dest, value);
+
+        assert(FORMAT_F64_MAX >= __length);
+
+        __dest[__length] = 0;
+
+        assert(value == strtod(__dest, NULL));
+
+        // the shortest precision that round trips has as many digits
+        for (int32_t precision = 1; precision <= 17; precision++) {
+            snprintf(expected, sizeof(expected), "%.*e", precision - 1, value);
+
+            if (value == strtod(expected, NULL)) {
+                assert(precision == __test_format_digits(__dest));
+                break;
+            }
+        }
+    }
+}
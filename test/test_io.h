@@ -11,15 +11,178 @@
 #endif
 
 #include <assert.h>
+#include <fcntl.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
+#include "codebox/container/buffer.h"
+#include "codebox/container/serial.h"
 #include "codebox/io.h"
 
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+/**
+ * Open a temporary file that holds the data of a buffer.
+ */
+static int __test_io_open (Buffer* buffer) {
+    char path[] = "/tmp/test_io_XXXXXX";
+    int  fd     = mkstemp(path);
+
+    assert(-1 != fd);
+    assert(0 == unlink(path));
+    assert(buffer->length == write(fd, buffer_data(buffer), buffer->length));
+    assert(0 == lseek(fd, 0, SEEK_SET));
+
+    return fd;
+}
+
+/**
+ * Test reading delimited and length-prefixed records from a file descriptor.
+ */
+static void __test_io_reader () {
+    Buffer         buffer;
+    int            fd;
+    int            fds[2];
+    int64_t        length;
+    char           line[32];
+    IoReader       reader;
+    unsigned char* record;
+    BufferWriter   writer;
+
+    memset(&buffer, 0, sizeof(Buffer));
+    assert(buffer_init(&buffer, 1, false));
+
+    // lines that span many reads, so the partial line at the end of each is moved
+    for (int32_t i = 0; i < 100000; i++) {
+        snprintf(line, sizeof(line), "line %d%s\n", i, i % 7 ? "" : " of a longer length");
+        assert(buffer_append_str(&buffer, line));
+    }
+
+    assert(buffer_append_str(&buffer, "unterminated"));
+
+    fd = __test_io_open(&buffer);
+
+    assert(io_reader_init(&reader, fd, IO_RECORD_DELIMITED, (unsigned char*) "\n", 1, 64));
+
+    for (int32_t i = 0; i < 100000; i++) {
+        snprintf(line, sizeof(line), "line %d%s", i, i % 7 ? "" : " of a longer length");
+        assert(io_reader_next(&reader, &record, &length));
+        assert((int64_t) strlen(line) == length);
+        assert(0 == memcmp(line, record, length));
+    }
+
+    assert(io_reader_next(&reader, &record, &length));
+    assert(12 == length);
+    assert(0 == memcmp("unterminated", record, 12));
+    assert(!io_reader_next(&reader, &record, &length));
+    assert(reader.eof);
+    assert(!reader.error);
+    assert(io_reader_cleanup(&reader));
+    close(fd);
+
+    // a delimiter of several bytes, and a record that is too long
+    buffer_truncate(&buffer);
+    assert(buffer_append_str(&buffer, "a\r\n\r\nbc\rd\r\n0123456789\r\n"));
+
+    fd = __test_io_open(&buffer);
+
+    assert(io_reader_init(&reader, fd, IO_RECORD_DELIMITED, (unsigned char*) "\r\n", 2, 8));
+    assert(io_reader_next(&reader, &record, &length));
+    assert(1 == length && 'a' == record[0]);
+    assert(io_reader_next(&reader, &record, &length));
+    assert(0 == length);
+    assert(io_reader_next(&reader, &record, &length));
+    assert(4 == length && 0 == memcmp("bc\rd", record, 4));
+    assert(!io_reader_next(&reader, &record, &length));
+    assert(reader.error);
+    assert(io_reader_cleanup(&reader));
+    close(fd);
+
+    // length-prefixed records, the last of which is cut short
+    buffer_truncate(&buffer);
+    buffer_writer_init(&writer, &buffer);
+
+    for (int32_t i = 0; i < 1000; i++) {
+        memset(line, 'a' + i % 26, sizeof(line));
+        assert(buffer_writer_blob(&writer, (unsigned char*) line, i % sizeof(line)));
+    }
+
+    assert(buffer_writer_blob(&writer, (unsigned char*) "cut", 3));
+    buffer.length--;
+
+    fd = __test_io_open(&buffer);
+
+    assert(io_reader_init(&reader, fd, IO_RECORD_PREFIXED, NULL, 0, 1024));
+
+    for (int32_t i = 0; i < 1000; i++) {
+        assert(io_reader_next(&reader, &record, &length));
+        assert((int64_t) (i % sizeof(line)) == length);
+        assert(0 == length || ('a' + i % 26 == record[0] && record[0] == record[length - 1]));
+    }
+
+    assert(!io_reader_next(&reader, &record, &length));
+    assert(reader.eof);
+    assert(reader.error);
+    assert(io_reader_cleanup(&reader));
+    close(fd);
+
+    // a record split across writes to a non-blocking pipe
+    assert(0 == pipe(fds));
+    assert(0 == fcntl(fds[0], F_SETFL, O_NONBLOCK));
+    assert(io_reader_init(&reader, fds[0], IO_RECORD_DELIMITED, (unsigned char*) "\r\n", 2, 64));
+    assert(!io_reader_next(&reader, &record, &length));
+    assert(3 == write(fds[1], "one", 3));
+    assert(!io_reader_next(&reader, &record, &length));
+    assert(2 == write(fds[1], "\r\r", 2));
+    assert(!io_reader_next(&reader, &record, &length));
+    assert(!reader.eof && !reader.error);
+    assert(5 == write(fds[1], "\ntwo\r", 5));
+    assert(io_reader_next(&reader, &record, &length));
+    assert(4 == length && 0 == memcmp("one\r", record, 4));
+    close(fds[1]);
+    assert(io_reader_next(&reader, &record, &length));
+    assert(4 == length && 0 == memcmp("two\r", record, 4));
+    assert(!io_reader_next(&reader, &record, &length));
+    assert(reader.eof && !reader.error);
+    assert(io_reader_cleanup(&reader));
+    close(fds[0]);
+
+    assert(buffer_cleanup(&buffer));
+}
+
 // -------------------------------------------------------------------------------------------------
 // FUNCTIONS
 // -------------------------------------------------------------------------------------------------
 
 void test_io () {
+    char           path[] = "/tmp/test_io_XXXXXX";
+    int            fd     = mkstemp(path);
+    int64_t        length = -1;
+    unsigned char* data;
+    char*          str;
+
+    assert(-1 != fd);
+    assert(5 == write(fd, "Hello", 5));
+    close(fd);
+
+    assert(NULL != (data = io_file_read(path, &length)));
+    assert(5 == length);
+    assert(0 == memcmp("Hello", data, 5));
+    assert(NULL != (str = io_file_read_str(path)));
+    assert(0 == strcmp("Hello", str));
+
+    free(data);
+    free(str);
+
+    assert(0 == unlink(path));
+    assert(NULL == io_file_read(path, &length));
+    assert(0 == length);
+    assert(NULL == io_file_read_str(path));
+
+    __test_io_reader();
 }
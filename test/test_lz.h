@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2014 Sean Kerr
+ *
+ * Please view the LICENSE file for a full description of the license.
+ *
+ * @author Sean Kerr: sean@code-box.org
+ */
+
+#ifndef __TEST_LZ_H
+#define __TEST_LZ_H
+#endif
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "codebox/lz.h"
+
+// -------------------------------------------------------------------------------------------------
+// FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+void test_lz () {
+    Buffer        compressed;
+    unsigned char data[300000];
+    LzDecoder     decoder;
+    Buffer        dest;
+    LzEncoder     encoder;
+    int64_t       length;
+    uint32_t      seed = 1;
+
+    memset(&compressed, 0, sizeof(Buffer));
+    memset(&dest, 0, sizeof(Buffer));
+    assert(buffer_init(&compressed, 1, false));
+    assert(buffer_init(&dest, 1, false));
+
+    // a block of the LZ4 block format, with a match overlapping its own output
+    assert(lz_decompress(&dest, (unsigned char*) "\x1A" "a\x01\x00\x30xyz", 8, 100));
+    assert(18 == dest.length);
+    assert(0 == memcmp("aaaaaaaaaaaaaaaxyz", dest.data, dest.length));
+
+    // blocks that are not valid or do not fit leave the destination unchanged
+    assert(!lz_decompress(&dest, (unsigned char*) "\x1A" "a\x01\x00\x30xyz", 8, 17));
+    assert(!lz_decompress(&dest, (unsigned char*) "\x1A" "a\x02\x00\x30xyz", 8, 100));
+    assert(!lz_decompress(&dest, (unsigned char*) "\x1A" "a\x01\x00", 4, 100));
+    assert(!lz_decompress(&dest, (unsigned char*) "\xF0\xFF", 2, 100));
+    assert(!lz_decompress(&dest, (unsigned char*) "", 0, 100));
+    assert(18 == dest.length);
+
+    // text, runs and noise
+    for (int32_t i = 0; i < sizeof(data); i++) {
+        seed = seed * 1103515245 + 12345;
+
+        if (100000 > i) {
+            data[i] = "the quick brown fox jumps over the lazy dog "[(i * 7 + (seed >> 28)) % 44];
+        } else if (200000 > i) {
+            data[i] = (unsigned char) (i / 1000);
+        } else {
+            data[i] = (unsigned char) (seed >> 16);
+        }
+    }
+
+    for (length = 0; length <= sizeof(data); length += 1 + length / 3) {
+        buffer_truncate(&compressed);
+        buffer_truncate(&dest);
+        assert(lz_compress(&compressed, data, length));
+        assert(LZ_BOUND(length) >= compressed.length);
+        assert(lz_decompress_buffer(&dest, &compressed, length));
+        assert(length == dest.length);
+        assert(0 == memcmp(data, dest.data, length));
+    }
+
+    buffer_truncate(&compressed);
+    assert(lz_compress(&compressed, data + 100000, 100000));
+    assert(1000 > compressed.length);
+
+    // corrupted blocks fail or decompress to something, but never write past their space
+    for (int64_t i = 0; i < compressed.length; i += 7) {
+        compressed.data[i] ^= 0x5A;
+        buffer_truncate(&dest);
+        lz_decompress(&dest, compressed.data, compressed.length, 100000);
+        lz_decompress(&dest, compressed.data, i, 100000);
+        compressed.data[i] ^= 0x5A;
+    }
+
+    // whole frames, with and without checksums
+    for (int32_t flags = 0; flags <= (LZ_FRAME_BLOCK_CHECKSUM | LZ_FRAME_CONTENT_CHECKSUM);
+         flags++) {
+        buffer_truncate(&compressed);
+        buffer_truncate(&dest);
+        assert(lz_frame_compress(&compressed, data, sizeof(data), flags));
+        assert(sizeof(data) > compressed.length);
+        assert(lz_frame_decompress_buffer(&dest, &compressed));
+        assert(sizeof(data) == dest.length);
+        assert(0 == memcmp(data, dest.data, dest.length));
+    }
+
+    buffer_truncate(&compressed);
+    buffer_truncate(&dest);
+    assert(lz_frame_compress(&compressed, data, 0, LZ_FRAME_CONTENT_CHECKSUM));
+    assert(16 == compressed.length);
+    assert(lz_frame_decompress_buffer(&dest, &compressed));
+    assert(0 == dest.length);
+
+    // streams written and read in parts of any length
+    buffer_truncate(&compressed);
+    assert(lz_encoder_init(&encoder, LZ_FRAME_BLOCK_CHECKSUM | LZ_FRAME_CONTENT_CHECKSUM));
+
+    for (int64_t i = 0; i < sizeof(data); i += length) {
+        length = sizeof(data) - i < 1 + i % 70001 ? sizeof(data) - i : 1 + i % 70001;
+
+        assert(lz_encoder_write(&encoder, &compressed, data + i, length));
+    }
+
+    assert(lz_encoder_finish(&encoder, &compressed));
+    assert(lz_encoder_cleanup(&encoder));
+
+    for (int64_t step = 1; step < compressed.length; step = step * 5 + 3) {
+        buffer_truncate(&dest);
+        assert(lz_decoder_init(&decoder));
+
+        for (int64_t i = 0; i < compressed.length; i += step) {
+            assert(!lz_decoder_done(&decoder));
+            assert(lz_decoder_write(&decoder, &dest, compressed.data + i,
+                                    compressed.length - i < step ? compressed.length - i : step));
+        }
+
+        assert(lz_decoder_done(&decoder));
+        assert(!lz_decoder_write(&decoder, &dest, data, 1));
+        assert(lz_decoder_cleanup(&decoder));
+        assert(sizeof(data) == dest.length);
+        assert(0 == memcmp(data, dest.data, dest.length));
+    }
+
+    // damaged frames fail and leave the destination unchanged
+    buffer_truncate(&dest);
+    assert(buffer_append_str(&dest, "x"));
+
+    for (int64_t i = 0; i < compressed.length; i += 997) {
+        compressed.data[i] ^= 0x01;
+        assert(!lz_frame_decompress_buffer(&dest, &compressed));
+        assert(1 == dest.length);
+        compressed.data[i] ^= 0x01;
+    }
+
+    assert(!lz_frame_decompress(&dest, compressed.data, compressed.length - 1));
+    assert(!lz_frame_decompress(&dest, (unsigned char*) "CBLZ\x02\x00\x10\x00\x00\x00\x00\x00",
+                                12));
+    assert(1 == dest.length);
+
+    assert(buffer_cleanup(&compressed));
+    assert(buffer_cleanup(&dest));
+}
@@ -17,11 +17,119 @@
 
 #include "codebox/string.h"
 
+// -------------------------------------------------------------------------------------------------
+// STATIC FUNCTIONS
+// -------------------------------------------------------------------------------------------------
+
+static int32_t __test_string_indexof (unsigned char* data, int32_t data_length, int32_t start,
+                                      unsigned char* sequence, int32_t sequence_length) {
+    for (int32_t i = start; i + sequence_length <= data_length; i++) {
+        if (0 == memcmp(data + i, sequence, sequence_length)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
 // -------------------------------------------------------------------------------------------------
 // FUNCTIONS
 // -------------------------------------------------------------------------------------------------
 
 void test_string () {
+    unsigned char data[1024];
+    unsigned char sequence[80];
+    SearchPattern pattern;
+
+    // overlapping partial matches
+    assert(1 == str_indexof("aaab", 0, "aab"));
+    assert(3 == str_indexof("abcabcabd", 0, "abcabd"));
+    assert(-1 == str_indexof("aaab", 2, "aab"));
+    assert(-1 == str_indexof("ab", 0, "abc"));
+
+    // compare every sequence length and position over data with a small alphabet, which covers
+    // the vector filters, their tails and the two-way search of periodic sequences
+    srand(1);
+
+    for (int32_t i = 0; i < sizeof(data); i++) {
+        data[i] = 'a' + rand() % 3;
+    }
+
+    for (int32_t length = 1; length <= sizeof(sequence); length++) {
+        for (int32_t trial = 0; trial < 20; trial++) {
+            int32_t start = rand() % (sizeof(data) - length);
+
+            if (trial % 2) {
+                memcpy(sequence, data + start, length);
+            } else {
+                for (int32_t i = 0; i < length; i++) {
+                    sequence[i] = 'a' + rand() % 3;
+                }
+            }
+
+            int32_t found = __test_string_indexof(data, sizeof(data), start / 2, sequence, length);
+
+            search_pattern_init(&pattern, sequence, length);
+
+            assert(found == chr_indexof(data, sizeof(data), start / 2, sequence, length));
+            assert(found == chr_indexof_pattern(data, sizeof(data), start / 2, &pattern));
+        }
+    }
+
+    memset(data, 'a', sizeof(data));
+    memset(sequence, 'a', sizeof(sequence));
+
+    sequence[sizeof(sequence) - 1] = 'b';
+    data[sizeof(data) - 1]         = 'b';
+
+    assert(sizeof(data) - sizeof(sequence) ==
+           chr_indexof(data, sizeof(data), 0, sequence, sizeof(sequence)));
+    assert(sizeof(data) - 32 == chr_indexof(data, sizeof(data), 0, sequence + 48, 32));
+
+    // candidates that all pass the first and last byte filter
+    data[sizeof(data) - 1] = 'a';
+    data[900]              = 'b';
+    sequence[63]           = 'a';
+    sequence[31]           = 'b';
+
+    assert(869 == chr_indexof(data, sizeof(data), 0, sequence, 64));
+    assert(-1 == chr_indexof(data, sizeof(data), 870, sequence, 64));
+
+    search_pattern_init(&pattern, sequence, 64);
+    assert(869 == chr_indexof_pattern(data, sizeof(data), 0, &pattern));
+
+    // rare bytes are filtered on first
+    search_pattern_init_str(&pattern, "\r\n\r\n");
+    assert(2 == pattern.rare[0] && 3 == pattern.rare[1]);
+    search_pattern_init_str(&pattern, "--boundary=X7");
+    assert(1 == pattern.rare[0] && 10 == pattern.rare[1]);
+    assert(9 == chr_indexof_pattern((unsigned char*) "foo: bar\r--boundary=X7\r\n", 24, 0,
+                                    &pattern));
+
+    search_pattern_init_str(&pattern, "\r\n\r\n");
+
+    Token* t = chr_split_pattern((unsigned char*) "a\r\n\r\nb\r\n\r\n\r\n", 12, &pattern);
+
+    assert(3 == token_count(t));
+    assert(1 == t->length && 'a' == *t->data.cval);
+    assert(1 == t->next->length && 'b' == *t->next->data.cval);
+    assert(2 == t->next->next->length);
+    token_cleanup(t);
+
+    t = str_split("xaaabyaab", "aab");
+
+    assert(3 == token_count(t));
+    assert(0 == strncmp("xa", t->data.sval, t->length));
+    assert(0 == strncmp("y", t->next->data.sval, t->next->length));
+    assert(0 == t->next->next->length);
+    token_cleanup(t);
+
+    t = str_split_pattern("", &pattern);
+
+    assert(1 == token_count(t));
+    assert(0 == t->length);
+    token_cleanup(t);
+
     assert(6 == str_indexof("Hello, world", 0, " "));
     assert(2 == str_indexof("Hello, world", 0, "l"));
     assert(3 == str_indexof("Hello, world", 3, "l"));
@@ -29,7 +137,14 @@ void test_string () {
     assert(-1 == str_indexof("Hello, world", 0, "World"));
     assert(12 == str_indexof("Hello, world ", 7, " "));
 
-    Token* t = str_split("The | quick | brown | fox | jumped | over | the | lazy | dog | ", " | ");
+    search_pattern_init_str(&pattern, "world");
+
+    assert(7 == str_indexof_pattern("Hello, world", 0, &pattern));
+    assert(20 == str_indexof_pattern("Hello, world, hello world", 8, &pattern));
+    assert(-1 == str_indexof_pattern("Hello, World", 0, &pattern));
+    assert(-1 == str_indexof_pattern("", 0, &pattern));
+
+    t = str_split("The | quick | brown | fox | jumped | over | the | lazy | dog | ", " | ");
     Token* first = t;
 
     assert(NULL != t);